@@ -0,0 +1,115 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_args.h
+ * @brief          : In-place Tokenizer and Argument Parser for Typed Commands
+ ******************************************************************************
+ * @description
+ * Splits a typed command such as "blink green 37" into words and converts
+ * the arguments, without allocating or copying:
+ *
+ * - cmd_args_split() writes a NUL over the separator after each word and
+ *   keeps pointers into the line (the command pool buffer), so the words
+ *   are ordinary C strings
+ * - cmd_args_uint() converts a decimal word with range checking (no
+ *   strtoul: no locale, base prefixes, signs or errno)
+ * - cmd_args_keyword() maps a word to its index in a keyword list
+ *
+ * Each failure has its own status, and cmd_args_error_text() gives the
+ * message for it, so commands can print "Number out of range" plus their
+ * usage line instead of a bare "invalid".
+ *
+ * The module has no RTOS or HAL dependencies; tools/cmd_args_bench.c
+ * builds it on the host to measure the parse cost.
+ ******************************************************************************
+ */
+
+#ifndef __CMD_ARGS_H
+#define __CMD_ARGS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*============================================================================
+ * Configuration Constants
+ *===========================================================================*/
+
+/**
+ * @brief  Most words in one command (the command name included)
+ * @note   A line with more words is rejected with CMD_ARGS_ERR_COUNT
+ */
+#ifndef CMD_ARGS_MAX
+#define CMD_ARGS_MAX 5
+#endif
+
+/*============================================================================
+ * Type Definitions
+ *===========================================================================*/
+
+/** Parse results */
+typedef enum {
+    CMD_ARGS_OK = 0,            /**< Success */
+    CMD_ARGS_ERR_COUNT,         /**< Too many or too few words */
+    CMD_ARGS_ERR_NUMBER,        /**< Not a decimal number */
+    CMD_ARGS_ERR_RANGE,         /**< Number outside the allowed range */
+    CMD_ARGS_ERR_KEYWORD        /**< Word not in the keyword list */
+} cmd_args_status_t;
+
+/** Words of one command, pointing into the command line */
+typedef struct {
+    uint8_t argc;               /**< Number of words (0 for a blank line) */
+    char *argv[CMD_ARGS_MAX];   /**< argv[0] is the command name */
+} cmd_args_t;
+
+/*============================================================================
+ * Public Function Interfaces
+ *===========================================================================*/
+
+/**
+ * @brief  Split a command line into words, in place
+ * @param  line: NUL-terminated command (modified: separators become NUL)
+ * @param  args: [OUT] Words
+ * @retval CMD_ARGS_OK, or CMD_ARGS_ERR_COUNT for more than CMD_ARGS_MAX
+ *         words
+ *
+ * Words are separated by any number of spaces or tabs.
+ */
+cmd_args_status_t cmd_args_split(char *line, cmd_args_t *args);
+
+/**
+ * @brief  Convert a decimal word
+ * @param  word: Digits only (no sign, no leading or trailing spaces)
+ * @param  min: Smallest allowed value
+ * @param  max: Largest allowed value
+ * @param  value: [OUT] Result (only written on success)
+ * @retval CMD_ARGS_OK, CMD_ARGS_ERR_NUMBER or CMD_ARGS_ERR_RANGE (also
+ *         for values beyond 32 bits)
+ */
+cmd_args_status_t cmd_args_uint(const char *word, uint32_t min, uint32_t max, uint32_t *value);
+
+/**
+ * @brief  Look a word up in a keyword list
+ * @param  word: Word to find (exact, case-sensitive match)
+ * @param  keywords: Keyword list
+ * @param  count: Number of keywords
+ * @param  index: [OUT] Index of the keyword (only written on success)
+ * @retval CMD_ARGS_OK or CMD_ARGS_ERR_KEYWORD
+ */
+cmd_args_status_t cmd_args_keyword(const char *word, const char *const *keywords,
+                                   size_t count, size_t *index);
+
+/**
+ * @brief  Message for a parse result
+ * @param  status: Parse result
+ * @retval String literal, e.g. "Number out of range"
+ */
+const char *cmd_args_error_text(cmd_args_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMD_ARGS_H */
@@ -0,0 +1,160 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_frame.h
+ * @brief          : Binary Command Frames (COBS + CRC-16)
+ ******************************************************************************
+ * @description
+ * Compact request/response protocol for scripted clients, carried on the
+ * same USART2 link as the interactive menu.
+ *
+ * Wire Format:
+ * ┌──────┬───────────────────────────────────────────┬──────┐
+ * │ 0x00 │ COBS( payload | CRC-16 little-endian )    │ 0x00 │
+ * └──────┴───────────────────────────────────────────┴──────┘
+ * COBS removes every 0x00 from the encoded bytes, so 0x00 only ever
+ * appears as a delimiter. Typed input never contains NUL: a leading 0x00
+ * switches the receiver from text to frame mode, the next 0x00 ends the
+ * frame. Every frame carries both delimiters; extra delimiters (0x00 0x00)
+ * are ignored, which lets a client resynchronise at any time.
+ *
+ * CRC: CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over the payload.
+ *
+ * Payload:
+ *   Request:  OP | SEQ | args...
+ *   Response: OP | 0x80 | SEQ | STATUS | data...
+ * SEQ is chosen by the client and echoed back, so responses can be
+ * matched to requests. Multi-byte fields are little-endian (as in the
+ * binary log frames, print_log.h).
+ *
+ * Wire cost example (select LED pattern 2):
+ * - Menu:   "2\r" in, confirmation + full menu (~370 bytes) out
+ * - Frame:  8 bytes in, 8 bytes out
+ *
+ * The module has no RTOS or HAL dependencies; tools/cmd_frame_bench.c
+ * runs the same code on the host and tools/cmd_frame_client.py is the
+ * host-side implementation.
+ ******************************************************************************
+ */
+
+#ifndef __CMD_FRAME_H
+#define __CMD_FRAME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*============================================================================
+ * Configuration Constants
+ *===========================================================================*/
+
+/** Frame delimiter (never present inside a COBS-encoded frame) */
+#define CMD_FRAME_DELIMITER 0x00
+
+/** Protocol version reported by CMD_OP_PING */
+#define CMD_FRAME_VERSION 1
+
+/**
+ * @brief  Largest payload (opcode, sequence and arguments/data, no CRC)
+ * @note   A decoded request travels through command_queue in one
+ *         COMMAND_MAX_LENGTH slot together with a 2-byte header.
+ */
+#define CMD_FRAME_MAX_PAYLOAD 28
+
+/** CRC size on the wire */
+#define CMD_FRAME_CRC_SIZE 2
+
+/** Largest COBS-encoded frame between the delimiters (one overhead byte
+ *  per 254 data bytes) */
+#define CMD_FRAME_MAX_ENCODED (CMD_FRAME_MAX_PAYLOAD + CMD_FRAME_CRC_SIZE + 1)
+
+/** Largest frame on the wire, delimiters included */
+#define CMD_FRAME_MAX_WIRE (CMD_FRAME_MAX_ENCODED + 2)
+
+/** Response opcode flag */
+#define CMD_FRAME_RESPONSE 0x80
+
+/*============================================================================
+ * Type Definitions
+ *===========================================================================*/
+
+/** Request opcodes */
+typedef enum {
+    CMD_OP_PING = 0x01,         /**< No args; data: protocol version (u8),
+                                     pipeline window (u8) */
+    CMD_OP_SET_PATTERN = 0x02,  /**< Args: pattern (u8, 0 = off, 1-3) */
+    CMD_OP_GET_STATUS = 0x03,   /**< No args; data: pattern (u8), menu (u8) */
+    CMD_OP_GET_RX_STATS = 0x04  /**< No args; data: rx_bytes, rx_dropped,
+                                     commands, frame_errors (u32 each) */
+} cmd_frame_op_t;
+
+/** Decode results, also sent as the response STATUS byte */
+typedef enum {
+    CMD_FRAME_OK = 0,           /**< Success */
+    CMD_FRAME_ERR_COBS,         /**< Malformed COBS encoding */
+    CMD_FRAME_ERR_LENGTH,       /**< Too short or too long */
+    CMD_FRAME_ERR_CRC,          /**< CRC mismatch */
+    CMD_FRAME_ERR_OPCODE,       /**< Unknown opcode */
+    CMD_FRAME_ERR_ARG           /**< Bad argument count or value */
+} cmd_frame_status_t;
+
+/*============================================================================
+ * Public Function Interfaces
+ *===========================================================================*/
+
+/**
+ * @brief  CRC-16/CCITT-FALSE
+ * @param  data: Bytes to check
+ * @param  length: Number of bytes
+ * @retval CRC (0x29B1 for "123456789")
+ */
+uint16_t cmd_frame_crc16(const uint8_t *data, size_t length);
+
+/**
+ * @brief  COBS-encode a block
+ * @param  src: Bytes to encode (may contain 0x00)
+ * @param  length: Number of bytes
+ * @param  dst: Output (must not overlap src)
+ * @param  capacity: Size of dst
+ * @retval Encoded length (no 0x00 inside), or 0 if it does not fit
+ */
+size_t cmd_frame_cobs_encode(const uint8_t *src, size_t length, uint8_t *dst, size_t capacity);
+
+/**
+ * @brief  Decode a COBS block (delimiters already stripped)
+ * @param  src: Encoded bytes
+ * @param  length: Number of bytes
+ * @param  dst: Output (must not overlap src)
+ * @param  capacity: Size of dst
+ * @retval Decoded length, or 0 if malformed or too long
+ */
+size_t cmd_frame_cobs_decode(const uint8_t *src, size_t length, uint8_t *dst, size_t capacity);
+
+/**
+ * @brief  Build a complete wire frame
+ * @param  payload: Payload (CMD_FRAME_MAX_PAYLOAD bytes at most)
+ * @param  length: Payload length
+ * @param  dst: Output, CMD_FRAME_MAX_WIRE bytes are always enough
+ * @param  capacity: Size of dst
+ * @retval Frame length including both delimiters, or 0 if it does not fit
+ */
+size_t cmd_frame_encode(const uint8_t *payload, size_t length, uint8_t *dst, size_t capacity);
+
+/**
+ * @brief  Decode and check a received frame
+ * @param  encoded: Bytes between the delimiters
+ * @param  length: Number of bytes
+ * @param  payload: [OUT] Payload without CRC (CMD_FRAME_MAX_PAYLOAD bytes)
+ * @param  payload_length: [OUT] Payload length
+ * @retval CMD_FRAME_OK, or CMD_FRAME_ERR_COBS/_LENGTH/_CRC
+ */
+cmd_frame_status_t cmd_frame_decode(const uint8_t *encoded, size_t length,
+                                    uint8_t *payload, size_t *payload_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMD_FRAME_H */
@@ -0,0 +1,170 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_macro.h
+ * @brief          : Recorded Command Macros (Named Step Lists in RAM)
+ ******************************************************************************
+ * @description
+ * Stores named sequences of typed commands for on-board replay
+ * ("macro record <name>" ... "macro end", "macro run <name>").
+ *
+ * Storage is one byte arena shared by all macros. Each step is kept as
+ * its command text plus a NUL, so a 9-byte "pattern 2" step costs 10
+ * bytes instead of a COMMAND_MAX_LENGTH line buffer. A macro is a slot
+ * with its name and the offset, length and step count of its text.
+ * Deleting (or re-recording) a macro moves the macros behind it down,
+ * so free space is always one block at the end of the arena, and the
+ * macro being recorded is always the last one.
+ *
+ * The module only stores and walks the steps; command_handler.c runs
+ * them. It has no RTOS or HAL dependencies; tools/cmd_macro_sim.c builds
+ * it on the host.
+ ******************************************************************************
+ */
+
+#ifndef __CMD_MACRO_H
+#define __CMD_MACRO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*============================================================================
+ * Configuration Constants
+ *===========================================================================*/
+
+/**
+ * @brief  Number of macros that can exist at the same time
+ */
+#ifndef CMD_MACRO_SLOTS
+#define CMD_MACRO_SLOTS 4
+#endif
+
+/**
+ * @brief  Bytes of command text shared by all macros
+ * @note   Each step takes its length plus one
+ */
+#ifndef CMD_MACRO_STORAGE
+#define CMD_MACRO_STORAGE 512
+#endif
+
+/** Longest macro name (letters, digits, '_' and '-') */
+#define CMD_MACRO_NAME_MAX 8
+
+#if CMD_MACRO_STORAGE > 65535
+#error "Macro offsets are 16-bit"
+#endif
+
+/*============================================================================
+ * Type Definitions
+ *===========================================================================*/
+
+/** Results */
+typedef enum {
+    CMD_MACRO_OK = 0,           /**< Success */
+    CMD_MACRO_ERR_NAME,         /**< Name empty, too long or bad character */
+    CMD_MACRO_ERR_SLOTS,        /**< All CMD_MACRO_SLOTS in use */
+    CMD_MACRO_ERR_FULL,         /**< Storage full */
+    CMD_MACRO_ERR_UNKNOWN,      /**< No macro with this name */
+    CMD_MACRO_ERR_EMPTY,        /**< Recording ended without steps */
+    CMD_MACRO_ERR_RECORDING,    /**< Already recording */
+    CMD_MACRO_ERR_IDLE          /**< Not recording */
+} cmd_macro_status_t;
+
+/** One macro */
+typedef struct {
+    char name[CMD_MACRO_NAME_MAX + 1];  /**< "" = free slot */
+    uint16_t offset;            /**< First byte in storage */
+    uint16_t length;            /**< Bytes of step text, NULs included */
+    uint16_t steps;             /**< Number of steps */
+} cmd_macro_slot_t;
+
+/** All macros */
+typedef struct {
+    char storage[CMD_MACRO_STORAGE];
+    uint16_t used;              /**< Bytes in use (from the start) */
+    int8_t recording;           /**< Slot being recorded, -1 = none */
+    cmd_macro_slot_t slots[CMD_MACRO_SLOTS];
+} cmd_macro_store_t;
+
+/*============================================================================
+ * Public Function Interfaces
+ *===========================================================================*/
+
+/**
+ * @brief  Empty the store
+ * @param  store: Store
+ */
+void cmd_macro_init(cmd_macro_store_t *store);
+
+/**
+ * @brief  Start recording a macro
+ * @param  store: Store
+ * @param  name: Macro name; an existing macro of that name is replaced
+ * @retval CMD_MACRO_OK, CMD_MACRO_ERR_NAME, _SLOTS or _RECORDING
+ */
+cmd_macro_status_t cmd_macro_record(cmd_macro_store_t *store, const char *name);
+
+/**
+ * @brief  Add a step to the macro being recorded
+ * @param  store: Store
+ * @param  step: Command text (copied)
+ * @retval CMD_MACRO_OK, CMD_MACRO_ERR_FULL (the step is not added, the
+ *         recording stays open) or _IDLE
+ */
+cmd_macro_status_t cmd_macro_append(cmd_macro_store_t *store, const char *step);
+
+/**
+ * @brief  Finish recording
+ * @param  store: Store
+ * @retval CMD_MACRO_OK, CMD_MACRO_ERR_EMPTY (nothing recorded: the macro
+ *         is dropped) or _IDLE
+ */
+cmd_macro_status_t cmd_macro_end(cmd_macro_store_t *store);
+
+/**
+ * @brief  Name of the macro being recorded
+ * @param  store: Store
+ * @retval Name, or NULL if not recording
+ */
+const char *cmd_macro_recording(const cmd_macro_store_t *store);
+
+/**
+ * @brief  Find a macro
+ * @param  store: Store
+ * @param  name: Macro name
+ * @retval Slot index, or -1 (also for the macro still being recorded)
+ */
+int cmd_macro_find(const cmd_macro_store_t *store, const char *name);
+
+/**
+ * @brief  Delete a macro and close the gap it leaves
+ * @param  store: Store
+ * @param  name: Macro name
+ * @retval CMD_MACRO_OK or CMD_MACRO_ERR_UNKNOWN
+ */
+cmd_macro_status_t cmd_macro_delete(cmd_macro_store_t *store, const char *name);
+
+/**
+ * @brief  Walk the steps of a macro
+ * @param  store: Store
+ * @param  slot: Slot index from cmd_macro_find()
+ * @param  step: Previous step, or NULL for the first
+ * @retval Next step (NUL-terminated), or NULL after the last
+ */
+const char *cmd_macro_next(const cmd_macro_store_t *store, int slot, const char *step);
+
+/**
+ * @brief  Message for a result
+ * @param  status: Result
+ * @retval String literal, e.g. "Macro storage full"
+ */
+const char *cmd_macro_error_text(cmd_macro_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMD_MACRO_H */
@@ -0,0 +1,88 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_pool.h
+ * @brief          : Command Line Buffer Pool (index bookkeeping)
+ ******************************************************************************
+ * @description
+ * Keeps track of a fixed pool of line buffers that go round in order:
+ * the producer (UART task) fills one buffer, hands its index to the
+ * consumer (command handler) and moves on to the next; the consumer
+ * returns buffers in the order it received them.
+ *
+ *   submitted ──> next buffer to fill is submitted % size
+ *   released  ──> oldest buffer still out is released % size
+ *
+ * Two free-running counters are all the state: the producer only writes
+ * `submitted`, the consumer only writes `released`, so neither needs a
+ * lock. In use = submitted - released (unsigned wrap is harmless).
+ *
+ * The module has no RTOS or HAL dependencies and owns no buffers; the
+ * caller keeps the storage and asserts on the checks. tools/uart_rx_sim.c
+ * drives the same code on the host.
+ ******************************************************************************
+ */
+
+#ifndef __CMD_POOL_H
+#define __CMD_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*============================================================================
+ * Type Definitions
+ *===========================================================================*/
+
+/** Pool bookkeeping (one per pool) */
+typedef struct {
+    uint8_t size;                   /**< Buffers in the pool */
+    uint32_t submitted;             /**< Producer: buffers handed over so far */
+    volatile uint32_t released;     /**< Consumer: buffers returned so far */
+    uint32_t peak;                  /**< Most buffers out at once */
+} cmd_pool_t;
+
+/** Static initialiser for a pool of the given number of buffers */
+#define CMD_POOL_INIT(buffers) { (uint8_t)(buffers), 0, 0, 0 }
+
+/*============================================================================
+ * Public Function Interfaces
+ *===========================================================================*/
+
+/**
+ * @brief  Index of the buffer the producer fills next
+ * @param  pool: Pool state
+ * @retval Buffer index (0 .. size - 1)
+ */
+uint8_t cmd_pool_fill_index(const cmd_pool_t *pool);
+
+/**
+ * @brief  Buffers handed over and not yet returned
+ * @param  pool: Pool state
+ * @retval Buffers in use (the one being filled not counted)
+ */
+uint32_t cmd_pool_in_use(const cmd_pool_t *pool);
+
+/**
+ * @brief  Hand the buffer being filled to the consumer (producer side)
+ * @param  pool: Pool state
+ * @retval 1 if the next buffer to fill is free, 0 if the pool is overcommitted
+ *
+ * Call once the buffer's index has been queued. The peak is updated.
+ */
+int cmd_pool_submit(cmd_pool_t *pool);
+
+/**
+ * @brief  Return a buffer after use (consumer side)
+ * @param  pool: Pool state
+ * @param  index: Buffer index received from the producer
+ * @retval 1 if returned, 0 if it is not the oldest buffer out (not counted)
+ */
+int cmd_pool_release(cmd_pool_t *pool, uint8_t index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMD_POOL_H */
@@ -11,7 +11,7 @@
  * Menu Structure:
  * ┌─────────────┐
  * │  Main Menu  │  (1: LED Patterns, 2: Exit)
- * └─────────────┘
+ * └─────────────┘  (3: Toggle VT100 screen mode)
  *        │
  *        ├─ Option 1 ──> ┌────────────────────┐
  *        │                │ LED Patterns Menu  │
@@ -25,12 +25,44 @@
  *        └─ Option 2 ──> Stop LEDs & stay in main menu
  *
  * Command Processing Flow:
- * 1. UART task receives complete command → sends to queue
- * 2. UART task notifies command handler task
- * 3. Command handler wakes up and processes command
+ * 1. UART task assembles a command in a command pool buffer
+ * 2. UART task queues the buffer's index (the queue wakes the handler)
+ * 3. Command handler processes the command in place, then returns the
+ *    buffer
  * 4. Handler executes action based on current menu state
  * 5. Handler prints response and appropriate menu
  *
+ * Commands accepted in every menu:
+ * - "rxstats": receive counters and RX timing histograms (uart_task.h)
+ * - "baud [<rate>]": show or switch the USART2 rate (confirm with "ok")
+ * - "machine" / "interactive": session mode for scripted clients - no
+ *   echo, menus or banners, one "ok"/"invalid" line per command (also
+ *   switched by the SO/SI bytes, see uart_task.h)
+ * - "pattern <0-3>": LED pattern by number (0 = off, as CMD_OP_SET_PATTERN)
+ * - "status": current pattern and menu (as CMD_OP_GET_STATUS)
+ * - "blink <green|orange> <period_ms>", "duty <green|orange> <percent>":
+ *   one LED's toggle period (10-10000 ms) and ON share (0-100 %), see
+ *   led_effects.h. Argument errors print the command's usage
+ *
+ * Batches:
+ * - "<command>;<command>;..." runs several commands from one line and
+ *   answers once; "!<command>;..." also applies all LED changes in one
+ *   step, or none if a command is invalid
+ *
+ * Macros (cmd_macro.h):
+ * - "macro record <name>" stores the following lines instead of running
+ *   them, until "macro end"; "macro run <name> [repeat <n>]" replays them
+ *   on the board, "macro list" and "macro delete <name>" manage them
+ * - "delay <ms>" waits; in a macro the delays add up from the start of
+ *   the replay, so step timing does not drift with execution time
+ *
+ * Sequenced Commands (pipelining):
+ * - "@<seq> <command>" runs <command> in the current menu without printing
+ *   menus or confirmations, then answers "ack <seq> ok" or
+ *   "ack <seq> invalid". seq is 0-65535, chosen by the client
+ * - A client may send up to COMMAND_PIPELINE_WINDOW commands before the
+ *   first ack arrives; acks come back in command order
+ *
  * State Management:
  * - States: MENU_MAIN, MENU_LED_PATTERNS
  * - State transitions controlled by user commands
@@ -38,7 +70,7 @@
  *
  * Thread Safety:
  * - Menu state only accessed by command handler task (no protection needed)
- * - All UART transmissions protected by uart_mutex
+ * - All output queued to the print task (print_task.h), no UART lock
  ******************************************************************************
  */
 
@@ -52,6 +84,47 @@ extern "C" {
 #include "main.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#include "menu_table.h"
+
+/*============================================================================
+ * Configuration Constants
+ *===========================================================================*/
+
+/**
+ * @brief  Screen mode after reset
+ * @note   0 = plain (menus reprinted in full, works on any terminal),
+ *         1 = VT100 (LED menu drawn once, then only the changed fields are
+ *         rewritten with cursor-addressing sequences). Toggled at runtime
+ *         with main menu option 3.
+ */
+#ifndef COMMAND_VT100_DEFAULT
+#define COMMAND_VT100_DEFAULT 0
+#endif
+
+/** Prefix of a sequenced command ("@<seq> <command>") */
+#define COMMAND_SEQ_PREFIX '@'
+
+/** Separates the commands of a batch ("1;2;pattern 3") */
+#define COMMAND_BATCH_SEPARATOR ';'
+
+/** Prefix of an atomic batch ("!pattern 2;blink green 37") */
+#define COMMAND_ATOMIC_PREFIX '!'
+
+/**
+ * @brief  Sequenced commands a client may have in flight (sent, not acked)
+ * @note   Must not exceed COMMAND_QUEUE_DEPTH (uart_task.h): a full window
+ *         then always fits in the command queue and the UART task never
+ *         blocks on it. Reported to binary clients by CMD_OP_PING.
+ */
+#ifndef COMMAND_PIPELINE_WINDOW
+#define COMMAND_PIPELINE_WINDOW 4
+#endif
+
+/** Most passes of one "macro run <name> repeat <n>" */
+#define COMMAND_MACRO_MAX_REPEAT 1000
+
+/** Longest "delay <ms>" */
+#define COMMAND_DELAY_MAX_MS 60000
 
 /*============================================================================
  * Type Definitions
@@ -67,6 +140,7 @@ extern "C" {
  *   Options:
  *     1 - LED Patterns (transition to MENU_LED_PATTERNS)
  *     2 - Exit Application (stop all LEDs, stay in MENU_MAIN)
+ *     3 - Toggle VT100 screen mode (stay in MENU_MAIN)
  *
  * MENU_LED_PATTERNS:
  *   Submenu for LED pattern selection
@@ -78,12 +152,23 @@ extern "C" {
  *     4 - All LEDs OFF (pattern stopped)
  *
  * State transitions are triggered by user commands and controlled by
- * process_command() function.
+ * process_command() function. The states, options and menu text are
+ * generated from MENU_TREE (menu_table.h).
  */
+#define MENU_STATE_ENUM(state, title, options) state,
 typedef enum {
-    MENU_MAIN = 0,          /**< Main menu state */
-    MENU_LED_PATTERNS       /**< LED patterns submenu state */
+    MENU_TREE(MENU_STATE_ENUM)
+    MENU_STATE_COUNT        /**< Number of menus */
 } MenuState_t;
+#undef MENU_STATE_ENUM
+
+/**
+ * @brief  Result of a typed command (reported in sequenced acks)
+ */
+typedef enum {
+    COMMAND_OK = 0,         /**< Command executed */
+    COMMAND_INVALID         /**< Unknown option in the current menu */
+} command_status_t;
 
 /*============================================================================
  * Public Function Interfaces
@@ -95,32 +180,32 @@ typedef enum {
  * @retval None (task never returns)
  *
  * Task Behavior:
- * 1. Waits for task notification from UART task (blocks when idle)
- * 2. When notified, receives all pending commands from queue
- * 3. Processes each command using process_command()
- * 4. Returns to waiting state when queue empty
+ * 1. Blocks on command_queue (2 s timeout for the watchdog)
+ * 2. Receives a command pool index and processes the command in its
+ *    line buffer using process_command() (or process_frame())
+ * 3. Returns the buffer with command_buffer_release()
  *
  * Synchronization:
- * - Woken by ulTaskNotifyTake() when UART task sends command
- * - Receives commands from command_queue (non-blocking receive)
- * - Uses uart_mutex for all UART transmissions
+ * - Woken by the queue itself when UART task sends a command (one
+ *   kernel primitive per command, no separate task notification)
+ * - All UART transmissions go through the print task
  *
  * Priority: 2 (same as UART task for balanced scheduling)
  * Stack: 256 words (sufficient for menu printing)
- *
- * @note Task handle stored in uart_task.c for notification from UART task
  */
 void command_handler_task(void *parameters);
 
 /**
  * @brief  Process a command based on current menu state
  * @param  command: Null-terminated command string to process
- * @retval None
+ * @retval COMMAND_OK or COMMAND_INVALID
  *
  * Command Processing Steps:
  * 1. Trim leading/trailing whitespace
  * 2. Convert to lowercase for case-insensitive matching
  * 3. Dispatch to appropriate handler based on current_menu_state
+ *    (a "@<seq> " prefix suppresses steps 5-6 and prints an ack instead;
+ *    a batch line dispatches each of its commands, then answers once)
  * 4. Execute action (LED pattern change, menu transition, etc.)
  * 5. Print response message
  * 6. Redisplay appropriate menu
@@ -130,10 +215,10 @@ void command_handler_task(void *parameters);
  * - Menu state remains unchanged on invalid input
  * - Buffer overflow already handled by UART task
  *
- * @note All UART transmissions are mutex-protected
+ * @note All output goes through the print task
  * @note Function is called only from command_handler_task
  */
-void process_command(char *command);
+command_status_t process_command(char *command);
 
 /**
  * @brief  Get current menu state
@@ -31,6 +31,17 @@
  * │ 3        │ Sync Blink     │ Both: 100ms (synchronized)      │
  * └──────────┴────────────────┴─────────────────────────────────┘
  *
+ * Per-LED Control (blink/duty commands):
+ * - led_effects_blink(): toggle period of one LED (the patterns' "100ms")
+ * - led_effects_duty(): share of each blink cycle the LED is ON (0-100 %)
+ * - A pattern change resets both LEDs to the pattern's settings
+ *
+ * Batches (atomic command lines):
+ * - led_effects_batch_begin() ... _commit(): pattern, blink and duty
+ *   changes in between only update a staged copy; the commit applies
+ *   them together, both pins in one register write, so the LEDs never
+ *   show an intermediate state. _abort() drops the staged changes
+ *
  * Thread Safety:
  * - Timer callbacks run in Timer Service Task (configTIMER_TASK_PRIORITY)
  * - HAL_GPIO_TogglePin() is atomic and ISR-safe
@@ -49,10 +60,35 @@ extern "C" {
 #include "FreeRTOS.h"
 #include "timers.h"
 
+/*============================================================================
+ * Configuration Constants
+ *===========================================================================*/
+
+/**
+ * @brief  Shortest and longest toggle period for led_effects_blink() (ms)
+ * @note   Every phase change of an uneven duty cycle is a timer command,
+ *         so very short periods load the timer service task
+ */
+#ifndef LED_BLINK_MIN_MS
+#define LED_BLINK_MIN_MS 10
+#endif
+#ifndef LED_BLINK_MAX_MS
+#define LED_BLINK_MAX_MS 10000
+#endif
+
 /*============================================================================
  * Type Definitions
  *===========================================================================*/
 
+/**
+ * @brief  LEDs with a blink timer
+ */
+typedef enum {
+    LED_ID_GREEN = 0,       /**< LD4 (PD12), led_timer1 */
+    LED_ID_ORANGE,          /**< LD3 (PD13), led_timer2 */
+    LED_ID_COUNT
+} led_id_t;
+
 /**
  * @brief  LED pattern enumeration
  *
@@ -151,6 +187,56 @@ void led_effects_init(void);
  */
 void led_effects_set_pattern(LED_Pattern_t pattern);
 
+/**
+ * @brief  Blink one LED with a new toggle period
+ * @param  led: LED
+ * @param  period_ms: Toggle period, LED_BLINK_MIN_MS ... LED_BLINK_MAX_MS
+ *         (a full ON/OFF cycle is two periods)
+ * @retval None
+ *
+ * Keeps the LED's duty cycle; an LED that was steadily ON or OFF starts
+ * blinking at 50 %. The other LED is not touched.
+ */
+void led_effects_blink(led_id_t led, uint32_t period_ms);
+
+/**
+ * @brief  Set the share of each blink cycle one LED is ON
+ * @param  led: LED
+ * @param  percent: 0 (steady OFF) ... 100 (steady ON)
+ * @retval None
+ *
+ * The cycle length (two toggle periods) is kept. At 50 % the timer
+ * auto-reloads; otherwise each callback sets the length of the next phase.
+ */
+void led_effects_duty(led_id_t led, uint8_t percent);
+
+/**
+ * @brief  Start collecting LED changes instead of applying them
+ * @retval None
+ *
+ * The staged copy starts from the running settings, so later changes in
+ * the batch build on earlier ones. Batches do not nest.
+ */
+void led_effects_batch_begin(void);
+
+/**
+ * @brief  Apply all changes since led_effects_batch_begin() at once
+ * @retval None
+ *
+ * Both LEDs are restarted from the staged settings; their pins change
+ * with a single GPIOD->BSRR write.
+ */
+void led_effects_batch_commit(void);
+
+/**
+ * @brief  Drop the changes since led_effects_batch_begin()
+ * @retval None
+ *
+ * The LEDs and the current pattern never left their running state (the
+ * pattern is staged with the settings), so nothing is undone.
+ */
+void led_effects_batch_abort(void);
+
 /**
  * @brief  Timer 1 callback - Controls Green LED (LD4/PD12)
  * @param  xTimer: Timer handle (unused, required by FreeRTOS API)
@@ -163,7 +249,8 @@ void led_effects_set_pattern(LED_Pattern_t pattern);
  *
  * Behavior:
  * - Toggles Green LED state (ON → OFF or OFF → ON)
- * - Called periodically based on timer period (100ms or 1000ms)
+ * - Called periodically based on timer period (100ms or 1000ms, or the
+ *   next phase length for an uneven duty cycle)
  * - Auto-reload timer: executes indefinitely until stopped
  *
  * @note HAL_GPIO_TogglePin() is atomic and ISR-safe
@@ -183,7 +270,8 @@ void led_timer1_callback(TimerHandle_t xTimer);
  *
  * Behavior:
  * - Toggles Orange LED state (ON → OFF or OFF → ON)
- * - Called periodically based on timer period (100ms or 1000ms)
+ * - Called periodically based on timer period (100ms or 1000ms, or the
+ *   next phase length for an uneven duty cycle)
  * - Auto-reload timer: executes indefinitely until stopped
  *
  * @note HAL_GPIO_TogglePin() is atomic and ISR-safe
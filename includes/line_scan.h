@@ -0,0 +1,66 @@
+/**
+ ******************************************************************************
+ * @file           : line_scan.h
+ * @brief          : Word-at-a-time Scanner for Terminal Control Characters
+ ******************************************************************************
+ * @description
+ * Finds the next byte in a received block that needs special handling by
+ * the line editor: CR, LF, backspace (0x08), DEL (0x7F), NUL (which
+ * opens a binary command frame, see cmd_frame.h) or SO/SI (0x0E/0x0F,
+ * session mode escapes). Everything before it is ordinary text that can
+ * be copied and echoed as one run.
+ *
+ * The scan tests four bytes per step (SWAR - SIMD within a register)
+ * instead of comparing each byte against seven characters, so a pasted
+ * script is split into runs with ~4× fewer loop iterations.
+ *
+ * The module has no RTOS or HAL dependencies; tools/line_scan_bench.c
+ * builds it on the host to measure throughput.
+ ******************************************************************************
+ */
+
+#ifndef __LINE_SCAN_H
+#define __LINE_SCAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief  Check whether a byte needs line-editor handling
+ * @param  c: Received byte
+ * @retval Non-zero for CR, LF, backspace, DEL, NUL, SO or SI
+ */
+static inline int line_scan_is_special(uint8_t c)
+{
+    return c == '\r' || c == '\n' || c == '\b' || c == 0x7F || c == 0x00 ||
+           c == 0x0E || c == 0x0F;
+}
+
+/**
+ * @brief  Find the first CR, LF, backspace, DEL, NUL, SO or SI in a block
+ * @param  data: Received bytes
+ * @param  length: Number of bytes
+ * @retval Index of the first special byte, or length if there is none
+ *         (i.e. the length of the leading run of ordinary text)
+ */
+size_t line_scan_special(const uint8_t *data, size_t length);
+
+/**
+ * @brief  Byte-at-a-time reference version of line_scan_special()
+ * @param  data: Received bytes
+ * @param  length: Number of bytes
+ * @retval Same result as line_scan_special()
+ *
+ * Kept as the baseline for the host benchmark.
+ */
+size_t line_scan_special_bytewise(const uint8_t *data, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LINE_SCAN_H */
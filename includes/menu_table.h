@@ -0,0 +1,111 @@
+/**
+ ******************************************************************************
+ * @file           : menu_table.h
+ * @brief          : Declarative Menu Tree (X-Macro Table)
+ ******************************************************************************
+ * @description
+ * Every menu, its options, their handlers and the text printed for them
+ * come from the lists below. Each user expands a list with its own
+ * macros (X-macros), so nothing is written twice:
+ *
+ * - command_handler.h: the MenuState_t enumeration
+ * - command_handler.c: option tables indexed by the option digit (O(1)
+ *   dispatch, no strcmp chain), VT100 rows and the handler prototypes
+ * - MENU_PLAIN_TEXT() / MENU_VT100_TEXT(): the rendered menus, built by
+ *   string literal concatenation, so each menu is one constant in flash
+ * - tools/menu_dispatch_bench.c: the host benchmark of the dispatch
+ *
+ * Option lists take two callbacks, one per kind of entry:
+ *
+ *   OPTION(key, label, handler)
+ *       key:     option digit 0-9 (a bare token, not '1')
+ *       label:   text shown in the menu
+ *       handler: command_handler.c function run for the option
+ *
+ *   PATTERN(key, label, pattern, message, status)
+ *       Selects an LED pattern (led_effects.h)
+ *       message: confirmation line in plain screen mode
+ *       status:  status field in VT100 mode (max 10 characters)
+ *
+ * Options are shown in list order. Adding an LED pattern to the menu is
+ * one PATTERN line (plus the pattern itself in led_effects.c).
+ *
+ * The header has no dependencies, so host tools can expand the lists.
+ ******************************************************************************
+ */
+
+#ifndef __MENU_TABLE_H
+#define __MENU_TABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Menu Tree
+ *===========================================================================*/
+
+/**
+ * @brief  All menus: X(state, title, options)
+ * @note   state becomes a MenuState_t value (the first one is entered at
+ *         reset); title is centred by hand in the 40-column frame
+ */
+#define MENU_TREE(X) \
+    X(MENU_MAIN,         MENU_MAIN_TITLE, MENU_MAIN_OPTIONS) \
+    X(MENU_LED_PATTERNS, MENU_LED_TITLE,  MENU_LED_OPTIONS)
+
+#define MENU_MAIN_TITLE "              MAIN MENU"
+#define MENU_LED_TITLE  "        LED Pattern Selection"
+
+/** Main menu options */
+#define MENU_MAIN_OPTIONS(OPTION, PATTERN) \
+    OPTION(1, "LED Patterns",             menu_enter_led_patterns) \
+    OPTION(2, "Exit Application",         menu_exit_application) \
+    OPTION(3, "Toggle VT100 screen mode", menu_toggle_vt100)
+
+/** LED pattern menu options */
+#define MENU_LED_OPTIONS(OPTION, PATTERN) \
+    OPTION(0,  "Return to main menu",          menu_return_main) \
+    PATTERN(1, "All LEDs ON",                  LED_PATTERN_1,    "Now playing LED Pattern 1", "ON") \
+    PATTERN(2, "Different Frequency Blinking", LED_PATTERN_2,    "Now playing LED Pattern 2", "BLINK DIFF") \
+    PATTERN(3, "Same Frequency Blinking",      LED_PATTERN_3,    "Now playing LED Pattern 3", "BLINK SAME") \
+    PATTERN(4, "All LEDs OFF",                 LED_PATTERN_NONE, "All LEDs turned OFF",       "OFF")
+
+/** Option digits are 0-9: tables indexed by the digit have this many slots */
+#define MENU_MAX_OPTIONS 10
+
+/*============================================================================
+ * Rendering
+ *===========================================================================*/
+
+#define MENU_RULE "========================================\r\n"
+
+/* One "  <key> - <label>" line per entry */
+#define MENU_LINE_OPTION(key, label, handler)                     "  " #key " - " label "\r\n"
+#define MENU_LINE_PATTERN(key, label, pattern, message, status)   "  " #key " - " label "\r\n"
+
+/* Frame, title and options, shared by both screen modes */
+#define MENU_BODY(title, options) \
+    MENU_RULE title "\r\n" MENU_RULE \
+    options(MENU_LINE_OPTION, MENU_LINE_PATTERN) \
+    MENU_RULE
+
+/**
+ * @brief  Menu as printed in plain screen mode (one string literal)
+ */
+#define MENU_PLAIN_TEXT(title, options) \
+    "\r\n" MENU_BODY(title, options) "Enter selection: "
+
+/**
+ * @brief  Menu as drawn in VT100 mode: cleared screen, frame at the top,
+ *         a status line, and the prompt position saved with ESC 7
+ * @note   Options start on screen row 4 (rows are 1-based)
+ */
+#define MENU_VT100_TEXT(title, options) \
+    "\x1b[2J\x1b[H" MENU_BODY(title, options) "Status:\r\n" "Enter selection: \x1b" "7"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MENU_TABLE_H */
@@ -0,0 +1,125 @@
+/**
+ ******************************************************************************
+ * @file           : print_log.h
+ * @brief          : Tokenized Log Events (text or binary wire format)
+ ******************************************************************************
+ * @description
+ * Diagnostic log lines are declared once in PRINT_LOG_TABLE
+ * (print_log_table.h). Each entry becomes a small integer ID at compile
+ * time; call sites pass only the ID and the arguments.
+ *
+ * Output Modes:
+ * - Text (default): the print task formats the line exactly as
+ *   print_printf() would. Terminals see the usual human-readable text.
+ * - Binary: the print task sends a compact frame instead of the text.
+ *   tools/print_log_decode.py rebuilds the text on the host from the
+ *   string table that tools/print_log_table.c compiles out of
+ *   PRINT_LOG_TABLE (print_log_table.h; entry order = ID).
+ *
+ * Binary Frame Format:
+ * ┌──────┬────┬─────┬──────────────────────────────────────────┐
+ * │ 0x1F │ ID │ LEN │ payload (LEN bytes)                      │
+ * └──────┴────┴─────┴──────────────────────────────────────────┘
+ * Payload holds the arguments in format-string order:
+ * - %s : 1 length byte + string bytes (max 255)
+ * - any other conversion, and each '*' width or precision : 4 bytes,
+ *   little-endian
+ *
+ * Menus, prompts and echo stay plain text in both modes; the decoder
+ * passes any byte outside a frame straight through.
+ *
+ * Wire cost example (watchdog alert for "UART_task"):
+ * - Text:   ~120 bytes = ~10.4 ms @ 115200 baud
+ * - Binary: 3 + 10 + 4 + 4 + 4 = 25 bytes = ~2.2 ms
+ *
+ * Adding an Event:
+ * - Append an X(...) line to PRINT_LOG_TABLE in print_log_table.h
+ *   (append only: IDs are positions, and existing captures decode with
+ *   the old table), then regenerate the decoder's table
+ * - Log it with print_log(LOG_<NAME>, args...)
+ ******************************************************************************
+ */
+
+#ifndef __PRINT_LOG_H
+#define __PRINT_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include "FreeRTOS.h"
+#include "print_log_table.h"
+
+/*============================================================================
+ * Type Definitions
+ *===========================================================================*/
+
+/** Log event IDs (generated from PRINT_LOG_TABLE) */
+typedef enum {
+#define PRINT_LOG_ENUM(name, format) name,
+    PRINT_LOG_TABLE(PRINT_LOG_ENUM)
+#undef PRINT_LOG_ENUM
+    LOG_COUNT
+} print_log_id_t;
+
+/**
+ * @brief  Log output mode after reset
+ * @note   0 = text (terminal friendly), 1 = binary frames (needs decoder).
+ *         Can be changed at runtime with print_log_set_binary().
+ */
+#ifndef PRINT_LOG_BINARY_DEFAULT
+#define PRINT_LOG_BINARY_DEFAULT 0
+#endif
+
+/** Binary frame sync byte (ASCII unit separator, never sent as text) */
+#define PRINT_LOG_SYNC 0x1F
+
+/*============================================================================
+ * Public Function Interfaces
+ *===========================================================================*/
+
+/**
+ * @brief  Log a tokenized event
+ * @param  id: Event ID from PRINT_LOG_TABLE
+ * @param  ...: Arguments matching the event's format (same rules as
+ *              print_printf(): 32-bit words, %s must outlive the call)
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL otherwise
+ *
+ * Formatting (text) or encoding (binary) happens in the print task.
+ */
+BaseType_t print_log(print_log_id_t id, ...);
+
+/**
+ * @brief  Log a tokenized event on the urgent lane
+ * @param  id: Event ID from PRINT_LOG_TABLE
+ * @param  ...: Arguments matching the event's format (as print_log())
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL otherwise
+ *
+ * Sent ahead of pending menu/echo output and never blocks (see
+ * print_message_urgent()).
+ */
+BaseType_t print_log_urgent(print_log_id_t id, ...);
+
+/**
+ * @brief  Get the format string of a log event
+ * @param  id: Event ID
+ * @retval Format string, or "" for an unknown ID
+ */
+const char *print_log_format(print_log_id_t id);
+
+/**
+ * @brief  Select text or binary output for log events
+ * @param  enable: pdTRUE for binary frames, pdFALSE for text (default)
+ * @retval None
+ *
+ * Takes effect for events formatted after the call (events already
+ * queued use the new mode too, since encoding is deferred).
+ */
+void print_log_set_binary(BaseType_t enable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PRINT_LOG_H */
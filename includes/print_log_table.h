@@ -0,0 +1,37 @@
+/**
+ ******************************************************************************
+ * @file           : print_log_table.h
+ * @brief          : Log Event String Table (PRINT_LOG_TABLE)
+ ******************************************************************************
+ * @description
+ * The list of tokenized log events, kept apart from print_log.h so that it
+ * has no RTOS or HAL dependencies. The firmware expands it into the event
+ * IDs and format strings; tools/print_log_table.c expands the same macro
+ * on the host and writes the decoder's table, so the decoder never parses
+ * C source.
+ *
+ * Entry order is the event ID: append only.
+ ******************************************************************************
+ */
+
+#ifndef __PRINT_LOG_TABLE_H
+#define __PRINT_LOG_TABLE_H
+
+/*============================================================================
+ * Log Event Table (single source of truth)
+ *===========================================================================*/
+
+#define PRINT_LOG_TABLE(X) \
+    X(LOG_WATCHDOG_INIT,          "\r\n[WATCHDOG] Initialized\r\n") \
+    X(LOG_WATCHDOG_MAX_TASKS,     "[WATCHDOG] ERROR: Max tasks reached!\r\n") \
+    X(LOG_WATCHDOG_REGISTERED,    "[WATCHDOG] Registered '%s' (ID=%u, timeout=%lums)\r\n") \
+    X(LOG_WATCHDOG_STARTED,       "[WATCHDOG] Monitor task started\r\n") \
+    X(LOG_WATCHDOG_ALERT,         "\r\n*** WATCHDOG ALERT ***\r\n" \
+                                  "Task: %s (ID=%u)\r\n" \
+                                  "Last feed: %lu ms ago\r\n" \
+                                  "Timeout: %lu ms\r\n" \
+                                  "Status: HUNG or DEADLOCKED!\r\n\r\n") \
+    X(LOG_UART_WD_REGISTER_FAIL,  "[UART] Failed to register with watchdog!\r\n") \
+    X(LOG_CMD_WD_REGISTER_FAIL,   "[CMD] Failed to register with watchdog!\r\n")
+
+#endif /* __PRINT_LOG_TABLE_H */
@@ -0,0 +1,133 @@
+/**
+ ******************************************************************************
+ * @file           : print_port.h
+ * @brief          : Print Task Hardware Port (asynchronous UART TX)
+ ******************************************************************************
+ * @description
+ * Thin layer between the print task and the UART transmit hardware. The
+ * print task only ever calls the functions below, so the same print_task.c
+ * runs on target (USART2 TX via DMA1 Stream6) or under a host simulation
+ * that provides its own print_port.c.
+ *
+ * Contract:
+ * - print_port_transmit() starts a transfer and returns immediately. The
+ *   data must stay valid until the transfer completes.
+ * - Completion is reported by calling print_port_tx_complete_from_isr()
+ *   from interrupt context (on target: USART2 TC interrupt via
+ *   HAL_UART_TxCpltCallback; on host: the simulated TC interrupt).
+ * - print_port_wait_idle() blocks the calling task (no polling) until the
+ *   current transfer has completed.
+ *
+ * Only one transfer is in flight at a time. The print task double-buffers
+ * on top of this: it fills the next buffer while the current one drains.
+ ******************************************************************************
+ */
+
+#ifndef __PRINT_PORT_H
+#define __PRINT_PORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*============================================================================
+ * Configuration Constants
+ *===========================================================================*/
+
+/**
+ * @brief  Maximum time to wait for a transfer to complete (milliseconds)
+ * @note   Longest transfer (512 bytes @ 115200 baud) takes ~45ms. If the TC
+ *         interrupt never arrives, the transfer is aborted after this time
+ *         so the print task cannot hang forever.
+ */
+#define PRINT_PORT_TX_TIMEOUT_MS 500
+
+/**
+ * @brief  Polled transmit timeout for the emergency path (milliseconds)
+ * @note   Only used when the print task itself is hung, see
+ *         print_port_emergency_write().
+ */
+#define PRINT_PORT_EMERGENCY_TIMEOUT_MS 100
+
+/*============================================================================
+ * Public Function Interfaces
+ *===========================================================================*/
+
+/**
+ * @brief  Initialize the TX port
+ * @note   Must be called BEFORE starting the scheduler
+ * @retval None
+ *
+ * Creates the TX-complete semaphore. UART and DMA hardware are configured
+ * by MX_DMA_Init()/MX_USART2_UART_Init() in main.c.
+ */
+void print_port_init(void);
+
+/**
+ * @brief  Start an asynchronous transfer
+ * @param  data: Bytes to send (must remain valid until completion)
+ * @param  length: Number of bytes
+ * @retval BaseType_t: pdPASS if transfer started, pdFAIL otherwise
+ *
+ * @note   Caller must ensure the port is idle (print_port_wait_idle())
+ */
+BaseType_t print_port_transmit(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief  Block until the current transfer (if any) has completed
+ * @param  timeout: Maximum ticks to wait
+ * @retval BaseType_t: pdPASS if idle, pdFAIL if the transfer timed out
+ *
+ * On timeout the transfer is aborted and the port is left idle.
+ */
+BaseType_t print_port_wait_idle(TickType_t timeout);
+
+/**
+ * @brief  Check whether a transfer is in flight
+ * @retval BaseType_t: pdTRUE if busy, pdFALSE if idle
+ */
+BaseType_t print_port_is_busy(void);
+
+/**
+ * @brief  Transfer-complete notification (ISR context)
+ * @retval None
+ *
+ * Called by the TC interrupt (or its host simulation). Marks the port idle
+ * and wakes the task blocked in print_port_wait_idle().
+ */
+void print_port_tx_complete_from_isr(void);
+
+/**
+ * @brief  Polled transmit that bypasses the print task (last resort)
+ * @param  data: Bytes to send
+ * @param  length: Number of bytes
+ * @retval None
+ *
+ * Aborts any DMA transfer in flight, then busy-waits the bytes out. Only
+ * for reporting that the print task itself is hung: the caller blocks for
+ * the whole transfer and the aborted burst is lost.
+ */
+void print_port_emergency_write(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief  Send one byte ahead of the transfer in flight
+ * @param  c: Byte to send (XON/XOFF flow-control character)
+ * @retval None
+ *
+ * Holds the DMA for one character time, slips the byte in between two
+ * DMA beats and lets the transfer continue, so the byte leaves within
+ * ~2 character times instead of after the queued burst. Call from ISR
+ * context or inside a critical section (busy-waits at most one
+ * character time for the data register).
+ */
+void print_port_send_priority(uint8_t c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PRINT_PORT_H */
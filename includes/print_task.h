@@ -4,19 +4,22 @@
  * @brief          : Dedicated Print Task Interface
  ******************************************************************************
  * @description
- * This module implements a dedicated print task with message queue for
+ * This module implements a dedicated print task with a message buffer for
  * thread-safe UART transmission. All UART TX operations go through this
- * task, eliminating the need for mutex protection and preventing priority
- * inversion issues.
+ * task, eliminating the need for mutex protection around the UART and
+ * preventing priority inversion issues.
  *
  * Architecture:
  * - Print Task: Dedicated task that owns UART TX hardware exclusively
- * - Print Queue: Message queue for passing print requests from other tasks
+ * - Print Buffer: Variable-length message buffer for passing print requests
+ *   from other tasks (each message costs its length + a 4-byte header)
+ * - Priority Lanes: A separate urgent buffer for alerts, drained ahead of
+ *   the bulk (menu/echo) buffer at every message boundary
  * - Non-blocking API: Tasks enqueue messages and return immediately
  *
  * Benefits over Mutex Approach:
  * ✓ Non-blocking: Application tasks don't wait for slow UART transmission
- * ✓ No priority inversion: Queue-based synchronization is more predictable
+ * ✓ No priority inversion: Buffer-based synchronization is more predictable
  * ✓ Separation of concerns: Application tasks don't need UART knowledge
  * ✓ Scalable: Easy to add features (buffering, timestamps, priorities)
  * ✓ Centralized: Single point for UART TX control and debugging
@@ -29,21 +32,32 @@
  * // Character echo
  * print_char('A');
  *
- * // Formatted printing
- * char buffer[64];
- * snprintf(buffer, sizeof(buffer), "Value: %d\r\n", value);
- * print_message(buffer);
+ * // Menu or banner literal (only a pointer is queued)
+ * print_const("Enter selection: ");
+ *
+ * // Formatted printing (formatted later, inside the print task)
+ * print_printf("Value: %d\r\n", value);
+ *
+ * // Alert that must not wait behind menu output
+ * print_message_urgent("FAULT\r\n");
  * ```
  *
  * Performance:
- * - Queue operation: ~20-50μs (enqueue and return)
+ * - Enqueue operation: ~5-20μs (copies only the message bytes)
  * - Additional latency vs direct: ~50-100μs (context switch overhead)
  * - For human-readable text, this latency is imperceptible
  *
+ * Bytes copied per call (in + out of the buffer):
+ * - Old fixed-slot queue: 512 + 512 = 1024 bytes, even for print_char()
+ * - Message buffer:       2 × (length + 4) bytes, i.e. 10 bytes per echo
+ * - Measured at runtime with print_get_stats(), before/after on the host
+ *   with tools/print_copy_bench.c
+ *
  * Memory:
- * - Print queue: ~5.1 KB (10 messages × 512 bytes each)
+ * - Print buffers: 1 KB bulk + 512 B urgent
+ * - DMA TX buffers: 2 × 768 bytes (static, double-buffered)
  * - Print task stack: 512 words = 2048 bytes
- * - Total: ~7.1 KB (well within available heap)
+ * - Total: ~5 KB (was ~7.1 KB with the 10 × 512-byte queue)
  ******************************************************************************
  */
 
@@ -57,7 +71,8 @@ extern "C" {
 #include "main.h"
 #include "FreeRTOS.h"
 #include "task.h"
-#include "queue.h"
+#include "semphr.h"
+#include "message_buffer.h"
 
 /*============================================================================
  * Configuration Constants
@@ -67,23 +82,69 @@ extern "C" {
  * @brief  Maximum size of a single print message
  * @note   This must be large enough to hold the longest menu or message.
  *         Current longest message is the LED patterns menu (~320 bytes).
- *         512 bytes provides headroom for future expansion.
+ *         512 bytes provides headroom for future expansion. Longer
+ *         messages are truncated.
  */
 #define PRINT_MESSAGE_MAX_SIZE 512
 
 /**
- * @brief  Print message queue depth
- * @note   Number of messages that can be queued before blocking/dropping.
- *         10 messages provides good buffering for burst printing scenarios.
+ * @brief  Print message buffer size (bytes)
+ * @note   Total storage shared by all pending messages. Each message uses
+ *         its own length plus a 4-byte length header, so 1 KB holds two
+ *         full menus or ~100 echoed characters.
+ */
+#define PRINT_BUFFER_SIZE 1024
+
+/**
+ * @brief  Urgent lane message buffer size (bytes)
+ * @note   Alerts are short and rare; 512 bytes holds several watchdog
+ *         alerts (as text) even while the print task is busy.
+ */
+#define PRINT_URGENT_BUFFER_SIZE 512
+
+/**
+ * @brief  Coalescing byte budget per UART transmission
+ * @note   The print task gathers every pending message into one contiguous
+ *         TX burst up to this many bytes. Must be at least
+ *         PRINT_MESSAGE_MAX_SIZE so any single message fits. Two TX buffers
+ *         of this size are allocated statically (double buffering).
+ */
+#define PRINT_COALESCE_BUDGET 768
+
+/**
+ * @brief  Maximum arguments captured by print_printf()
+ * @note   Each argument is stored as one 32-bit word. Extra arguments are
+ *         dropped (their conversions print as 0).
+ */
+#define PRINT_PRINTF_MAX_ARGS 6
+
+/**
+ * @brief  Interrupt output ring size per ISR source (bytes, power of two)
+ * @note   Each message costs its length + 1. 128 bytes holds a few short
+ *         diagnostics between two print task wakeups.
  */
-#define PRINT_QUEUE_DEPTH 10
+#define PRINT_ISR_RING_SIZE 128
+
+/**
+ * @brief  Longest message accepted from interrupt context
+ * @note   Bounds the time spent copying inside the ISR. Longer messages
+ *         are truncated.
+ */
+#define PRINT_ISR_MESSAGE_MAX_SIZE 64
+
+/**
+ * @brief  Longest block accepted by print_write_binary()
+ * @note   Copied through the caller's stack; sized for binary command
+ *         response frames (cmd_frame.h).
+ */
+#define PRINT_BINARY_MAX_SIZE 64
 
 /**
  * @brief  Print task priority
  * @note   Priority 3 (highest application priority).
  *         Higher than UART/Command Handler to ensure print messages
  *         are processed immediately when queued, providing responsive
- *         echo and preventing queue buildup.
+ *         echo and preventing buffer buildup.
  */
 #define PRINT_TASK_PRIORITY 3
 
@@ -96,22 +157,104 @@ extern "C" {
 
 /**
  * @brief  Timeout for enqueuing print messages (milliseconds)
- * @note   If queue is full, wait this long before giving up.
- *         100ms timeout prevents deadlock if queue fills unexpectedly.
+ * @note   If buffer is full, wait this long before giving up.
+ *         100ms timeout prevents deadlock if buffer fills unexpectedly.
  */
 #define PRINT_ENQUEUE_TIMEOUT_MS 100
 
+/**
+ * @brief  Retries of a refused TX start before the burst is discarded
+ * @note   The HAL refuses a DMA start while the UART is still busy, e.g.
+ *         during a polled emergency write. Retries are one tick apart.
+ */
+#define PRINT_TX_START_RETRIES 3
+
+/*============================================================================
+ * Type Definitions
+ *===========================================================================*/
+
+/**
+ * @brief  Print lanes (lower value = higher priority)
+ */
+typedef enum {
+    PRINT_LANE_URGENT = 0,       /**< Alerts and diagnostics */
+    PRINT_LANE_BULK,             /**< Menus, echo, everything else */
+    PRINT_LANE_COUNT
+} print_lane_t;
+
+/**
+ * @brief  Interrupt sources with their own output ring
+ * @note   Each ISR must use only its own source: a ring has exactly one
+ *         producer, which is what makes it lock-free. Add an entry per
+ *         new interrupt that needs to print.
+ * @note   Only interrupts at or below configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+ *         (numerically >= 5) may print: the print task is woken with
+ *         vTaskNotifyGiveFromISR(). The TIM6 HAL timebase runs at
+ *         TICK_INT_PRIORITY 0 and must never print.
+ */
+typedef enum {
+    PRINT_ISR_SOURCE_UART_RX = 0,   /**< USART2 RX callbacks (priority 6) */
+    PRINT_ISR_SOURCE_EXTI,          /**< External interrupts (buttons etc.) */
+    PRINT_ISR_SOURCE_COUNT
+} print_isr_source_t;
+
+/**
+ * @brief  Print pipeline statistics
+ *
+ * Copy counters cover both directions (caller -> buffer and buffer -> print
+ * task), including the message buffer's 4-byte length header. Dividing
+ * bytes_copied by messages_sent gives the average copy cost per call.
+ */
+typedef struct {
+    uint32_t messages_sent;      /**< Messages accepted into the buffer */
+    uint32_t messages_dropped;   /**< Messages rejected (buffer full) */
+    uint32_t bytes_copied;       /**< Total bytes copied in and out */
+    uint32_t tx_timeouts;        /**< DMA transfers aborted (no TC interrupt) */
+    uint32_t tx_refused;         /**< DMA starts refused by the HAL (each retried) */
+    uint32_t tx_lost;            /**< Bursts discarded after PRINT_TX_START_RETRIES retries */
+    uint32_t bursts;             /**< UART transmissions started */
+    uint32_t burst_messages;     /**< Messages carried by those transmissions */
+    uint32_t burst_bytes;        /**< Payload bytes carried by those transmissions */
+    uint32_t wakeups_saved;      /**< Messages merged into an earlier burst */
+    uint32_t largest_burst;      /**< Most messages merged into one burst */
+    uint32_t bytes_by_reference; /**< print_const() bytes sent without a buffer copy */
+    uint32_t isr_messages;       /**< Messages accepted from interrupt context */
+    uint32_t isr_dropped;        /**< Interrupt messages dropped (ring full) */
+} print_stats_t;
+
+/**
+ * @brief  Per-lane depth and latency counters
+ *
+ * Latency is the age of the lane's backlog when the print task picks a
+ * message up, i.e. an upper bound on that message's queueing delay. It
+ * does not include the UART time of the message itself.
+ */
+typedef struct {
+    uint32_t messages_sent;      /**< Messages accepted into the lane */
+    uint32_t messages_dropped;   /**< Messages rejected (lane full) */
+    uint32_t depth_bytes;        /**< Bytes pending right now (incl. headers) */
+    uint32_t max_depth_bytes;    /**< High-water mark of depth_bytes */
+    uint32_t last_latency_ms;    /**< Latency of the most recent pickup */
+    uint32_t max_latency_ms;     /**< Worst latency seen */
+} print_lane_stats_t;
+
 /*============================================================================
  * FreeRTOS Objects (Global Handles)
  *===========================================================================*/
 
 /**
- * @brief  Print message queue handle
- * @details Queue that passes print messages from application tasks to the
- *          print task. Depth: PRINT_QUEUE_DEPTH. Item size: PRINT_MESSAGE_MAX_SIZE.
+ * @brief  Print message buffer handle
+ * @details Message buffer that passes print messages from application tasks
+ *          to the print task. Size: PRINT_BUFFER_SIZE bytes.
  *          Created in print_task_init().
  */
-extern QueueHandle_t print_queue;
+extern MessageBufferHandle_t print_buffer;
+
+/**
+ * @brief  Urgent lane message buffer handle
+ * @details Size: PRINT_URGENT_BUFFER_SIZE bytes. Created in print_task_init().
+ */
+extern MessageBufferHandle_t print_urgent_buffer;
 
 /**
  * @brief  UART2 peripheral handle
@@ -126,12 +269,13 @@ extern UART_HandleTypeDef huart2;
  *===========================================================================*/
 
 /**
- * @brief  Initialize print task and message queue
+ * @brief  Initialize print task and message buffer
  * @note   MUST be called before starting the FreeRTOS scheduler
  * @retval None
  *
  * Creates:
- * - Print message queue (PRINT_QUEUE_DEPTH × PRINT_MESSAGE_MAX_SIZE)
+ * - Print message buffers (PRINT_BUFFER_SIZE bulk, PRINT_URGENT_BUFFER_SIZE urgent)
+ * - Writer locks (one mutex per lane serializing producers, see print_message())
  * - Print task (priority PRINT_TASK_PRIORITY, stack PRINT_TASK_STACK_SIZE)
  *
  * All creation operations use configASSERT() to detect failures.
@@ -139,35 +283,126 @@ extern UART_HandleTypeDef huart2;
 void print_task_init(void);
 
 /**
- * @brief  Send a string message to the print queue
+ * @brief  Send a string message to the print buffer
  * @param  message: Null-terminated string to print (max PRINT_MESSAGE_MAX_SIZE)
  * @retval BaseType_t: pdPASS if message queued successfully, pdFAIL if timeout
  *
  * Behavior:
- * - Copies message to queue (safe to use local/stack buffers)
+ * - Copies message to buffer (safe to use local/stack buffers)
+ * - Only strlen(message) bytes are copied (no fixed-size slot)
  * - Returns immediately after enqueuing (non-blocking for caller)
- * - If queue full, waits up to PRINT_ENQUEUE_TIMEOUT_MS before returning pdFAIL
+ * - If buffer full, waits up to PRINT_ENQUEUE_TIMEOUT_MS before returning pdFAIL
  * - Print task will transmit message via UART when scheduled
  *
- * Thread Safety: Safe to call from any task or ISR (FromISR variant)
+ * Thread Safety: Safe to call from any task (not from ISRs - use
+ * print_message_from_isr())
  *
  * Example:
  * ```c
  * if (print_message("Hello\r\n") == pdFAIL) {
- *     // Queue full - message dropped
+ *     // Buffer full - message dropped
  * }
  * ```
  */
 BaseType_t print_message(const char *message);
 
 /**
- * @brief  Send a single character to the print queue
+ * @brief  Send a string message on the urgent lane
+ * @param  message: Null-terminated string to print (max PRINT_MESSAGE_MAX_SIZE)
+ * @retval BaseType_t: pdPASS if message queued successfully, pdFAIL if timeout
+ *
+ * Same contract as print_message(), except that it never blocks: if the
+ * urgent lane is full or its lock is held, the message is dropped and
+ * counted. The print task sends it before any pending bulk output,
+ * preempting at the next message boundary. Meant for alerts and
+ * diagnostics; bulk output here defeats the purpose.
+ */
+BaseType_t print_message_urgent(const char *message);
+
+/**
+ * @brief  Send a constant string by reference (zero-copy enqueue)
+ * @param  message: Null-terminated string literal or other immutable,
+ *                  statically allocated text (max PRINT_MESSAGE_MAX_SIZE)
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL if timeout
+ *
+ * Behavior:
+ * - Enqueues a 12-byte record (pointer + length) instead of the text
+ * - The print task copies the text from flash into the TX burst once
+ * - Buffer usage no longer depends on the string length, so a queue of
+ *   menu redraws cannot fill the print buffer
+ *
+ * Restriction: NEVER pass a stack or otherwise mutable buffer - the text
+ * is read later, when the print task builds the burst.
+ *
+ * Example:
+ * ```c
+ * print_const("\r\nInvalid option. Please try again.\r\n");
+ * ```
+ */
+BaseType_t print_const(const char *message);
+
+/**
+ * @brief  Send a string message from interrupt context
+ * @param  source: The calling ISR's source (one producer per ring)
+ * @param  message: Null-terminated string (max PRINT_ISR_MESSAGE_MAX_SIZE)
+ * @param  pxHigherPriorityTaskWoken: [OUT] Set to pdTRUE if the print task
+ *                                    was woken; pass to portYIELD_FROM_ISR()
+ * @retval BaseType_t: pdPASS if queued, pdFAIL if the ring is full
+ *
+ * Behavior:
+ * - Copies the text into the source's ring (no locks, no blocking)
+ * - Execution time is bounded by PRINT_ISR_MESSAGE_MAX_SIZE
+ * - A full ring drops the whole message (counted in isr_dropped)
+ * - The print task sends it ahead of queued task output
+ *
+ * Restriction: the calling interrupt's priority must be numerically >=
+ * configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY; configASSERT() fails
+ * otherwise (see print_isr_source_t).
+ *
+ * Example:
+ * ```c
+ * BaseType_t woken = pdFALSE;
+ * print_message_from_isr(PRINT_ISR_SOURCE_EXTI, "[BTN] pressed\r\n", &woken);
+ * portYIELD_FROM_ISR(woken);
+ * ```
+ */
+BaseType_t print_message_from_isr(print_isr_source_t source, const char *message,
+                                  BaseType_t *pxHigherPriorityTaskWoken);
+
+/**
+ * @brief  Send raw bytes from interrupt context
+ * @param  source: The calling ISR's source (one producer per ring)
+ * @param  data: Bytes to print (need not be null-terminated)
+ * @param  length: Number of bytes (max PRINT_ISR_MESSAGE_MAX_SIZE)
+ * @param  pxHigherPriorityTaskWoken: [OUT] Set to pdTRUE if the print task
+ *                                    was woken
+ * @retval BaseType_t: pdPASS if queued, pdFAIL if the ring is full or
+ *         length exceeds PRINT_ISR_MESSAGE_MAX_SIZE
+ *
+ * Used for echoing a received chunk straight from the RX interrupt.
+ */
+BaseType_t print_write_from_isr(print_isr_source_t source, const void *data, size_t length,
+                                BaseType_t *pxHigherPriorityTaskWoken);
+
+/**
+ * @brief  Send a single character from interrupt context
+ * @param  source: The calling ISR's source (one producer per ring)
+ * @param  c: Character to print
+ * @param  pxHigherPriorityTaskWoken: [OUT] Set to pdTRUE if the print task
+ *                                    was woken
+ * @retval BaseType_t: pdPASS if queued, pdFAIL if the ring is full
+ */
+BaseType_t print_char_from_isr(print_isr_source_t source, char c,
+                               BaseType_t *pxHigherPriorityTaskWoken);
+
+/**
+ * @brief  Send a single character to the print buffer
  * @param  c: Character to print
  * @retval BaseType_t: pdPASS if character queued successfully, pdFAIL if timeout
  *
  * Behavior:
  * - Optimized for single character printing (echo use case)
- * - Internally creates a 2-byte message: [character, null terminator]
+ * - Enqueues a 1-byte message (5 bytes of buffer space with header)
  * - Returns immediately after enqueuing
  *
  * Use Case: Character echo in UART reception
@@ -179,23 +414,121 @@ BaseType_t print_message(const char *message);
  */
 BaseType_t print_char(char c);
 
+/**
+ * @brief  Send a run of raw bytes to the print buffer
+ * @param  data: Bytes to print (need not be null-terminated)
+ * @param  length: Number of bytes (max PRINT_MESSAGE_MAX_SIZE)
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL if timeout or
+ *         length exceeds PRINT_MESSAGE_MAX_SIZE
+ *
+ * One message for the whole run, so echoing a pasted line costs one
+ * enqueue instead of one print_char() per byte. Leading NUL bytes are
+ * skipped (they print nothing and would look like a control record).
+ */
+BaseType_t print_write(const void *data, size_t length);
+
+/**
+ * @brief  Send binary data that may contain NUL bytes
+ * @param  data: Bytes to send unchanged
+ * @param  length: Number of bytes (max PRINT_BINARY_MAX_SIZE)
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL if timeout or
+ *         length exceeds PRINT_BINARY_MAX_SIZE
+ *
+ * For binary response frames, which start with a 0x00 delimiter that
+ * print_write() would skip. Enqueued as a control record carrying the
+ * bytes inline (2 bytes of overhead) on the bulk lane, so it stays in
+ * order with the surrounding text.
+ */
+BaseType_t print_write_binary(const void *data, size_t length);
+
+/**
+ * @brief  Print formatted text, formatting deferred to the print task
+ * @param  format: printf-style format string (must have static storage,
+ *                 e.g. a string literal)
+ * @param  ...: Up to PRINT_PRINTF_MAX_ARGS 32-bit arguments
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL if timeout
+ *
+ * Behavior:
+ * - Enqueues only the format pointer and the packed arguments
+ * - snprintf() runs later in the print task, straight into the TX buffer
+ * - No response buffer needed on the caller's stack
+ *
+ * Restrictions (arguments are captured as raw words):
+ * - Integer, char and pointer arguments only (no %f, %lld)
+ * - %s strings are read when the print task formats them, so they must
+ *   outlive the call (literals, static or global buffers - NOT stack)
+ * - Each '*' width or precision takes one argument (an int), before
+ *   the value it applies to, and counts towards PRINT_PRINTF_MAX_ARGS
+ *
+ * Example:
+ * ```c
+ * print_printf("Pattern %u active, period %lu ms\r\n", id, period_ms);
+ * ```
+ */
+BaseType_t print_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief  Wait until everything queued so far has left the UART
+ * @param  timeout: Maximum time to wait (ticks)
+ * @retval BaseType_t: pdPASS once both lanes, the interrupt rings and the
+ *         TX hardware are empty, pdFAIL on timeout
+ *
+ * Checks once per tick (a rare operation, e.g. before changing the baud
+ * rate, so no extra signalling in the print path). Output queued by other
+ * tasks while waiting extends the wait. Must not be called from the print
+ * task.
+ */
+BaseType_t print_flush(TickType_t timeout);
+
+/**
+ * @brief  Get the print task handle
+ * @retval TaskHandle_t: Print task, or NULL before print_task_init()
+ *
+ * Lets the watchdog recognise when the hung task is the print task itself
+ * (and queued output can no longer get out).
+ */
+TaskHandle_t print_task_get_handle(void);
+
+/**
+ * @brief  Get print pipeline statistics
+ * @param  stats: [OUT] Snapshot of the counters
+ * @retval None
+ *
+ * Used to verify the per-call copy cost on target, e.g. after an echo
+ * burst bytes_copied / messages_sent should be ~10.
+ */
+void print_get_stats(print_stats_t *stats);
+
+/**
+ * @brief  Get depth and latency counters of one lane
+ * @param  lane: PRINT_LANE_URGENT or PRINT_LANE_BULK
+ * @param  stats: [OUT] Snapshot of the counters
+ * @retval None
+ *
+ * Used to verify that urgent max_latency_ms stays bounded (about two
+ * bursts, ~135 ms @ 115200 baud) while the bulk lane is backlogged.
+ */
+void print_get_lane_stats(print_lane_t lane, print_lane_stats_t *stats);
+
 /**
  * @brief  Print task handler (main task loop)
  * @param  parameters: Task parameters (unused, required by FreeRTOS API)
  * @retval None (task never returns)
  *
  * Task Behavior:
- * 1. Blocks waiting for messages in print queue
- * 2. When message available, dequeues it
- * 3. Transmits message via HAL_UART_Transmit()
+ * 1. Blocks waiting for messages in either lane
+ * 2. When message available, drains every pending message (up to
+ *    PRINT_COALESCE_BUDGET bytes, urgent lane first) into one contiguous burst
+ * 3. Transmits the burst via DMA (print_port.h), double-buffered so the
+ *    next burst is gathered while the current one drains
  * 4. Repeats - processes all queued messages before blocking again
  *
  * Features:
  * - Exclusive UART TX ownership (no concurrent access)
- * - Processes messages in FIFO order
+ * - Processes messages in FIFO order within each lane
  * - Yields between messages if higher priority tasks ready
  *
- * Priority: PRINT_TASK_PRIORITY (1) - lower than application tasks
+ * Priority: PRINT_TASK_PRIORITY (3) - highest application priority
  *
  * @note This task has EXCLUSIVE access to UART TX hardware.
  *       No other task should call HAL_UART_Transmit() directly.
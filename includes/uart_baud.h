@@ -0,0 +1,91 @@
+/**
+ ******************************************************************************
+ * @file           : uart_baud.h
+ * @brief          : Baud Rate Table and Auto-Baud Estimation
+ ******************************************************************************
+ * @description
+ * The STM32F4 USART has no hardware auto-baud, so the first character
+ * after reset is timed in software: the RX interrupt that sees its start
+ * bit (EXTI falling edge on the RX pin) samples the pin and records the
+ * DWT cycle count of every following transition. The bit time is then
+ * recovered from those edge times:
+ *
+ *   start  b0  b1  b2  b3  b4  b5  b6  b7  stop         CR = 0x0D
+ *   ‾‾\___/‾‾‾\___/‾‾‾‾‾‾‾\_______________/‾‾‾‾‾‾
+ *         e0   e1  e2      e3              e4
+ *
+ * - The edges after the start edge lie on bit boundaries 1-9, so the
+ *   span first -> last edge is a whole number of bits, at most 8
+ *   (e0 -> e4 = 8 bits above)
+ * - The smallest bit count for which every gap comes out as a whole
+ *   number of bits (within 1/4 bit) that add up to the span is taken;
+ *   span / bits is the bit time averaged over the character, so the
+ *   sampling jitter of a single edge hardly matters
+ * - The result is snapped to the nearest supported rate within
+ *   UART_BAUD_TOLERANCE_PERCENT (rates are at least 1.5x apart)
+ *
+ * The start edge itself is not used (interrupt entry latency is unknown),
+ * so edges missed while the interrupt was being entered only shorten the
+ * span. The character needs one run of a single bit after its first
+ * edge: Enter (CR) and most printable characters have one, NUL does not.
+ *
+ * The module has no RTOS or HAL dependencies; tools/autobaud_sim.c runs
+ * the estimator against synthetic edge timings on the host.
+ ******************************************************************************
+ */
+
+#ifndef __UART_BAUD_H
+#define __UART_BAUD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*============================================================================
+ * Configuration Constants
+ *===========================================================================*/
+
+/** Largest deviation from a standard rate still accepted (percent) */
+#define UART_BAUD_TOLERANCE_PERCENT 6
+
+/** Transitions recorded per character (8 data bits + stop, after the start edge) */
+#define UART_BAUD_MAX_EDGES 9
+
+/** Slowest supported rate (bounds the auto-baud sampling time) */
+#define UART_BAUD_MIN 9600
+
+/*============================================================================
+ * Public Function Interfaces
+ *===========================================================================*/
+
+/**
+ * @brief  Check a rate against the table of supported rates
+ * @param  baud: Rate in bit/s
+ * @retval Non-zero if baud is one of 9600 ... 2000000
+ */
+int uart_baud_supported(uint32_t baud);
+
+/**
+ * @brief  Snap a measured rate to the nearest supported rate
+ * @param  measured: Measured rate in bit/s
+ * @retval Supported rate within UART_BAUD_TOLERANCE_PERCENT, or 0
+ */
+uint32_t uart_baud_nearest(uint32_t measured);
+
+/**
+ * @brief  Estimate the baud rate from the edge times of one character
+ * @param  edges: Cycle counts of the transitions after the start edge
+ * @param  count: Number of edges (at least 2 are needed)
+ * @param  clock_hz: Cycle counter frequency
+ * @retval Supported rate, or 0 if the edges do not match one
+ */
+uint32_t uart_baud_estimate(const uint32_t *edges, size_t count, uint32_t clock_hz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UART_BAUD_H */
@@ -0,0 +1,95 @@
+/**
+ ******************************************************************************
+ * @file           : uart_flow.h
+ * @brief          : RX Flow Control Watermarks (sender throttling decision)
+ ******************************************************************************
+ * @description
+ * Decides when the sender must stop and when it may resume, from the fill
+ * level of the RX stream buffer. Hysteresis keeps the line from toggling
+ * on every byte:
+ *
+ *   fill >= high watermark  -> STOP  (RTS deasserted / XOFF sent)
+ *   fill <= low watermark   -> START (RTS asserted / XON sent)
+ *
+ * Bytes between the two watermarks leave the state unchanged. The high
+ * watermark must leave room for everything that can still arrive after
+ * STOP: the rest of the current DMA chunk, a partly assembled line and
+ * the bytes the sender has in flight (see UART_FLOW_HIGH_WATERMARK).
+ *
+ * The module has no RTOS or HAL dependencies; the caller applies the
+ * returned action to the hardware, and tools/uart_rx_sim.c drives the
+ * same code on the host.
+ ******************************************************************************
+ */
+
+#ifndef __UART_FLOW_H
+#define __UART_FLOW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*============================================================================
+ * Configuration Constants
+ *===========================================================================*/
+
+/** Software flow control characters (DC1 / DC3) */
+#define UART_FLOW_XON   0x11
+#define UART_FLOW_XOFF  0x13
+
+/*============================================================================
+ * Type Definitions
+ *===========================================================================*/
+
+/** What to tell the sender after a fill-level update */
+typedef enum {
+    UART_FLOW_KEEP = 0,     /**< No change */
+    UART_FLOW_STOP,         /**< Crossed the high watermark: throttle */
+    UART_FLOW_START         /**< Drained to the low watermark: resume */
+} uart_flow_action_t;
+
+/** Watermark state (one per receiver) */
+typedef struct {
+    size_t high_watermark;       /**< Throttle at or above this fill (bytes) */
+    size_t low_watermark;        /**< Resume at or below this fill (bytes) */
+    uint8_t throttled;           /**< Non-zero while the sender is stopped */
+    uint32_t throttle_events;    /**< Times the sender was stopped */
+} uart_flow_t;
+
+/*============================================================================
+ * Public Function Interfaces
+ *===========================================================================*/
+
+/**
+ * @brief  Update the throttle state from the current fill level
+ * @param  flow: Watermark state
+ * @param  fill: Bytes currently waiting in the RX buffer
+ * @retval Action to apply to the sender (UART_FLOW_KEEP most of the time)
+ *
+ * Not thread-safe: call from the RX interrupt, or from the task inside a
+ * critical section.
+ */
+static inline uart_flow_action_t uart_flow_update(uart_flow_t *flow, size_t fill)
+{
+    if (!flow->throttled && fill >= flow->high_watermark) {
+        flow->throttled = 1;
+        flow->throttle_events++;
+        return UART_FLOW_STOP;
+    }
+
+    if (flow->throttled && fill <= flow->low_watermark) {
+        flow->throttled = 0;
+        return UART_FLOW_START;
+    }
+
+    return UART_FLOW_KEEP;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UART_FLOW_H */
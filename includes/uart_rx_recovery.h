@@ -0,0 +1,101 @@
+/**
+ ******************************************************************************
+ * @file           : uart_rx_recovery.h
+ * @brief          : RX Error Accounting and Re-arm Decision
+ ******************************************************************************
+ * @description
+ * Decides what to do with circular DMA reception after a receive error
+ * and when the UART task finds it stopped, and counts what happened:
+ *
+ *   error, RX still armed   -> KEEP     (e.g. a TX DMA error)
+ *   error, RX stopped       -> RESTART  (salvage the DMA buffer, re-arm)
+ *   re-arm refused          -> RETRY    (wake the task: liveness check)
+ *   task finds RX stopped   -> RESTART  (counted as a stall)
+ *
+ * The caller reads the HAL state, performs the re-arm and reports the
+ * result back; the module only decides and counts. Error flags use the
+ * HAL_UART_ERROR_xx values (checked in uart_task.c).
+ *
+ * The module has no RTOS or HAL dependencies; tools/uart_rx_sim.c drives
+ * the same code on the host.
+ ******************************************************************************
+ */
+
+#ifndef __UART_RX_RECOVERY_H
+#define __UART_RX_RECOVERY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*============================================================================
+ * Configuration Constants
+ *===========================================================================*/
+
+/** Receive error flags (same bits as HAL_UART_ERROR_PE ... _DMA) */
+#define UART_RX_ERROR_PE    0x01U   /**< Parity */
+#define UART_RX_ERROR_NE    0x02U   /**< Noise */
+#define UART_RX_ERROR_FE    0x04U   /**< Framing */
+#define UART_RX_ERROR_ORE   0x08U   /**< Overrun */
+#define UART_RX_ERROR_DMA   0x10U   /**< DMA transfer error */
+
+/*============================================================================
+ * Type Definitions
+ *===========================================================================*/
+
+/** What the caller must do with reception */
+typedef enum {
+    UART_RX_KEEP = 0,       /**< Reception is running: nothing to do */
+    UART_RX_RESTART,        /**< Reception stopped: re-arm it (salvage first) */
+    UART_RX_RETRY           /**< Re-arm refused: have the task retry soon */
+} uart_rx_action_t;
+
+/** Error and recovery counters (one per receiver) */
+typedef struct {
+    uint32_t parity;            /**< Parity errors */
+    uint32_t noise;             /**< Noise errors */
+    uint32_t framing;           /**< Framing errors */
+    uint32_t overrun;           /**< Overrun errors */
+    uint32_t dma;               /**< DMA transfer errors */
+    uint32_t restarts;          /**< Re-armed right after an error */
+    uint32_t rearm_failures;    /**< Re-arm attempts refused */
+    uint32_t stalls;            /**< Found stopped by the liveness check */
+    uint8_t after_error;        /**< A re-arm is due to an error (internal) */
+} uart_rx_recovery_t;
+
+/*============================================================================
+ * Public Function Interfaces
+ *===========================================================================*/
+
+/**
+ * @brief  Count a receive error and decide on reception
+ * @param  rx: Recovery state
+ * @param  errors: UART_RX_ERROR_xx flags
+ * @param  stopped: Non-zero if the error stopped reception
+ * @retval UART_RX_RESTART if reception must be re-armed, else UART_RX_KEEP
+ */
+uart_rx_action_t uart_rx_recovery_error(uart_rx_recovery_t *rx, uint32_t errors, int stopped);
+
+/**
+ * @brief  Report the result of a re-arm attempt
+ * @param  rx: Recovery state
+ * @param  started: Non-zero if reception was armed
+ * @retval UART_RX_KEEP if running, UART_RX_RETRY if it must be retried
+ */
+uart_rx_action_t uart_rx_recovery_rearmed(uart_rx_recovery_t *rx, int started);
+
+/**
+ * @brief  Liveness check: is reception still armed?
+ * @param  rx: Recovery state
+ * @param  armed: Non-zero if reception is armed
+ * @retval UART_RX_RESTART if it stalled and must be re-armed, else UART_RX_KEEP
+ */
+uart_rx_action_t uart_rx_recovery_check(uart_rx_recovery_t *rx, int armed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UART_RX_RECOVERY_H */
@@ -5,11 +5,12 @@
  ******************************************************************************
  * @description
  * This header defines the interface for the UART reception task and related
- * FreeRTOS synchronization objects. The UART task handles character-by-character
- * input with echo and command buffering.
+ * FreeRTOS synchronization objects. The UART task reads input in blocks and
+ * handles echo and command buffering.
  *
  * Architecture: Stream Buffer Mode (Efficient)
- * - Interrupt-driven UART reception (HAL_UART_Receive_IT)
+ * - Circular DMA reception with idle-line detection
+ *   (HAL_UARTEx_ReceiveToIdle_DMA, one interrupt per burst)
  * - Stream buffer for ISR-to-Task communication
  * - TRUE task blocking (yields CPU when idle)
  * - Zero CPU waste (no polling)
@@ -20,11 +21,11 @@
  * - Stream Buffer: Efficient ISR-to-Task byte transfer
  *
  * Configuration:
- * - UART2 peripheral: 115200 baud, 8N1, no flow control
- * - Command buffer: 32 characters max (configurable)
+ * - UART2 peripheral: 115200 baud, 8N1, flow control per UART_FLOW_CONTROL
+ * - Command buffer: 63 characters max (COMMAND_MAX_LENGTH 64)
  * - RX buffer: 128 characters (internal buffering)
- * - Stream buffer: 128 bytes (ISR-to-Task FIFO)
- * - Command queue depth: 5 commands
+ * - Stream buffer: 512 bytes (ISR-to-Task FIFO)
+ * - Command queue depth: 5 commands (COMMAND_QUEUE_DEPTH)
  *
  * Thread Safety:
  * UART TX operations are handled exclusively by the print task.
@@ -45,16 +46,17 @@ extern "C" {
 #include "queue.h"
 #include "semphr.h"
 #include "stream_buffer.h"
+#include "uart_flow.h"
 
 /*============================================================================
  * Configuration Constants
  *===========================================================================*/
 
 /**
- * @brief  Internal buffer size for UART reception
- * @note   This is the working buffer for assembling commands before they're
- *         sent to the command queue. Should be larger than COMMAND_MAX_LENGTH
- *         to allow for overflow detection.
+ * @brief  Line size of the RX interrupt's line discipline
+ * @note   Lines are assembled in the command pool (COMMAND_MAX_LENGTH);
+ *         this only bounds what the interrupt collects before the UART
+ *         task sees it, so longer lines still reach the overflow check.
  */
 #define UART_RX_BUFFER_SIZE 128
 
@@ -62,16 +64,263 @@ extern "C" {
  * @brief  Stream buffer size for ISR-to-Task communication
  * @note   Used for efficient interrupt-driven UART reception. The ISR deposits
  *         received bytes into this buffer, and the task reads from it.
- *         Trigger level is set to 1 (task wakes on any byte).
+ *         Trigger level is set to 1 (task wakes on any byte). Sized so the
+ *         flow control headroom (see UART_FLOW_HIGH_WATERMARK) fits.
  */
-#define UART_STREAM_BUFFER_SIZE 128
+#define UART_STREAM_BUFFER_SIZE 512
 
 /**
- * @brief  Maximum length of a single command
- * @note   This is the size of each command slot in the queue. Commands longer
- *         than this will trigger a buffer overflow error and be discarded.
+ * @brief  Largest block the UART task takes from the stream buffer at once
+ * @note   Lives on the UART task stack. A pasted script is drained in
+ *         blocks of this size (one kernel call each) instead of one call
+ *         per byte; typed input still returns as soon as a byte arrives.
  */
-#define COMMAND_MAX_LENGTH 32
+#define UART_RX_BLOCK_SIZE 64
+
+/**
+ * @brief  Circular DMA receive buffer size (bytes)
+ * @note   DMA1 Stream5 writes received bytes here continuously. The CPU is
+ *         interrupted on line idle, half-transfer and transfer-complete, so
+ *         at most every UART_RX_DMA_BUFFER_SIZE / 2 bytes (~0.7 ms at
+ *         921600 baud) instead of on every byte.
+ */
+#define UART_RX_DMA_BUFFER_SIZE 128
+
+/**
+ * @brief  Line discipline mode
+ * @note   1 = the RX interrupt assembles lines: it echoes input, applies
+ *         backspace and overflow handling, and puts only complete lines
+ *         (terminated by '\r') into the stream buffer. The UART task is
+ *         then woken once per command instead of once per character.
+ *         0 = raw mode: every byte goes to the task, which echoes and edits.
+ */
+#ifndef UART_LINE_DISCIPLINE
+#define UART_LINE_DISCIPLINE 1
+#endif
+
+/**
+ * @brief  Auto-baud on the first character after reset
+ * @note   1 = the first character received after reset (press Enter) is
+ *         timed on the RX pin (EXTI3 on PA3, DWT cycle counter, see
+ *         uart_baud.h) instead of being received. If it was sent at
+ *         another supported rate, USART2 switches to that rate. The
+ *         welcome screen waits for this character, and the character
+ *         itself is consumed. The EXTI3 handler polls the pin for one
+ *         character plus ten idle bits (about 2 ms at 9600 baud).
+ *         0 = fixed at the CubeMX rate (115200) until a "baud" command.
+ */
+#ifndef UART_AUTOBAUD
+#define UART_AUTOBAUD 0
+#endif
+
+/**
+ * @brief  Time to confirm a "baud <rate>" switch (ms)
+ * @note   The host has this long to send "ok" at the new rate; otherwise
+ *         the previous rate is restored, so a rate the host or adapter
+ *         cannot handle never locks the console out.
+ */
+#define UART_BAUD_CONFIRM_MS 10000
+
+/**
+ * @brief  RX timing instrumentation
+ * @note   1 = stamp every RX interrupt with the DWT cycle counter and keep
+ *         histograms of burst gaps, burst lengths and ISR-to-task wake
+ *         latency, dumped by the "rxstats" command (~260 bytes of RAM and
+ *         a few dozen cycles per interrupt). 0 = compiled out entirely;
+ *         "rxstats" then shows only the counters.
+ */
+#ifndef UART_RX_TIMING
+#define UART_RX_TIMING 0
+#endif
+
+/**
+ * @brief  Buckets per RX timing histogram
+ * @note   Bucket 0 counts zeros, bucket n counts 2^(n-1) .. 2^n - 1, and
+ *         the last bucket also counts everything larger.
+ */
+#define UART_RX_TIMING_BUCKETS 20
+
+/**
+ * @brief  RX flow control modes (values for UART_FLOW_CONTROL)
+ */
+#define UART_FLOW_NONE      0   /**< No throttling; overflow drops input */
+#define UART_FLOW_RTS_CTS   1   /**< Hardware: RTS on PA1, CTS on PD3 */
+#define UART_FLOW_XON_XOFF  2   /**< Software: XOFF/XON sent in band */
+
+/**
+ * @brief  RX flow control mode
+ * @note   With flow control the sender is stopped when the stream buffer
+ *         reaches UART_FLOW_HIGH_WATERMARK and restarted at
+ *         UART_FLOW_LOW_WATERMARK, and the UART task waits for the command
+ *         queue instead of dropping commands, so a paste of any length is
+ *         received without loss.
+ *         UART_FLOW_RTS_CTS needs the RTS/CTS lines wired to the host
+ *         adapter (the ST-LINK virtual COM port has none);
+ *         UART_FLOW_XON_XOFF needs a host that honours XON/XOFF.
+ *         Default is none: plain terminals keep working unchanged.
+ */
+#ifndef UART_FLOW_CONTROL
+#define UART_FLOW_CONTROL UART_FLOW_NONE
+#endif
+
+/**
+ * @brief  Bytes the sender may still send after being told to stop
+ * @note   RTS is usually honoured within 1-2 bytes; XOFF goes through the
+ *         host's driver and FIFO, so allow for a 16-byte FIFO.
+ */
+#define UART_FLOW_REACTION_BYTES 16
+
+/**
+ * @brief  Stream buffer fill (bytes) at which the sender is stopped
+ * @note   Headroom above it must absorb everything that can still arrive:
+ *         a partly assembled line (UART_RX_BUFFER_SIZE), the rest of the
+ *         current DMA chunk (half the DMA buffer) and the sender's
+ *         reaction bytes. 512 - (128 + 64 + 16) = 304 bytes, well above
+ *         one DMA chunk so a fast consumer never triggers a throttle.
+ */
+#define UART_FLOW_HIGH_WATERMARK \
+    (UART_STREAM_BUFFER_SIZE - UART_RX_BUFFER_SIZE - \
+     UART_RX_DMA_BUFFER_SIZE / 2 - UART_FLOW_REACTION_BYTES)
+
+/**
+ * @brief  Stream buffer fill (bytes) at which the sender is restarted
+ */
+#define UART_FLOW_LOW_WATERMARK (UART_FLOW_HIGH_WATERMARK / 3)
+
+/**
+ * @brief  Flow control pins (USART2 alternates that are free on the board)
+ * @note   PA0 (USART2_CTS) is the user button and PD4 (USART2_RTS) the
+ *         audio codec reset, so CTS uses PD3 and RTS is a plain GPIO on
+ *         PA1. RTS is driven by software anyway: the USART's own RTS only
+ *         deasserts when its data register is full, which never happens
+ *         while DMA drains it.
+ */
+#define UART_RTS_GPIO_Port GPIOA
+#define UART_RTS_Pin       GPIO_PIN_1
+#define UART_CTS_GPIO_Port GPIOD
+#define UART_CTS_Pin       GPIO_PIN_3
+
+/**
+ * @brief  Maximum length of a single command line
+ * @note   This is the size of each line buffer in the command pool. Commands
+ *         longer than this will trigger a buffer overflow error and be
+ *         discarded. 64 leaves room for a batch of several ';'-separated
+ *         commands (command_handler.h).
+ */
+#define COMMAND_MAX_LENGTH 64
+
+/**
+ * @brief  Command queue depth (items between UART task and handler)
+ * @note   Pipelining clients keep up to COMMAND_PIPELINE_WINDOW commands
+ *         in flight (command_handler.h), so the depth must be at least the
+ *         window. Items are one-byte pool indices.
+ */
+#ifndef COMMAND_QUEUE_DEPTH
+#define COMMAND_QUEUE_DEPTH 5
+#endif
+
+/**
+ * @brief  Line buffers in the command pool
+ * @note   The UART task assembles a command in place and queues only the
+ *         buffer's index; the handler returns the buffer when done.
+ *         Buffers go round in order: one being filled, COMMAND_QUEUE_DEPTH
+ *         queued and one being executed, so the next one is always free
+ *         once the queue has taken a command.
+ */
+#define COMMAND_POOL_SIZE (COMMAND_QUEUE_DEPTH + 2)
+
+/**
+ * @brief  First byte of a command_queue item that holds a binary frame
+ * @note   Typed commands never start with NUL. A frame item is
+ *         [COMMAND_FRAME_MARKER][payload length][payload...], the payload
+ *         being the decoded request without its CRC (see cmd_frame.h).
+ */
+#define COMMAND_FRAME_MARKER 0x00
+
+/**
+ * @brief  Session mode escape bytes (ASCII Shift Out / Shift In)
+ * @note   SO switches to machine mode, SI back to interactive mode
+ *         (command_handler.h). Echo stops or resumes at the byte itself;
+ *         the menu side switches in order with the queued commands.
+ *         Terminals never send either byte for a key press.
+ */
+#define UART_SESSION_MACHINE      0x0E
+#define UART_SESSION_INTERACTIVE  0x0F
+
+/*============================================================================
+ * Type Definitions
+ *===========================================================================*/
+
+/**
+ * @brief  UART receive statistics
+ *
+ * rx_bytes / rx_events is the average number of bytes handled per
+ * interrupt (1.0 with the old per-byte reception). task_wakeups / commands
+ * is 1 with UART_LINE_DISCIPLINE (N + 1 for an N-character command in
+ * raw mode). task_reads / rx_bytes is the number of stream buffer receive
+ * calls per byte (1.0 with the old one-byte reads). overflow_events should
+ * stay 0 with UART_FLOW_CONTROL; throttle_events counts how often the
+ * sender had to be held off instead. A noisy line shows up in the error
+ * counters and rx_restarts; rx_stalls counts receptions that stayed
+ * stopped until the task's liveness check re-armed them. frames counts
+ * binary command frames passed on; frame_errors those dropped for a bad
+ * CRC, bad encoding or length. pool_in_use counts line buffers handed to
+ * the handler and not yet returned; it drops back to 0 (1 while the
+ * handler prints it) once the handler is idle, otherwise a buffer leaked.
+ * Sample rx_bytes twice over a timed paste to measure throughput at a
+ * given baud rate.
+ */
+typedef struct {
+    uint32_t rx_bytes;           /**< Bytes received by DMA */
+    uint32_t rx_events;          /**< RX interrupts (idle, half and full transfer) */
+    uint32_t rx_dropped;         /**< Bytes lost because the stream buffer was full */
+    uint32_t largest_chunk;      /**< Most bytes delivered by a single interrupt */
+    uint32_t task_wakeups;       /**< Times the UART task unblocked with data */
+    uint32_t task_reads;         /**< Stream buffer receive calls that returned data */
+    uint32_t overflow_events;    /**< RX interrupts that had to drop input */
+    uint32_t throttle_events;    /**< Times the sender was stopped (flow control) */
+    uint32_t queue_stalls;       /**< 100 ms waits for a full command queue */
+    uint32_t parity_errors;      /**< Parity errors (HAL_UART_ERROR_PE) */
+    uint32_t noise_errors;       /**< Noise errors (HAL_UART_ERROR_NE) */
+    uint32_t framing_errors;     /**< Framing errors (HAL_UART_ERROR_FE) */
+    uint32_t overrun_errors;     /**< USART overruns (HAL_UART_ERROR_ORE) */
+    uint32_t dma_errors;         /**< DMA transfer errors (RX or TX) */
+    uint32_t rx_restarts;        /**< Receptions re-armed after an error */
+    uint32_t rearm_failures;     /**< Re-arm attempts refused by HAL */
+    uint32_t rx_stalls;          /**< Stopped receptions found by the liveness check */
+    uint32_t commands;           /**< Complete commands passed to the handler */
+    uint32_t frames;             /**< Binary frames among them */
+    uint32_t frame_errors;       /**< Corrupt or oversized frames dropped */
+    uint32_t pool_in_use;        /**< Line buffers with the handler (queued or running) */
+    uint32_t pool_peak;          /**< Most line buffers with the handler at once */
+} uart_rx_stats_t;
+
+#if UART_RX_TIMING
+/**
+ * @brief  Log2 histogram of one RX timing quantity
+ */
+typedef struct {
+    uint32_t count[UART_RX_TIMING_BUCKETS];  /**< Samples per bucket */
+    uint32_t max;                            /**< Largest sample */
+} uart_rx_histogram_t;
+
+/**
+ * @brief  RX timing histograms (UART_RX_TIMING)
+ *
+ * With circular DMA the CPU never sees single bytes: bytes of a burst
+ * arrive back to back and the USART raises one idle-line interrupt after
+ * the last one (half/full transfer interrupts split long bursts). The
+ * gaps that can be measured are therefore those between bursts. For typed
+ * input every keystroke is a burst, so gap_us is the inter-key time.
+ */
+typedef struct {
+    uart_rx_histogram_t gap_us;       /**< Idle interrupt ending one burst to the
+                                           first interrupt of the next (us) */
+    uart_rx_histogram_t burst_bytes;  /**< Bytes per burst (up to the idle line) */
+    uart_rx_histogram_t wake_cycles;  /**< Data put into an empty stream buffer
+                                           until the task has it (CPU cycles) */
+} uart_rx_timing_t;
+#endif
 
 /*============================================================================
  * FreeRTOS Objects (Global Handles)
@@ -80,14 +329,17 @@ extern "C" {
 /**
  * @brief  Command queue handle
  * @details Queue that passes complete commands from UART task to command
- *          handler task. Depth: 5 commands. Item size: COMMAND_MAX_LENGTH.
- *          Created in uart_task_init().
+ *          handler task as command pool indices (uint8_t, see
+ *          command_buffer()). Depth: COMMAND_QUEUE_DEPTH. Created in
+ *          uart_task_init(). The handler blocks on it directly; no
+ *          separate notification is sent.
  */
 extern QueueHandle_t command_queue;
 
 /**
  * @brief  UART2 peripheral handle
- * @details Configured by STM32CubeMX for 115200 baud, 8N1, no flow control.
+ * @details Configured by STM32CubeMX for 115200 baud, 8N1, no flow control
+ *          (CTS is enabled in user code for UART_FLOW_RTS_CTS).
  *          Hardware: USART2 on PA2 (TX) and PA3 (RX).
  *          Defined in main.c and initialized in MX_USART2_UART_Init().
  */
@@ -103,14 +355,113 @@ extern UART_HandleTypeDef huart2;
  * @retval None
  *
  * Creates:
- * - UART mutex (binary semaphore for thread-safe TX)
- * - Command queue (5 slots × 32 chars each)
+ * - RX stream buffer (UART_STREAM_BUFFER_SIZE bytes, ISR to UART task)
+ * - Command queue (COMMAND_QUEUE_DEPTH slots, one uint8_t pool index each;
+ *   the lines live in COMMAND_POOL_SIZE buffers of COMMAND_MAX_LENGTH)
  * - Command handler task (priority 2, stack 256 words)
+ * - Baud revert timer (UART_BAUD_CONFIRM_MS, one-shot)
+ *
+ * TX needs no lock here: all output goes through the print task.
  *
  * All creation operations use configASSERT() to detect failures.
  */
 void uart_task_init(void);
 
+/**
+ * @brief  Get UART receive statistics
+ * @param  stats: [OUT] Snapshot of the counters
+ * @retval None
+ */
+void uart_get_rx_stats(uart_rx_stats_t *stats);
+
+#if UART_RX_TIMING
+/**
+ * @brief  Get the RX timing histograms
+ * @param  timing: [OUT] Snapshot of the histograms
+ * @retval None
+ */
+void uart_get_rx_timing(uart_rx_timing_t *timing);
+#endif
+
+/**
+ * @brief  Switch USART2 to another rate, pending confirmation
+ * @param  baud: New rate (one of uart_baud.h's supported rates)
+ * @retval BaseType_t: pdPASS if switched, pdFAIL if the rate is not
+ *         supported or beyond the USART's reach
+ *
+ * Announces the switch at the old rate, waits until that text has left
+ * the UART, then reprograms the baud rate register. Unless
+ * uart_baud_confirm() is called within UART_BAUD_CONFIRM_MS, the UART
+ * task restores the rate that was last confirmed. Reception keeps running.
+ *
+ * @note Call from a task (blocks while the print path drains)
+ */
+BaseType_t uart_baud_request(uint32_t baud);
+
+/**
+ * @brief  Keep the rate set by uart_baud_request()
+ * @retval BaseType_t: pdTRUE if a switch was pending, pdFALSE otherwise
+ */
+BaseType_t uart_baud_confirm(void);
+
+/**
+ * @brief  Current USART2 rate
+ * @retval Rate in bit/s
+ */
+uint32_t uart_get_baud(void);
+
+#if UART_AUTOBAUD
+/**
+ * @brief  Auto-baud edge interrupt (EXTI3, falling edge on PA3)
+ * @retval None
+ *
+ * Called from EXTI3_IRQHandler() for the start bit of the first
+ * character. Samples the rest of the character, switches the rate if
+ * needed and starts DMA reception. Disables itself afterwards.
+ */
+void uart_autobaud_irq(void);
+#endif
+
+/**
+ * @brief  Line buffer of a queued command
+ * @param  index: Item received from command_queue
+ * @retval COMMAND_MAX_LENGTH bytes: a NUL-terminated typed command, or a
+ *         decoded frame (COMMAND_FRAME_MARKER item)
+ *
+ * The handler may modify the buffer (trimming, parsing) until it returns
+ * it with command_buffer_release().
+ */
+char *command_buffer(uint8_t index);
+
+/**
+ * @brief  Return a line buffer to the pool after executing its command
+ * @param  index: Item received from command_queue
+ * @retval None
+ *
+ * Buffers must be returned in the order they were received (the handler
+ * executes commands in queue order anyway).
+ */
+void command_buffer_release(uint8_t index);
+
+/**
+ * @brief  Turn the echo of typed input on or off
+ * @param  enable: pdTRUE to echo input and backspace edits
+ * @retval None
+ *
+ * Off in machine mode. The escape bytes switch it from the receive path
+ * directly; the "machine"/"interactive" commands call this.
+ */
+void uart_set_echo(BaseType_t enable);
+
+/**
+ * @brief  Print the receive counters and, with UART_RX_TIMING, the timing
+ *         histograms ("rxstats" command)
+ * @retval None
+ *
+ * Output goes through print_printf(), so it can be called from any task.
+ */
+void uart_print_rx_stats(void);
+
 /**
  * @brief  UART reception task handler (main task loop)
  * @param  parameters: Task parameters (unused, required by FreeRTOS API)
@@ -118,10 +469,10 @@ void uart_task_init(void);
  *
  * Task Behavior:
  * 1. Prints welcome message and main menu on startup
- * 2. Enters infinite loop receiving characters one-by-one
- * 3. Echoes each character back to terminal for user feedback
- * 4. Handles special characters (CR/LF, backspace)
- * 5. Sends complete commands to queue and notifies handler task
+ * 2. Enters infinite loop receiving blocks of up to UART_RX_BLOCK_SIZE bytes
+ * 3. Echoes each run of text back to terminal for user feedback
+ * 4. Handles special characters (CR/LF, backspace) found by line_scan_special()
+ * 5. Queues complete commands (as command pool indices) to the handler task
  *
  * Features:
  * - Character echo (immediate feedback)
@@ -138,13 +489,14 @@ void uart_task_handler(void *parameters);
  * @retval None
  *
  * Displays the top-level menu with application options.
- * Uses uart_mutex to ensure thread-safe transmission.
+ * Queued to the print task like all other output.
  *
  * Menu Options:
  * 1 - LED Patterns (enters LED patterns submenu)
  * 2 - Exit Application (stops all LED patterns)
+ * 3 - Toggle VT100 screen mode
  *
- * @note Can be called from any task - mutex-protected
+ * @note Can be called from any task (print_task.h serializes writers)
  */
 void print_main_menu(void);
 
@@ -125,7 +125,8 @@ void watchdog_feed(watchdog_id_t id);
  * @retval None
  *
  * Optional: Set a callback to be notified when a task fails to feed.
- * If not set, watchdog will print to UART (if print task available).
+ * If not set, watchdog prints an alert on the urgent print lane (or with
+ * polled UART TX if the hung task is the print task itself).
  *
  * Callback signature:
  * void my_callback(watchdog_id_t id, const char *task_name, uint32_t last_feed_ms)
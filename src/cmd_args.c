@@ -0,0 +1,96 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_args.c
+ * @brief          : In-place Tokenizer and Argument Parser for Typed Commands
+ ******************************************************************************
+ * @description
+ * One pass over the line: a word starts at the first non-separator and
+ * ends at the next separator, which is overwritten with NUL. Numbers are
+ * accumulated digit by digit with an overflow check before each step, so
+ * "99999999999" is a range error rather than a wrapped value.
+ ******************************************************************************
+ */
+
+#include "cmd_args.h"
+#include <string.h>
+
+static int cmd_args_is_separator(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+cmd_args_status_t cmd_args_split(char *line, cmd_args_t *args)
+{
+    char *p = line;
+
+    args->argc = 0;
+    for (;;) {
+        while (cmd_args_is_separator(*p)) {
+            p++;
+        }
+        if (*p == '\0') {
+            return CMD_ARGS_OK;
+        }
+        if (args->argc == CMD_ARGS_MAX) {
+            return CMD_ARGS_ERR_COUNT;
+        }
+
+        args->argv[args->argc++] = p;
+        while (*p != '\0' && !cmd_args_is_separator(*p)) {
+            p++;
+        }
+        if (*p == '\0') {
+            return CMD_ARGS_OK;
+        }
+        *p++ = '\0';
+    }
+}
+
+cmd_args_status_t cmd_args_uint(const char *word, uint32_t min, uint32_t max, uint32_t *value)
+{
+    uint32_t result = 0;
+
+    if (*word == '\0') {
+        return CMD_ARGS_ERR_NUMBER;
+    }
+    for (; *word != '\0'; word++) {
+        uint32_t digit = (uint32_t)(*word - '0');
+        if (digit > 9) {
+            return CMD_ARGS_ERR_NUMBER;
+        }
+        if (result > (UINT32_MAX - digit) / 10) {
+            return CMD_ARGS_ERR_RANGE;  // Would not fit 32 bits
+        }
+        result = result * 10 + digit;
+    }
+
+    if (result < min || result > max) {
+        return CMD_ARGS_ERR_RANGE;
+    }
+    *value = result;
+    return CMD_ARGS_OK;
+}
+
+cmd_args_status_t cmd_args_keyword(const char *word, const char *const *keywords,
+                                   size_t count, size_t *index)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(word, keywords[i]) == 0) {
+            *index = i;
+            return CMD_ARGS_OK;
+        }
+    }
+    return CMD_ARGS_ERR_KEYWORD;
+}
+
+const char *cmd_args_error_text(cmd_args_status_t status)
+{
+    switch (status) {
+        case CMD_ARGS_OK:           return "OK";
+        case CMD_ARGS_ERR_COUNT:    return "Wrong number of arguments";
+        case CMD_ARGS_ERR_NUMBER:   return "Not a number";
+        case CMD_ARGS_ERR_RANGE:    return "Number out of range";
+        case CMD_ARGS_ERR_KEYWORD:  return "Unknown name";
+        default:                    return "Invalid arguments";
+    }
+}
@@ -0,0 +1,157 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_frame.c
+ * @brief          : Binary Command Frames (COBS + CRC-16)
+ ******************************************************************************
+ * @description
+ * COBS (Consistent Overhead Byte Stuffing) splits the data at every 0x00
+ * and replaces each zero with a code byte holding the distance to the
+ * next one; a run of 254 non-zero bytes gets a 0xFF code and no implied
+ * zero. The CRC uses a 16-entry nibble table (32 bytes of flash, two
+ * lookups per byte) instead of the 512-byte byte table.
+ ******************************************************************************
+ */
+
+#include "cmd_frame.h"
+
+/* CRC-16/CCITT-FALSE remainders for one nibble */
+static const uint16_t crc16_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+uint16_t cmd_frame_crc16(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (size_t i = 0; i < length; i++) {
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+size_t cmd_frame_cobs_encode(const uint8_t *src, size_t length, uint8_t *dst, size_t capacity)
+{
+    size_t code_pos = 0;    // Where the current block's code byte goes
+    size_t out = 1;
+    uint8_t code = 1;
+
+    if (capacity == 0) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        if (src[i] != 0) {
+            if (out >= capacity) {
+                return 0;
+            }
+            dst[out++] = src[i];
+            code++;
+        }
+
+        // Close the block at a zero, or when it is full (254 data bytes)
+        if (src[i] == 0 || code == 0xFF) {
+            dst[code_pos] = code;
+            code = 1;
+            code_pos = out;
+            if (src[i] == 0 || i + 1 < length) {
+                if (out >= capacity) {
+                    return 0;
+                }
+                out++;
+            }
+        }
+    }
+
+    if (code_pos < out) {
+        dst[code_pos] = code;
+    }
+    return out;
+}
+
+size_t cmd_frame_cobs_decode(const uint8_t *src, size_t length, uint8_t *dst, size_t capacity)
+{
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < length) {
+        uint8_t code = src[in++];
+
+        if (code == 0 || in + code - 1 > length) {
+            return 0;   // Delimiter inside the frame, or block runs past the end
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            if (src[in] == 0 || out >= capacity) {
+                return 0;
+            }
+            dst[out++] = src[in++];
+        }
+
+        // Every block but the last (and a full one) ends in an implied zero
+        if (code != 0xFF && in < length) {
+            if (out >= capacity) {
+                return 0;
+            }
+            dst[out++] = 0;
+        }
+    }
+    return out;
+}
+
+size_t cmd_frame_encode(const uint8_t *payload, size_t length, uint8_t *dst, size_t capacity)
+{
+    uint8_t raw[CMD_FRAME_MAX_PAYLOAD + CMD_FRAME_CRC_SIZE];
+
+    if (length > CMD_FRAME_MAX_PAYLOAD || capacity < 3) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        raw[i] = payload[i];
+    }
+    uint16_t crc = cmd_frame_crc16(payload, length);
+    raw[length] = (uint8_t)(crc & 0xFF);
+    raw[length + 1] = (uint8_t)(crc >> 8);
+
+    size_t encoded = cmd_frame_cobs_encode(raw, length + CMD_FRAME_CRC_SIZE,
+                                           &dst[1], capacity - 2);
+    if (encoded == 0) {
+        return 0;
+    }
+
+    dst[0] = CMD_FRAME_DELIMITER;
+    dst[encoded + 1] = CMD_FRAME_DELIMITER;
+    return encoded + 2;
+}
+
+cmd_frame_status_t cmd_frame_decode(const uint8_t *encoded, size_t length,
+                                    uint8_t *payload, size_t *payload_length)
+{
+    uint8_t raw[CMD_FRAME_MAX_PAYLOAD + CMD_FRAME_CRC_SIZE];
+
+    *payload_length = 0;
+    if (length > CMD_FRAME_MAX_ENCODED) {
+        return CMD_FRAME_ERR_LENGTH;
+    }
+
+    size_t decoded = cmd_frame_cobs_decode(encoded, length, raw, sizeof(raw));
+    if (decoded == 0) {
+        return CMD_FRAME_ERR_COBS;
+    }
+    if (decoded < CMD_FRAME_CRC_SIZE + 2) {
+        return CMD_FRAME_ERR_LENGTH;    // Opcode and sequence are mandatory
+    }
+
+    size_t n = decoded - CMD_FRAME_CRC_SIZE;
+    uint16_t crc = (uint16_t)(raw[n] | (raw[n + 1] << 8));
+    if (crc != cmd_frame_crc16(raw, n)) {
+        return CMD_FRAME_ERR_CRC;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        payload[i] = raw[i];
+    }
+    *payload_length = n;
+    return CMD_FRAME_OK;
+}
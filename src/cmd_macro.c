@@ -0,0 +1,158 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_macro.c
+ * @brief          : Recorded Command Macros (Named Step Lists in RAM)
+ ******************************************************************************
+ * @description
+ * Arena layout: the macros' step texts lie back to back from the start of
+ * storage, "step\0step\0...", in no particular slot order. A new
+ * recording appends at store->used. Deleting a macro memmove()s the text
+ * behind it down and shifts the offsets of the macros it passed.
+ ******************************************************************************
+ */
+
+#include "cmd_macro.h"
+#include <string.h>
+
+static int cmd_macro_name_valid(const char *name)
+{
+    size_t length = 0;
+
+    for (; name[length] != '\0'; length++) {
+        char c = name[length];
+        if (length == CMD_MACRO_NAME_MAX ||
+            !((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+              (c >= '0' && c <= '9') || c == '_' || c == '-')) {
+            return 0;
+        }
+    }
+    return length > 0;
+}
+
+void cmd_macro_init(cmd_macro_store_t *store)
+{
+    memset(store, 0, sizeof(*store));
+    store->recording = -1;
+}
+
+cmd_macro_status_t cmd_macro_record(cmd_macro_store_t *store, const char *name)
+{
+    if (store->recording >= 0) {
+        return CMD_MACRO_ERR_RECORDING;
+    }
+    if (!cmd_macro_name_valid(name)) {
+        return CMD_MACRO_ERR_NAME;
+    }
+    (void)cmd_macro_delete(store, name);    // Re-recording replaces it
+
+    for (int slot = 0; slot < CMD_MACRO_SLOTS; slot++) {
+        cmd_macro_slot_t *macro = &store->slots[slot];
+        if (macro->name[0] == '\0') {
+            strcpy(macro->name, name);
+            macro->offset = store->used;
+            macro->length = 0;
+            macro->steps = 0;
+            store->recording = (int8_t)slot;
+            return CMD_MACRO_OK;
+        }
+    }
+    return CMD_MACRO_ERR_SLOTS;
+}
+
+cmd_macro_status_t cmd_macro_append(cmd_macro_store_t *store, const char *step)
+{
+    if (store->recording < 0) {
+        return CMD_MACRO_ERR_IDLE;
+    }
+
+    size_t length = strlen(step) + 1;
+    if (length > (size_t)(CMD_MACRO_STORAGE - store->used)) {
+        return CMD_MACRO_ERR_FULL;
+    }
+
+    // The recording is the last macro in the arena, so it grows in place
+    cmd_macro_slot_t *macro = &store->slots[store->recording];
+    memcpy(&store->storage[store->used], step, length);
+    store->used += (uint16_t)length;
+    macro->length += (uint16_t)length;
+    macro->steps++;
+    return CMD_MACRO_OK;
+}
+
+cmd_macro_status_t cmd_macro_end(cmd_macro_store_t *store)
+{
+    if (store->recording < 0) {
+        return CMD_MACRO_ERR_IDLE;
+    }
+
+    cmd_macro_slot_t *macro = &store->slots[store->recording];
+    store->recording = -1;
+    if (macro->steps == 0) {
+        macro->name[0] = '\0';
+        return CMD_MACRO_ERR_EMPTY;
+    }
+    return CMD_MACRO_OK;
+}
+
+const char *cmd_macro_recording(const cmd_macro_store_t *store)
+{
+    return (store->recording >= 0) ? store->slots[store->recording].name : NULL;
+}
+
+int cmd_macro_find(const cmd_macro_store_t *store, const char *name)
+{
+    for (int slot = 0; slot < CMD_MACRO_SLOTS; slot++) {
+        if (slot != store->recording && store->slots[slot].name[0] != '\0' &&
+            strcmp(store->slots[slot].name, name) == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+cmd_macro_status_t cmd_macro_delete(cmd_macro_store_t *store, const char *name)
+{
+    int slot = cmd_macro_find(store, name);
+    if (slot < 0) {
+        return CMD_MACRO_ERR_UNKNOWN;
+    }
+
+    cmd_macro_slot_t *macro = &store->slots[slot];
+    uint16_t end = macro->offset + macro->length;
+
+    memmove(&store->storage[macro->offset], &store->storage[end], store->used - end);
+    store->used -= macro->length;
+    for (int other = 0; other < CMD_MACRO_SLOTS; other++) {
+        if (store->slots[other].name[0] != '\0' && store->slots[other].offset >= end) {
+            store->slots[other].offset -= macro->length;
+        }
+    }
+    macro->name[0] = '\0';
+    return CMD_MACRO_OK;
+}
+
+const char *cmd_macro_next(const cmd_macro_store_t *store, int slot, const char *step)
+{
+    const cmd_macro_slot_t *macro = &store->slots[slot];
+
+    if (step == NULL) {
+        return (macro->steps > 0) ? &store->storage[macro->offset] : NULL;
+    }
+    step += strlen(step) + 1;
+    return (step < &store->storage[macro->offset + macro->length]) ? step : NULL;
+}
+
+const char *cmd_macro_error_text(cmd_macro_status_t status)
+{
+    switch (status) {
+        case CMD_MACRO_OK:          return "OK";
+        case CMD_MACRO_ERR_NAME:    return "Bad macro name (1-8 of a-z 0-9 _ -)";
+        case CMD_MACRO_ERR_SLOTS:   return "No free macro slot";
+        case CMD_MACRO_ERR_FULL:    return "Macro storage full";
+        case CMD_MACRO_ERR_UNKNOWN: return "No such macro";
+        case CMD_MACRO_ERR_EMPTY:   return "Nothing recorded";
+        case CMD_MACRO_ERR_RECORDING: return "Already recording";
+        case CMD_MACRO_ERR_IDLE:    return "Not recording";
+        default:                    return "Macro error";
+    }
+}
@@ -0,0 +1,44 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_pool.c
+ * @brief          : Command Line Buffer Pool (index bookkeeping)
+ ******************************************************************************
+ * @description
+ * Buffers are handed over and returned in the same order, so the index
+ * of a buffer follows from how many went before it and no free list is
+ * needed. The peak shows how close a command flood came to the pool size.
+ ******************************************************************************
+ */
+
+#include "cmd_pool.h"
+
+uint8_t cmd_pool_fill_index(const cmd_pool_t *pool)
+{
+    return (uint8_t)(pool->submitted % pool->size);
+}
+
+uint32_t cmd_pool_in_use(const cmd_pool_t *pool)
+{
+    return pool->submitted - pool->released;
+}
+
+int cmd_pool_submit(cmd_pool_t *pool)
+{
+    pool->submitted++;
+
+    uint32_t in_use = cmd_pool_in_use(pool);
+    if (in_use > pool->peak) {
+        pool->peak = in_use;
+    }
+    // The buffer filled next must not be one still out
+    return in_use < pool->size;
+}
+
+int cmd_pool_release(cmd_pool_t *pool, uint8_t index)
+{
+    if (cmd_pool_in_use(pool) == 0 || index != pool->released % pool->size) {
+        return 0;
+    }
+    pool->released++;
+    return 1;
+}
@@ -10,7 +10,7 @@
  * Menu Structure:
  * ┌─────────────┐
  * │  Main Menu  │  (1: LED Patterns, 2: Exit)
- * └─────────────┘
+ * └─────────────┘  (3: Toggle VT100 screen mode)
  *        │
  *        ├─ Option 1 ──> ┌────────────────────┐
  *        │                │ LED Patterns Menu  │
@@ -23,14 +23,93 @@
  *        │
  *        └─ Option 2 ──> Stop LEDs & stay in main menu
  *
+ * The menus, their options and their text are generated from one table,
+ * MENU_TREE in menu_table.h. An option digit indexes the current menu's
+ * option table directly (no strcmp chain).
+ *
  * Command Processing:
  * - All commands are trimmed and converted to lowercase
  * - Invalid commands display error and redisplay current menu
  * - Valid commands execute action and print confirmation
  * - Menu redisplays after every command (except return to main)
  *
+ * Screen Modes:
+ * - Plain (default): every LED menu command reprints the whole menu plus
+ *   a confirmation line (~370 bytes, ~32 ms @ 115200 baud)
+ * - VT100: the LED menu is drawn once on entry. Each command then only
+ *   moves the '>' marker, rewrites the status field and clears the typed
+ *   input at the saved prompt position (30-40 bytes, ~3 ms)
+ * - Invalid input in VT100 mode redraws the full screen, which also
+ *   repairs it after unrelated output (e.g. a watchdog alert)
+ *
+ * Commands in Every Menu:
+ * - "rxstats": receive counters and, with UART_RX_TIMING, the RX timing
+ *   histograms
+ * - "baud <rate>": switch USART2 to 9600 ... 2000000 baud; "ok" at the
+ *   new rate keeps it, otherwise it reverts after UART_BAUD_CONFIRM_MS.
+ *   "baud" alone shows the current rate
+ * - "machine" / "interactive": session mode (see below)
+ * - "pattern <0-3>": select an LED pattern by number (0 = off)
+ * - "status": current pattern and menu number
+ * - "blink <green|orange> <period_ms>": toggle period of one LED
+ *   (10-10000 ms); "duty <green|orange> <percent>": its ON share (0-100)
+ * - "delay <ms>" and "macro ...": see Macros below
+ * - These are looked up by their first word in global_commands[]; the
+ *   words are split in place in the command buffer (cmd_args.h), so a
+ *   wrong count, a bad number or an unknown LED name is reported with
+ *   the command's usage line
+ * - The current menu is shown again afterwards
+ *
+ * Batches:
+ * - "1;2;pattern 3;status" runs the commands in order as one line, with
+ *   one summary ("Batch: 4 commands ok") and one menu at the end. The
+ *   batch stops at the first invalid command
+ * - A leading '!' makes the batch atomic: LED changes are staged and
+ *   applied together at the end (led_effects_batch_commit()), or not at
+ *   all if a command fails, in which case the menu position is kept too
+ * - A batch counts as one command for "@<seq>" acks and machine mode
+ *
+ * Macros:
+ * - After "macro record <name>" each line (batch lines included) is
+ *   stored in macro_store (cmd_macro.h) instead of run, until "macro
+ *   end". Only "macro ..." lines are still interpreted
+ * - "macro run <name> [repeat <n>]" replays the steps through
+ *   dispatch_line() with menu output off and one summary at the end. It
+ *   stops at the first invalid step or when new input is queued
+ * - "delay <ms>" waits. In a replay the deadlines follow on from each
+ *   other (deadline += ms), so step run times do not shift the schedule
+ * - Counts as one command for acks and machine mode; no "macro" commands
+ *   inside a batch or a replay
+ *
+ * Sequenced Commands:
+ * - "@<seq> <command>" is executed like <command> with menu output off
+ *   (menus, confirmations and VT100 updates) and answered with one
+ *   "ack <seq> ok|invalid" line, so a client can keep several commands in
+ *   flight instead of waiting for each menu reprint
+ * - Commands are executed in queue order, so acks arrive in send order
+ * - A malformed prefix is an ordinary invalid command
+ *
+ * Machine Mode (scripted clients):
+ * - Entered with "machine" or the SO byte (0x0E), left with "interactive"
+ *   or SI (0x0F). Interactive is the default after reset
+ * - Input is not echoed, and menus, confirmations and banners are off.
+ *   Every command is answered with one line: "ok" or "invalid", or
+ *   "ack <seq> ok|invalid" for a sequenced command (no leading CR LF,
+ *   as nothing was echoed). "2" in the LED menu costs 4 bytes instead of
+ *   ~370
+ * - Commands that report data (rxstats, baud) still print it, followed
+ *   by the status line
+ * - Leaving machine mode shows the current menu again
+ *
+ * Binary Frames (cmd_frame.h):
+ * - Queue items starting with COMMAND_FRAME_MARKER are decoded frames
+ *   from a scripted client. They are executed without touching the menu
+ *   state and answered with a single response frame (no menu, no text)
+ * - LED changes made by frames are still shown by the next menu redraw
+ *
  * Thread Safety:
- * - All UART transmissions use print_message() via print task
+ * - All UART transmissions go through the print task (print_const() for
+ *   literals, which queues only a pointer)
  * - Menu state is only modified by command handler task (no protection needed)
  ******************************************************************************
  */
@@ -39,14 +118,137 @@
 #include "uart_task.h"
 #include "led_effects.h"
 #include "print_task.h"
+#include "print_log.h"
 #include "watchdog.h"
-#include <string.h>
+#include "cmd_frame.h"
+#include "cmd_args.h"
+#include "cmd_macro.h"
+#include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
 #include <ctype.h>
 
 /* Current menu state (state machine variable) */
 static MenuState_t current_menu_state = MENU_MAIN;
 
+/* VT100 screen mode (incremental LED menu redraw) */
+static BaseType_t vt100_mode = COMMAND_VT100_DEFAULT ? pdTRUE : pdFALSE;
+
+/* Menus and confirmations are printed (off while a sequenced command runs) */
+static BaseType_t menu_output = pdTRUE;
+
+/* Machine mode: no echo, menus or banners; one status line per command */
+static BaseType_t machine_mode = pdFALSE;
+
+/* Active LED pattern (reported to binary clients) */
+static LED_Pattern_t led_pattern = LED_PATTERN_NONE;
+
+/* Handler's watchdog slot (also fed during long macros and delays) */
+static watchdog_id_t handler_wd_id = WATCHDOG_INVALID_ID;
+
+/* Recorded macros (RAM only, empty after reset) */
+static cmd_macro_store_t macro_store;
+
+/* A batch or a macro replay is running (no "macro" commands inside) */
+static BaseType_t batch_running = pdFALSE;
+static BaseType_t macro_replaying = pdFALSE;
+
+/* Deadline of the last "delay"; replays anchor each delay to it */
+static TickType_t delay_deadline;
+
+/*============================================================================
+ * Menu Tables (generated from MENU_TREE, menu_table.h)
+ *===========================================================================*/
+
+typedef struct menu_option menu_option_t;
+
+/** Option handler; gets its own table entry (for the PATTERN fields) */
+typedef command_status_t (*menu_handler_t)(const menu_option_t *option);
+
+/** One option slot, indexed by the option digit */
+struct menu_option {
+    menu_handler_t handler;     /**< NULL: no option with this digit */
+    LED_Pattern_t pattern;      /**< PATTERN entries: pattern to select */
+    const char *message;        /**< PATTERN entries: plain-mode confirmation */
+    const char *status;         /**< PATTERN entries: VT100 status field */
+};
+
+/** One menu: its plain-mode text and its option slots */
+typedef struct {
+    const char *text;
+    const menu_option_t *options;
+} menu_t;
+
+#define MENU_IGNORE(...)
+
+/* Handler prototypes */
+#define MENU_HANDLER_PROTOTYPE(key, label, handler) \
+    static command_status_t handler(const menu_option_t *option);
+#define MENU_PROTOTYPES(state, title, options) options(MENU_HANDLER_PROTOTYPE, MENU_IGNORE)
+MENU_TREE(MENU_PROTOTYPES)
+static command_status_t menu_select_pattern(const menu_option_t *option);
+
+/* Option slots per menu (<state>_options), unused digits stay NULL */
+#define MENU_SLOT_OPTION(key, label, handler) \
+    [key] = { handler, LED_PATTERN_NONE, NULL, NULL },
+#define MENU_SLOT_PATTERN(key, label, pattern, message, status) \
+    [key] = { menu_select_pattern, pattern, "\r\n" message "\r\n", status },
+#define MENU_OPTION_TABLE(state, title, options) \
+    static const menu_option_t state##_options[MENU_MAX_OPTIONS] = { \
+        options(MENU_SLOT_OPTION, MENU_SLOT_PATTERN) \
+    };
+MENU_TREE(MENU_OPTION_TABLE)
+
+/* All menus, indexed by MenuState_t */
+#define MENU_ENTRY(state, title, options) \
+    [state] = { MENU_PLAIN_TEXT(title, options), state##_options },
+static const menu_t menus[MENU_STATE_COUNT] = {
+    MENU_TREE(MENU_ENTRY)
+};
+
+/*
+ * VT100 LED menu layout (rows are 1-based screen lines after ESC[2J)
+ * The prompt position is saved with ESC 7 at the end of the frame and
+ * restored with ESC 8 after every update.
+ */
+#define VT100_OPTION_ROW      4     // First option line of MENU_VT100_TEXT
+#define VT100_STATUS_COL      9     // First column after "Status: "
+
+/* Display line of each LED menu option (LED_LINE_<key>) */
+#define LED_LINE_ENUM(key, ...) LED_LINE_##key,
+enum { MENU_LED_OPTIONS(LED_LINE_ENUM, LED_LINE_ENUM) LED_LINE_COUNT };
+
+#define VT100_STATUS_ROW (VT100_OPTION_ROW + LED_LINE_COUNT + 1)    // Below the closing rule
+
+/* Screen row of the option that selects each pattern */
+#define LED_PATTERN_ROW(key, label, pattern, message, status) \
+    [pattern] = VT100_OPTION_ROW + LED_LINE_##key,
+static const uint8_t led_pattern_rows[] = {
+    MENU_LED_OPTIONS(MENU_IGNORE, LED_PATTERN_ROW)
+};
+
+/* Patterns the LED menu offers: 0 ... LED_PATTERN_COUNT - 1 */
+#define LED_PATTERN_COUNT sizeof(led_pattern_rows)
+
+/* Plain-mode confirmation of each pattern */
+#define LED_PATTERN_MESSAGE(key, label, pattern, message, status) \
+    [pattern] = "\r\n" message "\r\n",
+static const char *const led_pattern_messages[LED_PATTERN_COUNT] = {
+    MENU_LED_OPTIONS(MENU_IGNORE, LED_PATTERN_MESSAGE)
+};
+
+/* Row of the '>' marker currently on screen (0 = none drawn yet) */
+static uint8_t vt100_marker_row = 0;
+
+#if CMD_FRAME_MAX_WIRE > PRINT_BINARY_MAX_SIZE
+#error "PRINT_BINARY_MAX_SIZE must hold a complete response frame"
+#endif
+
+#if COMMAND_PIPELINE_WINDOW < 1 || COMMAND_PIPELINE_WINDOW > COMMAND_QUEUE_DEPTH
+#error "COMMAND_PIPELINE_WINDOW must be between 1 and COMMAND_QUEUE_DEPTH"
+#endif
+
 static void to_lowercase(char *str)
 {
     for (int i = 0; str[i]; i++) {
@@ -76,134 +278,1004 @@ MenuState_t get_menu_state(void)
     return current_menu_state;
 }
 
-static void print_led_patterns_menu(void)
+/**
+ * @brief  Feed the handler's watchdog slot
+ */
+static void feed_watchdog(void)
+{
+    if (handler_wd_id != WATCHDOG_INVALID_ID) {
+        watchdog_feed(handler_wd_id);
+    }
+}
+
+/**
+ * @brief  Switch the LED pattern and remember it for the menus
+ * @param  pattern: New pattern
+ */
+static void set_led_pattern(LED_Pattern_t pattern)
 {
-    const char *menu =
-        "\r\n========================================\r\n"
-        "        LED Pattern Selection\r\n"
-        "========================================\r\n"
-        "  0 - Return to main menu\r\n"
-        "  1 - All LEDs ON\r\n"
-        "  2 - Different Frequency Blinking\r\n"
-        "  3 - Same Frequency Blinking\r\n"
-        "  4 - All LEDs OFF\r\n"
-        "========================================\r\n"
-        "Enter selection: ";
+    led_effects_set_pattern(pattern);
+    led_pattern = pattern;
+}
 
-    print_message(menu);
+/**
+ * @brief  Print a menu literal unless menu output is off
+ */
+static void menu_print(const char *text)
+{
+    if (menu_output) {
+        print_const(text);
+    }
 }
 
-static void process_main_menu_command(char *command)
+/**
+ * @brief  Format now and queue a copy of the text
+ * @param  format: printf-style format
+ *
+ * For %s arguments that do not outlive the call: print_printf() reads
+ * them later, in the print task, but the command line buffer is handed
+ * back and the macro store may be compacted by the next command.
+ */
+static void print_copy(const char *format, ...)
+{
+    char message[COMMAND_MAX_LENGTH + 64];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    print_message(message);
+}
+
+/**
+ * @brief  Print the current menu (plain text) unless menu output is off
+ */
+static void show_current_menu(void)
 {
-    char response[128];
+    menu_print(menus[current_menu_state].text);
+}
 
-    if (strcmp(command, "1") == 0) {
-        // Enter LED patterns menu
-        current_menu_state = MENU_LED_PATTERNS;
-        print_led_patterns_menu();
+/**
+ * @brief  Draw the full VT100 LED menu screen
+ * @param  status: Status field text (string literal)
+ */
+static void vt100_draw_led_patterns_menu(const char *status)
+{
+    if (!menu_output) {
+        return;
+    }
+
+    // Same layout as the plain menu, anchored at the top of a clear screen
+    print_const(MENU_VT100_TEXT(MENU_LED_TITLE, MENU_LED_OPTIONS));
+
+    uint8_t marker_row = led_pattern_rows[led_pattern];
+    print_printf("\x1b[%u;1H>\x1b[%u;%uH%s\x1b[K\x1b" "8",
+                 marker_row, VT100_STATUS_ROW, VT100_STATUS_COL, status);
+    vt100_marker_row = marker_row;
+}
+
+/**
+ * @brief  Update only the changed fields of the VT100 LED menu
+ * @param  status: Status field text (string literal, max 10 characters)
+ *
+ * Moves the marker (if the pattern changed), overwrites the status field
+ * and returns to the saved prompt, erasing the echoed input. Sequenced
+ * commands skip the updates; the marker catches up on the next one.
+ */
+static void vt100_update_led_patterns_menu(const char *status)
+{
+    if (!menu_output) {
+        return;
     }
-    else if (strcmp(command, "2") == 0) {
-        // Exit application - stop all LED patterns
-        led_effects_set_pattern(LED_PATTERN_NONE);
-        snprintf(response, sizeof(response), "\r\nApplication exited. All LEDs turned OFF.\r\n");
-        print_message(response);
-        print_main_menu();
+    if (vt100_marker_row == 0) {
+        // Menu not on screen (entered by a sequenced command, or scrolled
+        // away by other output)
+        vt100_draw_led_patterns_menu(status);
+        return;
     }
-    else {
-        snprintf(response, sizeof(response), "\r\nInvalid option. Please try again.\r\n");
-        print_message(response);
-        print_main_menu();
+
+    uint8_t marker_row = led_pattern_rows[led_pattern];
+    if (vt100_marker_row != marker_row) {
+        print_printf("\x1b[%u;1H \x1b[%u;1H>", vt100_marker_row, marker_row);
+        vt100_marker_row = marker_row;
+    }
+
+    print_printf("\x1b[%u;%uH%s\x1b[K\x1b" "8\x1b[K",
+                 VT100_STATUS_ROW, VT100_STATUS_COL, status);
+}
+
+/**
+ * @brief  Show the current menu after an invalid option
+ * @retval COMMAND_INVALID
+ */
+static command_status_t report_invalid_option(void)
+{
+    if (vt100_mode && current_menu_state == MENU_LED_PATTERNS) {
+        // Full redraw also repairs the screen after unrelated output
+        vt100_draw_led_patterns_menu("INVALID");
+    } else {
+        menu_print("\r\nInvalid option. Please try again.\r\n");
+        show_current_menu();
     }
+    return COMMAND_INVALID;
 }
 
-static void process_led_patterns_menu_command(char *command)
+static command_status_t menu_enter_led_patterns(const menu_option_t *option)
 {
-    char response[128];
+    (void)option;
+    current_menu_state = MENU_LED_PATTERNS;
+    if (vt100_mode) {
+        vt100_draw_led_patterns_menu("");
+    } else {
+        show_current_menu();
+    }
+    return COMMAND_OK;
+}
+
+static command_status_t menu_exit_application(const menu_option_t *option)
+{
+    (void)option;
+    // Exit application - stop all LED patterns
+    set_led_pattern(LED_PATTERN_NONE);
+    menu_print("\r\nApplication exited. All LEDs turned OFF.\r\n");
+    show_current_menu();
+    return COMMAND_OK;
+}
+
+static command_status_t menu_toggle_vt100(const menu_option_t *option)
+{
+    (void)option;
+    // Toggle screen mode (plain is the fallback for dumb terminals)
+    vt100_mode = !vt100_mode;
+    menu_print(vt100_mode ? "\r\nVT100 screen mode ON\r\n"
+                          : "\r\nVT100 screen mode OFF (plain)\r\n");
+    show_current_menu();
+    return COMMAND_OK;
+}
+
+static command_status_t menu_return_main(const menu_option_t *option)
+{
+    (void)option;
+    current_menu_state = MENU_MAIN;
+    show_current_menu();
+    return COMMAND_OK;
+}
+
+/**
+ * @brief  Report the result of an LED menu command
+ * @param  message: Confirmation line (plain mode)
+ * @param  status: Status field text (VT100 mode, max 10 characters)
+ *
+ * Plain mode reprints the confirmation and the whole menu; VT100 mode
+ * rewrites only the fields that changed.
+ */
+static void report_led_patterns_command(const char *message, const char *status)
+{
+    if (vt100_mode) {
+        vt100_update_led_patterns_menu(status);
+    } else {
+        menu_print(message);
+        show_current_menu();
+    }
+}
+
+static command_status_t menu_select_pattern(const menu_option_t *option)
+{
+    set_led_pattern(option->pattern);
+    report_led_patterns_command(option->message, option->status);
+    return COMMAND_OK;
+}
+
+/**
+ * @brief  Split a "@<seq> <command>" prefix off a trimmed command
+ * @param  command: Trimmed command string
+ * @param  seq: [OUT] Sequence number
+ * @retval The command after the prefix, or NULL if there is no valid prefix
+ */
+static char *parse_sequence(char *command, uint16_t *seq)
+{
+    char *end;
+
+    if (command[0] != COMMAND_SEQ_PREFIX || !isdigit((unsigned char)command[1])) {
+        return NULL;
+    }
+    unsigned long value = strtoul(&command[1], &end, 10);
+    if (value > 0xFFFF || !isspace((unsigned char)*end)) {
+        return NULL;    // Out of range, or no separator before the command
+    }
+
+    while (isspace((unsigned char)*end)) end++;
+    *seq = (uint16_t)value;
+    return end;
+}
+
+/*============================================================================
+ * Commands Valid in Every Menu ("<name> [<argument>...]")
+ *===========================================================================*/
+
+typedef struct global_command global_command_t;
+
+/** Command handler; the words are already counted against the table */
+typedef command_status_t (*global_handler_t)(const global_command_t *command,
+                                             const cmd_args_t *args);
+
+struct global_command {
+    const char *name;
+    uint8_t min_args;           /**< Arguments after the name */
+    uint8_t max_args;
+    const char *usage;          /**< Shown after an argument error */
+    global_handler_t handler;
+};
+
+/* LED names for blink/duty, indexed by led_id_t */
+static const char *const led_names[LED_ID_COUNT] = {
+    [LED_ID_GREEN] = "green",
+    [LED_ID_ORANGE] = "orange",
+};
+
+/**
+ * @brief  Explain an argument error
+ * @param  command: Table entry of the command
+ * @param  error: What was wrong
+ * @retval COMMAND_INVALID
+ */
+static command_status_t report_usage(const global_command_t *command, cmd_args_status_t error)
+{
+    if (menu_output) {
+        print_printf("\r\n%s. Usage: %s\r\n", cmd_args_error_text(error), command->usage);
+    }
+    return COMMAND_INVALID;
+}
+
+static command_status_t command_rxstats(const global_command_t *command, const cmd_args_t *args)
+{
+    (void)command;
+    (void)args;
+    uart_print_rx_stats();
+    return COMMAND_OK;
+}
+
+static command_status_t command_baud(const global_command_t *command, const cmd_args_t *args)
+{
+    uint32_t baud;
+
+    if (args->argc == 1) {
+        print_printf("\r\nBaud rate: %lu\r\n", uart_get_baud());
+        return COMMAND_OK;
+    }
+
+    // Range check only; uart_baud_request() accepts the listed rates
+    cmd_args_status_t error = cmd_args_uint(args->argv[1], 9600, 2000000, &baud);
+    if (error != CMD_ARGS_OK) {
+        return report_usage(command, error);
+    }
+    if (uart_baud_request(baud) != pdPASS) {
+        menu_print("\r\nUnsupported baud rate (9600 ... 2000000)\r\n");
+        return COMMAND_INVALID;
+    }
+    return COMMAND_OK;
+}
+
+static command_status_t command_ok(const global_command_t *command, const cmd_args_t *args)
+{
+    (void)command;
+    (void)args;
+    if (!uart_baud_confirm()) {
+        menu_print("\r\nNo baud rate change to confirm\r\n");
+        return COMMAND_INVALID;
+    }
+    print_printf("\r\nBaud rate %lu confirmed\r\n", uart_get_baud());
+    return COMMAND_OK;
+}
+
+static command_status_t command_machine(const global_command_t *command, const cmd_args_t *args)
+{
+    (void)command;
+    (void)args;
+    machine_mode = pdTRUE;
+    menu_output = pdFALSE;      // Not even for this command
+    vt100_marker_row = 0;       // Screen contents are unknown on return
+    uart_set_echo(pdFALSE);
+    return COMMAND_OK;
+}
+
+static command_status_t command_interactive(const global_command_t *command, const cmd_args_t *args)
+{
+    (void)command;
+    (void)args;
+    machine_mode = pdFALSE;
+    menu_output = pdTRUE;       // The menu below is the reply
+    uart_set_echo(pdTRUE);
+    print_const("\r\nInteractive mode\r\n");
+    return COMMAND_OK;
+}
+
+static command_status_t command_status(const global_command_t *command, const cmd_args_t *args)
+{
+    (void)command;
+    (void)args;
+    // Same fields as the CMD_OP_GET_STATUS response
+    print_printf("\r\nStatus: pattern %u, menu %u\r\n",
+                 (unsigned)led_pattern, (unsigned)current_menu_state);
+    return COMMAND_OK;
+}
+
+static command_status_t command_pattern(const global_command_t *command, const cmd_args_t *args)
+{
+    uint32_t pattern;
+
+    cmd_args_status_t error = cmd_args_uint(args->argv[1], 0, LED_PATTERN_COUNT - 1, &pattern);
+    if (error != CMD_ARGS_OK) {
+        return report_usage(command, error);
+    }
+    set_led_pattern((LED_Pattern_t)pattern);
+    menu_print(led_pattern_messages[pattern]);
+    return COMMAND_OK;
+}
+
+/**
+ * @brief  Parse "<led> <number>" for blink and duty
+ * @param  args: Command words (argv[1] = LED name, argv[2] = number)
+ * @param  min: Smallest allowed number
+ * @param  max: Largest allowed number
+ * @param  led: [OUT] LED
+ * @param  value: [OUT] Number
+ * @retval CMD_ARGS_OK or the first error
+ */
+static cmd_args_status_t parse_led_value(const cmd_args_t *args, uint32_t min, uint32_t max,
+                                         led_id_t *led, uint32_t *value)
+{
+    size_t index;
+
+    cmd_args_status_t error = cmd_args_keyword(args->argv[1], led_names, LED_ID_COUNT, &index);
+    if (error != CMD_ARGS_OK) {
+        return error;
+    }
+    *led = (led_id_t)index;
+    return cmd_args_uint(args->argv[2], min, max, value);
+}
+
+static command_status_t command_blink(const global_command_t *command, const cmd_args_t *args)
+{
+    led_id_t led;
+    uint32_t period_ms;
+
+    cmd_args_status_t error = parse_led_value(args, LED_BLINK_MIN_MS, LED_BLINK_MAX_MS,
+                                              &led, &period_ms);
+    if (error != CMD_ARGS_OK) {
+        return report_usage(command, error);
+    }
+    led_effects_blink(led, period_ms);
+    menu_print("\r\nBlink period set\r\n");
+    return COMMAND_OK;
+}
 
-    if (strcmp(command, "0") == 0) {
-        // Return to main menu
+static command_status_t command_duty(const global_command_t *command, const cmd_args_t *args)
+{
+    led_id_t led;
+    uint32_t percent;
+
+    cmd_args_status_t error = parse_led_value(args, 0, 100, &led, &percent);
+    if (error != CMD_ARGS_OK) {
+        return report_usage(command, error);
+    }
+    led_effects_duty(led, (uint8_t)percent);
+    menu_print("\r\nDuty cycle set\r\n");
+    return COMMAND_OK;
+}
+
+static command_status_t command_delay(const global_command_t *command, const cmd_args_t *args)
+{
+    uint32_t ms;
+    uint8_t index;
+
+    cmd_args_status_t error = cmd_args_uint(args->argv[1], 1, COMMAND_DELAY_MAX_MS, &ms);
+    if (error != CMD_ARGS_OK) {
+        return report_usage(command, error);
+    }
+
+    // In a replay the deadline follows on from the previous one, so the
+    // time spent running the steps in between does not add up
+    if (!macro_replaying) {
+        delay_deadline = xTaskGetTickCount();
+    }
+    delay_deadline += pdMS_TO_TICKS(ms);
+
+    for (;;) {
+        // Past the deadline the difference wraps beyond any delay: a late
+        // step does not wait, and the next deadline keeps the schedule
+        TickType_t left = delay_deadline - xTaskGetTickCount();
+        if (left == 0 || left > pdMS_TO_TICKS(COMMAND_DELAY_MAX_MS)) {
+            break;
+        }
+        TickType_t chunk = (left < pdMS_TO_TICKS(1000)) ? left : pdMS_TO_TICKS(1000);
+
+        if (macro_replaying) {
+            // New input ends the wait; the replay stops before its next step
+            if (xQueuePeek(command_queue, &index, chunk) == pdPASS) {
+                break;
+            }
+        } else {
+            vTaskDelay(chunk);
+        }
+        feed_watchdog();
+    }
+    return COMMAND_OK;
+}
+
+/**
+ * @brief  Print a macro store error
+ * @param  status: Error
+ * @retval COMMAND_INVALID
+ */
+static command_status_t report_macro_error(cmd_macro_status_t status)
+{
+    if (menu_output) {
+        print_printf("\r\n%s\r\n", cmd_macro_error_text(status));
+    }
+    return COMMAND_INVALID;
+}
+
+static command_status_t dispatch_line(char *line);
+
+/**
+ * @brief  Replay a macro
+ * @param  slot: Macro slot (cmd_macro_find())
+ * @param  repeat: Passes over its steps
+ * @retval COMMAND_OK if every step succeeded
+ *
+ * Each step is copied out of the store (dispatching splits it in place)
+ * and runs like a batch command, with menu output off. The replay stops
+ * at the first invalid step, or before the next step once new input is
+ * queued, so a runaway "repeat 1000" can be stopped by typing anything.
+ * It ends with one summary and one menu.
+ */
+static command_status_t macro_run(int slot, uint32_t repeat)
+{
+    BaseType_t report = menu_output;
+    const char *name = macro_store.slots[slot].name;
+    const char *failed = NULL;
+    command_status_t status = COMMAND_OK;
+    BaseType_t interrupted = pdFALSE;
+    char line[COMMAND_MAX_LENGTH];
+    unsigned done = 0;
+
+    macro_replaying = pdTRUE;
+    TickType_t start = xTaskGetTickCount();
+    delay_deadline = start;
+
+    for (uint32_t pass = 0; pass < repeat && failed == NULL && !interrupted; pass++) {
+        for (const char *step = cmd_macro_next(&macro_store, slot, NULL); step != NULL;
+             step = cmd_macro_next(&macro_store, slot, step)) {
+            if (uxQueueMessagesWaiting(command_queue) > 0) {
+                interrupted = pdTRUE;
+                break;
+            }
+
+            strcpy(line, step);         // Steps are shorter than a command line
+            menu_output = pdFALSE;      // Again, in case "interactive" ran
+            status = dispatch_line(line);
+            feed_watchdog();
+            if (status != COMMAND_OK) {
+                failed = step;
+                break;
+            }
+            done++;
+        }
+    }
+    macro_replaying = pdFALSE;
+    if (interrupted) {
+        status = COMMAND_INVALID;
+    }
+
+    // One response for the whole replay (the name and the step text move
+    // if the next command deletes or records a macro)
+    menu_output = (report && !machine_mode) ? pdTRUE : pdFALSE;
+    if (menu_output) {
+        if (failed != NULL) {
+            print_copy("\r\nMacro %s stopped at step %u (%s): invalid\r\n", name, done + 1, failed);
+        } else if (interrupted) {
+            print_copy("\r\nMacro %s interrupted after %u steps\r\n", name, done);
+        } else {
+            print_copy("\r\nMacro %s: %u steps run in %lu ms\r\n", name, done,
+                       (unsigned long)pdTICKS_TO_MS(xTaskGetTickCount() - start));
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief  Print the macros and the free space
+ */
+static void macro_list(void)
+{
+    unsigned free_slots = 0;
+
+    for (int slot = 0; slot < CMD_MACRO_SLOTS; slot++) {
+        const cmd_macro_slot_t *macro = &macro_store.slots[slot];
+        if (macro->name[0] == '\0') {
+            free_slots++;
+        } else {
+            print_copy("\r\n%-8s %3u steps %4u bytes%s", macro->name, (unsigned)macro->steps,
+                       (unsigned)macro->length,
+                       (slot == macro_store.recording) ? " (recording)" : "");
+        }
+    }
+    print_printf("\r\nFree: %u of %u bytes, %u of %u macros\r\n",
+                 (unsigned)(CMD_MACRO_STORAGE - macro_store.used), (unsigned)CMD_MACRO_STORAGE,
+                 free_slots, (unsigned)CMD_MACRO_SLOTS);
+}
+
+/* "macro" subcommands, and the words each takes (subcommand included) */
+typedef enum { MACRO_RECORD, MACRO_END, MACRO_RUN, MACRO_LIST, MACRO_DELETE, MACRO_SUB_COUNT } macro_sub_t;
+
+static const char *const macro_subs[MACRO_SUB_COUNT] = {
+    [MACRO_RECORD] = "record",
+    [MACRO_END] = "end",
+    [MACRO_RUN] = "run",
+    [MACRO_LIST] = "list",
+    [MACRO_DELETE] = "delete",
+};
+
+static command_status_t command_macro(const global_command_t *command, const cmd_args_t *args)
+{
+    static const uint8_t words[MACRO_SUB_COUNT] = {
+        [MACRO_RECORD] = 3, [MACRO_END] = 2, [MACRO_RUN] = 3, [MACRO_LIST] = 2, [MACRO_DELETE] = 3,
+    };
+    uint32_t repeat = 1;
+    size_t sub;
+    cmd_macro_status_t result;
+
+    cmd_args_status_t error = cmd_args_keyword(args->argv[1], macro_subs, MACRO_SUB_COUNT, &sub);
+    if (error != CMD_ARGS_OK) {
+        return report_usage(command, error);
+    }
+    if (args->argc != words[sub] && !(sub == MACRO_RUN && args->argc == 5)) {
+        return report_usage(command, CMD_ARGS_ERR_COUNT);
+    }
+    if ((batch_running || macro_replaying) && sub != MACRO_LIST) {
+        menu_print("\r\nNot possible in a batch or macro\r\n");
+        return COMMAND_INVALID;
+    }
+
+    switch (sub) {
+        case MACRO_RECORD:
+            result = cmd_macro_record(&macro_store, args->argv[2]);
+            if (result != CMD_MACRO_OK) {
+                return report_macro_error(result);
+            }
+            if (menu_output) {
+                print_copy("\r\nRecording macro %s (not run). End with \"macro end\"\r\n",
+                           args->argv[2]);
+            }
+            return COMMAND_OK;
+
+        case MACRO_END: {
+            const char *name = cmd_macro_recording(&macro_store);
+            int slot = macro_store.recording;
+            result = cmd_macro_end(&macro_store);
+            if (result != CMD_MACRO_OK) {
+                return report_macro_error(result);
+            }
+            if (menu_output) {
+                print_copy("\r\nMacro %s: %u steps, %u bytes\r\n", name,
+                           (unsigned)macro_store.slots[slot].steps,
+                           (unsigned)macro_store.slots[slot].length);
+            }
+            return COMMAND_OK;
+        }
+
+        case MACRO_RUN: {
+            if (cmd_macro_recording(&macro_store) != NULL) {
+                return report_macro_error(CMD_MACRO_ERR_RECORDING);
+            }
+            int slot = cmd_macro_find(&macro_store, args->argv[2]);
+            if (slot < 0) {
+                return report_macro_error(CMD_MACRO_ERR_UNKNOWN);
+            }
+            if (args->argc == 5) {
+                if (strcmp(args->argv[3], "repeat") != 0) {
+                    return report_usage(command, CMD_ARGS_ERR_KEYWORD);
+                }
+                error = cmd_args_uint(args->argv[4], 1, COMMAND_MACRO_MAX_REPEAT, &repeat);
+                if (error != CMD_ARGS_OK) {
+                    return report_usage(command, error);
+                }
+            }
+            return macro_run(slot, repeat);
+        }
+
+        case MACRO_LIST:
+            macro_list();
+            return COMMAND_OK;
+
+        case MACRO_DELETE:
+        default:
+            result = cmd_macro_delete(&macro_store, args->argv[2]);
+            if (result != CMD_MACRO_OK) {
+                return report_macro_error(result);
+            }
+            menu_print("\r\nMacro deleted\r\n");
+            return COMMAND_OK;
+    }
+}
+
+/* Looked up by the first word; the usage texts follow the limits above */
+static const global_command_t global_commands[] = {
+    { "rxstats",     0, 0, "rxstats",                              command_rxstats },
+    { "baud",        0, 1, "baud [<rate 9600-2000000>]",           command_baud },
+    { "ok",          0, 0, "ok",                                   command_ok },
+    { "machine",     0, 0, "machine",                              command_machine },
+    { "interactive", 0, 0, "interactive",                          command_interactive },
+    { "status",      0, 0, "status",                               command_status },
+    { "pattern",     1, 1, "pattern <0-3> (0 = off)",              command_pattern },
+    { "blink",       2, 2, "blink <green|orange> <period_ms 10-10000>", command_blink },
+    { "duty",        2, 2, "duty <green|orange> <percent 0-100>",  command_duty },
+    { "delay",       1, 1, "delay <ms 1-60000>",                   command_delay },
+    { "macro",       1, 4, "macro record|run|delete <name>, macro end|list, "
+                           "macro run <name> repeat <1-1000>",      command_macro },
+};
+
+#if LED_BLINK_MIN_MS != 10 || LED_BLINK_MAX_MS != 10000
+#error "Update the blink usage text in global_commands[] to the new limits"
+#endif
+
+#if COMMAND_DELAY_MAX_MS != 60000 || COMMAND_MACRO_MAX_REPEAT != 1000
+#error "Update the delay and macro usage texts in global_commands[] to the new limits"
+#endif
+
+#if CMD_ARGS_MAX < 5
+#error "\"macro run <name> repeat <n>\" needs CMD_ARGS_MAX >= 5"
+#endif
+
+/**
+ * @brief  Run a command that is valid in every menu
+ * @param  command: Trimmed, lowercase command (split in place)
+ * @param  status: [OUT] Result, if it was one of them
+ * @retval pdTRUE if command was one of them
+ *
+ * The line is split into words without copying (cmd_args.h); the first
+ * word selects the table entry, and a wrong word count is a usage error.
+ */
+static BaseType_t process_global_command(char *command, command_status_t *status)
+{
+    cmd_args_t args;
+    const global_command_t *entry = NULL;
+
+    // Too many words still yields the name (reported as a usage error)
+    cmd_args_status_t split = cmd_args_split(command, &args);
+    if (args.argc == 0) {
+        return pdFALSE;
+    }
+    for (size_t i = 0; i < sizeof(global_commands) / sizeof(global_commands[0]); i++) {
+        if (strcmp(args.argv[0], global_commands[i].name) == 0) {
+            entry = &global_commands[i];
+            break;
+        }
+    }
+    if (entry == NULL) {
+        return pdFALSE;
+    }
+
+    if (split != CMD_ARGS_OK || args.argc - 1 < entry->min_args ||
+        args.argc - 1 > entry->max_args) {
+        *status = report_usage(entry, CMD_ARGS_ERR_COUNT);
+    } else {
+        *status = entry->handler(entry, &args);
+    }
+
+    // Show the menu again below the output
+    if (vt100_mode && current_menu_state == MENU_LED_PATTERNS) {
+        vt100_marker_row = 0;   // Screen scrolled - next update redraws it
+    } else {
+        show_current_menu();
+    }
+    return pdTRUE;
+}
+
+/**
+ * @brief  Run a trimmed, lowercase command in the current menu
+ * @param  command: Command string
+ * @retval COMMAND_OK or COMMAND_INVALID
+ *
+ * Menu options are single digits and index the current menu's option
+ * table directly, so an option costs the same however many there are.
+ * Anything else is tried as a global command.
+ */
+static command_status_t dispatch_command(char *command)
+{
+    command_status_t status;
+
+    if (current_menu_state >= MENU_STATE_COUNT) {
         current_menu_state = MENU_MAIN;
-        print_main_menu();
     }
-    else if (strcmp(command, "1") == 0) {
-        led_effects_set_pattern(LED_PATTERN_1);
-        snprintf(response, sizeof(response), "\r\nNow playing LED Pattern 1\r\n");
-        print_message(response);
-        print_led_patterns_menu();
+
+    if (command[0] >= '0' && command[0] <= '9' && command[1] == '\0') {
+        const menu_option_t *option = &menus[current_menu_state].options[command[0] - '0'];
+        if (option->handler == NULL) {
+            return report_invalid_option();
+        }
+        return option->handler(option);
     }
-    else if (strcmp(command, "2") == 0) {
-        led_effects_set_pattern(LED_PATTERN_2);
-        snprintf(response, sizeof(response), "\r\nNow playing LED Pattern 2\r\n");
-        print_message(response);
-        print_led_patterns_menu();
+
+    if (process_global_command(command, &status)) {
+        return status;
     }
-    else if (strcmp(command, "3") == 0) {
-        led_effects_set_pattern(LED_PATTERN_3);
-        snprintf(response, sizeof(response), "\r\nNow playing LED Pattern 3\r\n");
-        print_message(response);
-        print_led_patterns_menu();
+    return report_invalid_option();
+}
+
+/**
+ * @brief  Run a "<command>;<command>;..." line as one batch
+ * @param  line: Commands (trimmed, lowercase, prefixes removed)
+ * @param  atomic: pdTRUE to stage LED changes and apply them together
+ * @retval COMMAND_OK if every command succeeded
+ *
+ * The commands run in order with menu output off, so the line gets one
+ * summary and one menu instead of a response per command. Commands that
+ * report data (rxstats, status, baud) still print it. The batch stops at
+ * the first invalid command. Without the atomic flag the commands before
+ * it stay done; with it, their LED changes and menu moves are dropped
+ * (other settings, such as the baud rate or session mode, are not
+ * undone).
+ */
+static command_status_t dispatch_batch(char *line, BaseType_t atomic)
+{
+    BaseType_t report = menu_output;    // Interactive and not sequenced
+    MenuState_t menu_before = current_menu_state;
+    LED_Pattern_t pattern_before = led_pattern;
+    command_status_t status = COMMAND_OK;
+    const char *failed = NULL;
+    unsigned done = 0;
+
+    if (atomic) {
+        led_effects_batch_begin();
     }
-    else if (strcmp(command, "4") == 0) {
-        led_effects_set_pattern(LED_PATTERN_NONE);
-        snprintf(response, sizeof(response), "\r\nAll LEDs turned OFF\r\n");
-        print_message(response);
-        print_led_patterns_menu();
+    batch_running = pdTRUE;
+
+    char *next = line;
+    while (next != NULL) {
+        char *command = next;
+        next = strchr(command, COMMAND_BATCH_SEPARATOR);
+        if (next != NULL) {
+            *next++ = '\0';
+        }
+
+        while (isspace((unsigned char)*command)) command++;
+        trim_whitespace(command);
+        if (*command == '\0') {
+            continue;   // "1;;2" or a trailing ';'
+        }
+
+        menu_output = pdFALSE;          // Again, in case "interactive" ran
+        status = dispatch_command(command);
+        if (status != COMMAND_OK) {
+            failed = command;           // Its first word, once split
+            break;
+        }
+        done++;
+    }
+    batch_running = pdFALSE;
+
+    if (atomic) {
+        if (status == COMMAND_OK) {
+            led_effects_batch_commit();
+        } else {
+            led_effects_batch_abort();
+            current_menu_state = menu_before;
+            led_pattern = pattern_before;
+        }
+    }
+
+    // One response for the whole line
+    menu_output = (report && !machine_mode) ? pdTRUE : pdFALSE;
+    if (menu_output) {
+        if (failed != NULL) {
+            // The command's text is in the line buffer
+            print_copy("\r\nBatch stopped at command %u (%s): invalid%s\r\n", done + 1, failed,
+                       atomic ? ", nothing applied" : "");
+        } else {
+            print_printf("\r\nBatch: %u commands ok\r\n", done);
+        }
     }
-    else {
-        snprintf(response, sizeof(response), "\r\nInvalid option. Please try again.\r\n");
-        print_message(response);
-        print_led_patterns_menu();
+    if (vt100_mode && current_menu_state == MENU_LED_PATTERNS) {
+        vt100_marker_row = 0;   // Not updated during the batch - next update redraws
+    } else {
+        show_current_menu();
     }
+    return status;
 }
 
-void process_command(char *command)
+/**
+ * @brief  Run one command line: an atomic batch, a batch or one command
+ * @param  line: Trimmed, lowercase line without "@<seq>" prefix
+ * @retval COMMAND_OK or COMMAND_INVALID
+ */
+static command_status_t dispatch_line(char *line)
 {
+    if (line[0] == COMMAND_ATOMIC_PREFIX) {
+        return dispatch_batch(&line[1], pdTRUE);
+    }
+    if (strchr(line, COMMAND_BATCH_SEPARATOR) != NULL) {
+        return dispatch_batch(line, pdFALSE);
+    }
+    return dispatch_command(line);
+}
+
+/**
+ * @brief  Check for a "macro ..." line, which is run even while recording
+ * @param  line: Trimmed, lowercase line without "@<seq>" prefix
+ * @retval pdTRUE for a single "macro" command (not inside a batch)
+ *
+ * So "macro end" and "macro list" still work while recording.
+ */
+static BaseType_t is_macro_command(const char *line)
+{
+    return strncmp(line, "macro", 5) == 0 &&
+           (line[5] == '\0' || isspace((unsigned char)line[5])) &&
+           strchr(line, COMMAND_BATCH_SEPARATOR) == NULL;
+}
+
+/**
+ * @brief  Store a line in the macro being recorded, instead of running it
+ * @param  line: Trimmed, lowercase line without "@<seq>" prefix
+ * @retval COMMAND_OK, or COMMAND_INVALID if the store is full
+ */
+static command_status_t record_step(const char *line)
+{
+    cmd_macro_status_t result = cmd_macro_append(&macro_store, line);
+    if (result != CMD_MACRO_OK) {
+        return report_macro_error(result);
+    }
+    if (menu_output) {
+        print_copy("\r\n%s: step %u recorded\r\n", cmd_macro_recording(&macro_store),
+                   (unsigned)macro_store.slots[macro_store.recording].steps);
+        vt100_marker_row = 0;   // Scrolled - the next LED menu update redraws
+    }
+    return COMMAND_OK;
+}
+
+command_status_t process_command(char *command)
+{
+    uint16_t seq;
+
     // Trim and convert to lowercase
     trim_whitespace(command);
     to_lowercase(command);
 
-    // Process based on current menu state
-    switch (current_menu_state) {
-        case MENU_MAIN:
-            process_main_menu_command(command);
+    // Sequenced or machine mode: no menu output, one compact status line
+    char *sequenced = parse_sequence(command, &seq);
+    char *line = (sequenced != NULL) ? sequenced : command;
+    menu_output = (sequenced == NULL && !machine_mode) ? pdTRUE : pdFALSE;
+
+    command_status_t status;
+    if (cmd_macro_recording(&macro_store) != NULL && line[0] != '\0' && !is_macro_command(line)) {
+        status = record_step(line);
+    } else {
+        status = dispatch_line(line);
+    }
+    menu_output = pdTRUE;
+
+    // Checked after the command, which may have switched the mode
+    if (sequenced != NULL) {
+        // Without echo the cursor is already at the start of a line
+        print_printf(machine_mode ? "ack %u %s\r\n" : "\r\nack %u %s\r\n", (unsigned)seq,
+                     (status == COMMAND_OK) ? "ok" : "invalid");
+    } else if (machine_mode) {
+        print_const((status == COMMAND_OK) ? "ok\r\n" : "invalid\r\n");
+    }
+    return status;
+}
+
+/**
+ * @brief  Store a 32-bit value little-endian
+ */
+static uint8_t *put_u32(uint8_t *dest, uint32_t value)
+{
+    dest[0] = (uint8_t)value;
+    dest[1] = (uint8_t)(value >> 8);
+    dest[2] = (uint8_t)(value >> 16);
+    dest[3] = (uint8_t)(value >> 24);
+    return dest + 4;
+}
+
+/**
+ * @brief  Execute a binary command frame and send its response frame
+ * @param  item: Command pool buffer ([marker][length][payload], payload
+ *         already CRC-checked by the UART task)
+ * @retval None
+ *
+ * The response echoes the opcode (with CMD_FRAME_RESPONSE set) and the
+ * sequence number, followed by a status byte and the opcode's data.
+ */
+static void process_frame(const uint8_t *item)
+{
+    const uint8_t *request = &item[2];
+    size_t args = item[1] - 2;  // Opcode and sequence are always present
+    uint8_t response[CMD_FRAME_MAX_PAYLOAD];
+    uint8_t *data = &response[3];
+    uint8_t *end = data;
+    cmd_frame_status_t status = CMD_FRAME_OK;
+
+    switch (request[0]) {
+        case CMD_OP_PING:
+            *end++ = CMD_FRAME_VERSION;
+            *end++ = COMMAND_PIPELINE_WINDOW;
+            break;
+
+        case CMD_OP_SET_PATTERN:
+            // Any pattern the LED menu offers
+            if (args != 1 || request[2] >= LED_PATTERN_COUNT) {
+                status = CMD_FRAME_ERR_ARG;
+            } else {
+                set_led_pattern((LED_Pattern_t)request[2]);
+            }
             break;
 
-        case MENU_LED_PATTERNS:
-            process_led_patterns_menu_command(command);
+        case CMD_OP_GET_STATUS:
+            *end++ = (uint8_t)led_pattern;
+            *end++ = (uint8_t)current_menu_state;
             break;
 
+        case CMD_OP_GET_RX_STATS: {
+            uart_rx_stats_t stats;
+            uart_get_rx_stats(&stats);
+            end = put_u32(end, stats.rx_bytes);
+            end = put_u32(end, stats.rx_dropped);
+            end = put_u32(end, stats.commands);
+            end = put_u32(end, stats.frame_errors);
+            break;
+        }
+
         default:
-            current_menu_state = MENU_MAIN;
-            print_main_menu();
+            status = CMD_FRAME_ERR_OPCODE;
             break;
     }
+
+    if (status != CMD_FRAME_OK) {
+        end = data;     // Errors carry no data
+    }
+
+    response[0] = request[0] | CMD_FRAME_RESPONSE;
+    response[1] = request[1];
+    response[2] = (uint8_t)status;
+
+    uint8_t frame[CMD_FRAME_MAX_WIRE];
+    size_t length = cmd_frame_encode(response, (size_t)(end - response), frame, sizeof(frame));
+    print_write_binary(frame, length);
 }
 
 void command_handler_task(void *parameters)
 {
-    char received_command[COMMAND_MAX_LENGTH];
+    uint8_t index;
+
+    cmd_macro_init(&macro_store);
 
     // Register with watchdog (5 second timeout = 2.5× the 2s blocking period)
-    watchdog_id_t wd_id = watchdog_register("CMD_Handler", 5000);
-    if (wd_id == WATCHDOG_INVALID_ID) {
-        print_message("[CMD] Failed to register with watchdog!\r\n");
+    handler_wd_id = watchdog_register("CMD_Handler", 5000);
+    if (handler_wd_id == WATCHDOG_INVALID_ID) {
+        print_log(LOG_CMD_WD_REGISTER_FAIL);
     }
 
     while (1) {
-        // Wait for notification from UART task with finite timeout
+        // Wait for the next command pool index from the UART task with
+        // finite timeout (the queue itself wakes us - no notification)
         // Timeout allows periodic watchdog feeding even when no commands
-        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(2000));
+        BaseType_t received = xQueueReceive(command_queue, &index, pdMS_TO_TICKS(2000));
 
         // Feed watchdog to prove task is alive
-        // Fed on every iteration (whether notification received or timeout)
-        if (wd_id != WATCHDOG_INVALID_ID) {
-            watchdog_feed(wd_id);
-        }
+        // Fed on every iteration (whether a command arrived or timeout)
+        feed_watchdog();
 
-        // Try to receive command from queue
-        while (xQueueReceive(command_queue, received_command, 0) == pdPASS) {
-            // Process the command
-            process_command(received_command);
+        if (received == pdPASS) {
+            // Process the command in place (binary frame or typed menu
+            // command), then hand the line buffer back
+            char *command = command_buffer(index);
+            if ((uint8_t)command[0] == COMMAND_FRAME_MARKER) {
+                process_frame((const uint8_t *)command);
+            } else {
+                process_command(command);
+            }
+            command_buffer_release(index);
         }
     }
 }
@@ -23,6 +23,12 @@
  * - Timers run in Timer Service Task (separate from app tasks)
  * - Timer callbacks toggle GPIO pins directly
  * - Periods are dynamically changed using xTimerChangePeriod()
+ * - Each LED has a toggle period and a duty cycle. The patterns are
+ *   presets of both; the blink/duty commands change one LED. At 50 %
+ *   the timer just auto-reloads, otherwise each callback sets the length
+ *   of the next on or off phase
+ * - Between led_effects_batch_begin() and _commit() changes go to a
+ *   staged copy; the commit applies them all with one GPIO write
  *
  * Hardware:
  * - LED_GREEN (LD4) on GPIO PD12
@@ -36,6 +42,7 @@
 #include "led_effects.h"
 #include "FreeRTOS.h"
 #include "timers.h"
+#include <string.h>
 
 /* Software timer handles */
 static TimerHandle_t led_timer1 = NULL;  // Controls LED_GREEN (LD4)
@@ -44,6 +51,119 @@ static TimerHandle_t led_timer2 = NULL;  // Controls LED_ORANGE (LD3)
 /* Current active pattern */
 static LED_Pattern_t current_pattern = LED_PATTERN_NONE;
 
+/* Blink settings of one LED */
+typedef struct {
+    uint32_t period_ms;     // Toggle period at 50 %
+    uint8_t duty;           // Percent of the cycle ON
+} led_settings_t;
+
+/* Per-LED state, indexed by led_id_t */
+static const uint16_t led_pins[LED_ID_COUNT] = { LED_GREEN_PIN, LED_ORANGE_PIN };
+static led_settings_t led_settings[LED_ID_COUNT] = { { 100, 0 }, { 100, 0 } };  // Running
+static uint8_t led_lit[LED_ID_COUNT];                        // Phase the timer is in
+
+/* Open batch: changes collect in led_staged (and staged_pattern) until
+ * the commit */
+static led_settings_t led_staged[LED_ID_COUNT];
+static LED_Pattern_t staged_pattern = LED_PATTERN_NONE;
+static BaseType_t led_batch_open = pdFALSE;
+
+#define LED_MASK(led)   (1u << (led))
+#define LED_MASK_ALL    ((1u << LED_ID_COUNT) - 1)
+
+static TimerHandle_t led_timer(led_id_t led)
+{
+    return (led == LED_ID_GREEN) ? led_timer1 : led_timer2;
+}
+
+/* Settings that changes go to: staged while a batch is open */
+static led_settings_t *led_edit(void)
+{
+    return led_batch_open ? led_staged : led_settings;
+}
+
+/**
+ * @brief  Length of the next blink phase
+ * @param  led: LED
+ * @param  on: Non-zero for the ON phase
+ * @retval Phase length in ticks (at least 1)
+ *
+ * A cycle is two toggle periods, split by the duty cycle.
+ */
+static TickType_t led_phase_ticks(led_id_t led, int on)
+{
+    uint32_t cycle_ms = 2 * led_settings[led].period_ms;
+    uint32_t on_ms = cycle_ms * led_settings[led].duty / 100;
+    TickType_t ticks = pdMS_TO_TICKS(on ? on_ms : cycle_ms - on_ms);
+
+    return (ticks > 0) ? ticks : 1;
+}
+
+/**
+ * @brief  Restart LEDs from their running settings
+ * @param  leds: LED_MASK() bits of the LEDs to restart
+ *
+ * 0 % and 100 % are static (timer stopped). Otherwise the LED starts in
+ * the OFF phase, as the blinking patterns always have. The pins of all
+ * LEDs in the mask change with a single BSRR write, so a pattern never
+ * shows one LED updated and the other not.
+ */
+static void led_apply(uint32_t leds)
+{
+    uint32_t bsrr = 0;
+
+    for (led_id_t led = 0; led < LED_ID_COUNT; led++) {
+        if ((leds & LED_MASK(led)) == 0) {
+            continue;
+        }
+        if (led_timer(led) != NULL) {
+            xTimerStop(led_timer(led), 0);
+        }
+        led_lit[led] = (led_settings[led].duty >= 100);
+        bsrr |= led_lit[led] ? led_pins[led] : (uint32_t)led_pins[led] << 16;
+    }
+
+    // Upper half resets pins, lower half sets them
+    GPIOD->BSRR = bsrr;
+
+    for (led_id_t led = 0; led < LED_ID_COUNT; led++) {
+        uint8_t duty = led_settings[led].duty;
+        if ((leds & LED_MASK(led)) != 0 && led_timer(led) != NULL && duty > 0 && duty < 100) {
+            // xTimerChangePeriod() also starts the timer
+            xTimerChangePeriod(led_timer(led), led_phase_ticks(led, 0), 0);
+        }
+    }
+}
+
+/* Apply a change now, or at the commit if a batch is open */
+static void led_changed(uint32_t leds)
+{
+    if (!led_batch_open) {
+        led_apply(leds);
+    }
+}
+
+/**
+ * @brief  Timer step for one LED: toggle, then time the next phase
+ * @param  led: LED
+ */
+static void led_blink_step(led_id_t led)
+{
+    uint8_t duty = led_settings[led].duty;
+
+    if (duty == 0 || duty >= 100) {
+        return;     // Expired just before a change to a steady state
+    }
+
+    HAL_GPIO_TogglePin(GPIOD, led_pins[led]);
+    led_lit[led] = !led_lit[led];
+
+    if (duty != 50) {
+        // Uneven phases: 0 = don't block (runs in the timer service task)
+        xTimerChangePeriod(led_timer(led), led_phase_ticks(led, led_lit[led]), 0);
+    }
+}
+
 void led_effects_init(void)
 {
     // Create software timers for LED control
@@ -98,63 +218,93 @@ void led_effects_init(void)
  */
 void led_effects_set_pattern(LED_Pattern_t pattern)
 {
-    // Safety: Stop all running timers before pattern change
-    // This prevents orphaned timers from previous pattern
-    if (led_timer1 != NULL) {
-        xTimerStop(led_timer1, 0);  // 0 = don't block if timer queue full
-    }
-    if (led_timer2 != NULL) {
-        xTimerStop(led_timer2, 0);
-    }
+    led_settings_t *settings = led_edit();
 
-    // Update pattern state
-    current_pattern = pattern;
+    // Update pattern state (staged like the settings in a batch)
+    if (led_batch_open) {
+        staged_pattern = pattern;
+    } else {
+        current_pattern = pattern;
+    }
 
     // Configure LEDs and timers based on selected pattern
+    // (led_apply() stops the timers first, so no orphaned timers remain)
     switch (pattern) {
         case LED_PATTERN_1:
-            // Pattern 1: Always ON 2 LEDs
-            HAL_GPIO_WritePin(GPIOD, LED_GREEN_PIN, GPIO_PIN_SET);
-            HAL_GPIO_WritePin(GPIOD, LED_ORANGE_PIN, GPIO_PIN_SET);
+            // Pattern 1: Always ON 2 LEDs (static, timers stopped)
+            settings[LED_ID_GREEN].duty = 100;
+            settings[LED_ID_ORANGE].duty = 100;
             break;
 
         case LED_PATTERN_2:
             // Pattern 2: Different frequency blinking
             // Creates visual contrast - one fast, one slow
-            HAL_GPIO_WritePin(GPIOD, LED_GREEN_PIN, GPIO_PIN_RESET);
-            HAL_GPIO_WritePin(GPIOD, LED_ORANGE_PIN, GPIO_PIN_RESET);
-
             // Configure periods: Green=100ms, Orange=1000ms (10:1 ratio)
-            xTimerChangePeriod(led_timer1, pdMS_TO_TICKS(100), 0);
-            xTimerChangePeriod(led_timer2, pdMS_TO_TICKS(1000), 0);
-
-            // Start both timers (xTimerChangePeriod also starts, but explicit for clarity)
-            xTimerStart(led_timer1, 0);
-            xTimerStart(led_timer2, 0);
+            settings[LED_ID_GREEN] = (led_settings_t){ 100, 50 };
+            settings[LED_ID_ORANGE] = (led_settings_t){ 1000, 50 };
             break;
 
         case LED_PATTERN_3:
             // Pattern 3: Synchronized fast blinking
             // Both LEDs toggle at same rate (may be out of phase initially)
-            HAL_GPIO_WritePin(GPIOD, LED_GREEN_PIN, GPIO_PIN_RESET);
-            HAL_GPIO_WritePin(GPIOD, LED_ORANGE_PIN, GPIO_PIN_RESET);
-
-            // Both timers: 100ms period (fast blink)
-            xTimerChangePeriod(led_timer1, pdMS_TO_TICKS(100), 0);
-            xTimerChangePeriod(led_timer2, pdMS_TO_TICKS(100), 0);
-
-            // Start both timers
-            xTimerStart(led_timer1, 0);
-            xTimerStart(led_timer2, 0);
+            settings[LED_ID_GREEN] = (led_settings_t){ 100, 50 };
+            settings[LED_ID_ORANGE] = (led_settings_t){ 100, 50 };
             break;
 
         default:
             // PATTERN_NONE or invalid: Turn off all LEDs
-            // Timers already stopped at function entry
-            HAL_GPIO_WritePin(GPIOD, LED_GREEN_PIN, GPIO_PIN_RESET);
-            HAL_GPIO_WritePin(GPIOD, LED_ORANGE_PIN, GPIO_PIN_RESET);
+            settings[LED_ID_GREEN].duty = 0;
+            settings[LED_ID_ORANGE].duty = 0;
             break;
     }
+
+    led_changed(LED_MASK_ALL);
+}
+
+void led_effects_blink(led_id_t led, uint32_t period_ms)
+{
+    configASSERT(led < LED_ID_COUNT);
+    led_settings_t *settings = &led_edit()[led];
+
+    settings->period_ms = period_ms;
+    if (settings->duty == 0 || settings->duty == 100) {
+        settings->duty = 50;    // A static LED starts blinking
+    }
+    led_changed(LED_MASK(led));
+}
+
+void led_effects_duty(led_id_t led, uint8_t percent)
+{
+    configASSERT(led < LED_ID_COUNT && percent <= 100);
+    led_edit()[led].duty = percent;
+    led_changed(LED_MASK(led));
+}
+
+void led_effects_batch_begin(void)
+{
+    configASSERT(!led_batch_open);
+    memcpy(led_staged, led_settings, sizeof(led_staged));
+    staged_pattern = current_pattern;
+    led_batch_open = pdTRUE;
+}
+
+void led_effects_batch_commit(void)
+{
+    configASSERT(led_batch_open);
+    led_batch_open = pdFALSE;
+
+    // The timer task (same priority) may run a callback at any time
+    taskENTER_CRITICAL();
+    memcpy(led_settings, led_staged, sizeof(led_settings));
+    taskEXIT_CRITICAL();
+    current_pattern = staged_pattern;
+
+    led_apply(LED_MASK_ALL);
+}
+
+void led_effects_batch_abort(void)
+{
+    led_batch_open = pdFALSE;
 }
 
 /**
@@ -173,7 +323,7 @@ void led_effects_set_pattern(LED_Pattern_t pattern)
 void led_timer1_callback(TimerHandle_t xTimer)
 {
     // Toggle Green LED state (ON->OFF or OFF->ON)
-    HAL_GPIO_TogglePin(GPIOD, LED_GREEN_PIN);
+    led_blink_step(LED_ID_GREEN);
 }
 
 /**
@@ -192,5 +342,5 @@ void led_timer1_callback(TimerHandle_t xTimer)
 void led_timer2_callback(TimerHandle_t xTimer)
 {
     // Toggle Orange LED state (ON->OFF or OFF->ON)
-    HAL_GPIO_TogglePin(GPIOD, LED_ORANGE_PIN);
+    led_blink_step(LED_ID_ORANGE);
 }
@@ -0,0 +1,74 @@
+/**
+ ******************************************************************************
+ * @file           : line_scan.c
+ * @brief          : Word-at-a-time Scanner for Terminal Control Characters
+ ******************************************************************************
+ * @description
+ * SWAR test per 32-bit word, two cheap filters combined:
+ *
+ *     below(x, n) = (x - 0x01010101 * n) & ~x & 0x80808080
+ *                   flags bytes < n  (CR, LF, backspace, NUL, SO and SI are all < 0x10)
+ *     equal(x, c) = below(x ^ (0x01010101 * c), 1)
+ *                   flags bytes == c (DEL)
+ *
+ * Printable text never sets a flag, so ordinary runs cost ~8 ALU ops per
+ * four bytes. A flagged word (which may also be a tab or another control
+ * byte) is resolved byte by byte.
+ ******************************************************************************
+ */
+
+#include "line_scan.h"
+#include <string.h>
+
+#define LINE_SCAN_ONES   0x01010101u
+#define LINE_SCAN_HIGHS  0x80808080u
+
+/* Flag every byte of x below n (n <= 0x80; lowest flag is exact) */
+#define LINE_SCAN_BELOW(x, n)  (((x) - LINE_SCAN_ONES * (n)) & ~(x) & LINE_SCAN_HIGHS)
+
+/* Flag every byte of x equal to c */
+#define LINE_SCAN_EQUAL(x, c)  LINE_SCAN_BELOW((x) ^ (LINE_SCAN_ONES * (c)), 1u)
+
+/* All special characters except DEL are below this value */
+#define LINE_SCAN_CONTROL_LIMIT 0x10u
+
+size_t line_scan_special(const uint8_t *data, size_t length)
+{
+    size_t i = 0;
+
+    for (; i + sizeof(uint32_t) <= length; i += sizeof(uint32_t)) {
+        uint32_t word;
+        memcpy(&word, &data[i], sizeof(word));  // Single LDR (unaligned OK on M4)
+
+        if ((LINE_SCAN_BELOW(word, LINE_SCAN_CONTROL_LIMIT) | LINE_SCAN_EQUAL(word, 0x7Fu)) == 0) {
+            continue;   // Four ordinary bytes
+        }
+
+        // Candidate word: find the exact byte (a tab would be a false hit)
+        for (size_t j = 0; j < sizeof(uint32_t); j++) {
+            if (line_scan_is_special(data[i + j])) {
+                return i + j;
+            }
+        }
+    }
+
+    // Tail shorter than a word
+    for (; i < length; i++) {
+        if (line_scan_is_special(data[i])) {
+            break;
+        }
+    }
+    return i;
+}
+
+size_t line_scan_special_bytewise(const uint8_t *data, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        if (line_scan_is_special(data[i])) {
+            break;
+        }
+    }
+    return i;
+}
@@ -66,6 +66,8 @@
 
 /* Private variables ---------------------------------------------------------*/
 UART_HandleTypeDef huart2;
+DMA_HandleTypeDef hdma_usart2_rx;
+DMA_HandleTypeDef hdma_usart2_tx;
 
 /* USER CODE BEGIN PV */
 #define DWT_CTRL    (*(volatile uint32_t*)0xE0001000)
@@ -75,6 +77,7 @@ UART_HandleTypeDef huart2;
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_USART2_UART_Init(void);
 /* USER CODE BEGIN PFP */
 
@@ -114,6 +117,7 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_USART2_UART_Init();
   /* USER CODE BEGIN 2 */
 
@@ -125,7 +129,7 @@ int main(void)
 	led_effects_init();
 
 	// Step 2: Initialize print task subsystem
-	// Creates: 1) Print message queue (10 elements × 512 bytes)
+	// Creates: 1) Print message buffer (1 KB, variable-length messages)
 	//          2) Print task (priority 3) - owns UART TX exclusively
 	print_task_init();
 
@@ -235,11 +239,36 @@ static void MX_USART2_UART_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN USART2_Init 2 */
-
+#if UART_FLOW_CONTROL == UART_FLOW_RTS_CTS
+  // CTS gates our TX in hardware; RTS is driven from the stream buffer
+  // watermarks in uart_task.c (CTSE may only change while UE is off)
+  __HAL_UART_DISABLE(&huart2);
+  __HAL_UART_HWCONTROL_CTS_ENABLE(&huart2);
+  __HAL_UART_ENABLE(&huart2);
+#endif
   /* USER CODE END USART2_Init 2 */
 
 }
 
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA1_Stream5_IRQn interrupt configuration (USART2_RX) */
+  HAL_NVIC_SetPriority(DMA1_Stream5_IRQn, 6, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Stream5_IRQn);
+  /* DMA1_Stream6_IRQn interrupt configuration (USART2_TX) */
+  HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, 6, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -0,0 +1,134 @@
+/**
+ ******************************************************************************
+ * @file           : print_port.c
+ * @brief          : Print Task Hardware Port - STM32 USART2 TX via DMA
+ ******************************************************************************
+ * @description
+ * Target implementation of print_port.h. Transfers are handed to DMA1
+ * Stream6 (USART2_TX) with HAL_UART_Transmit_DMA(). The HAL enables the
+ * USART TC interrupt after the last DMA beat, and HAL_UART_TxCpltCallback()
+ * fires once the final stop bit has left the shift register.
+ *
+ * Flow:
+ * ┌────────────┐  transmit()  ┌──────────┐  TC IRQ  ┌───────────────────┐
+ * │ Print Task │ ───────────> │ DMA1 S6  │ ───────> │ TxCpltCallback    │
+ * │ (BLOCKED)  │ <─────────── │ USART2   │          │ give tx_done_sem  │
+ * └────────────┘  wait_idle() └──────────┘          └───────────────────┘
+ *
+ * The CPU is idle (or running other tasks) for the whole transfer; the
+ * old HAL_UART_Transmit() busy-polled TXE for ~87μs per character.
+ *
+ * A host simulation replaces this file, keeping print_task.c unchanged.
+ ******************************************************************************
+ */
+
+#include "print_port.h"
+#include "semphr.h"
+
+/* UART2 peripheral handle (from main.c) */
+extern UART_HandleTypeDef huart2;
+
+/* Signalled by the TC interrupt when a transfer completes */
+static SemaphoreHandle_t tx_done_sem = NULL;
+
+/* Set when a transfer starts, cleared by the TC interrupt */
+static volatile BaseType_t tx_busy = pdFALSE;
+
+void print_port_init(void)
+{
+    tx_done_sem = xSemaphoreCreateBinary();
+    configASSERT(tx_done_sem != NULL);
+}
+
+BaseType_t print_port_transmit(const uint8_t *data, uint16_t length)
+{
+    if (length == 0) {
+        return pdPASS;
+    }
+
+    tx_busy = pdTRUE;
+    if (HAL_UART_Transmit_DMA(&huart2, data, length) != HAL_OK) {
+        tx_busy = pdFALSE;
+        return pdFAIL;
+    }
+
+    return pdPASS;
+}
+
+BaseType_t print_port_wait_idle(TickType_t timeout)
+{
+    // Loop because the semaphore may still hold a stale give from a
+    // transfer that completed before anyone waited on it
+    while (tx_busy) {
+        if (xSemaphoreTake(tx_done_sem, timeout) != pdPASS) {
+            // TC interrupt never arrived - abort so the port is usable again
+            HAL_UART_AbortTransmit(&huart2);
+            tx_busy = pdFALSE;
+            return pdFAIL;
+        }
+    }
+
+    return pdPASS;
+}
+
+BaseType_t print_port_is_busy(void)
+{
+    return tx_busy;
+}
+
+void print_port_tx_complete_from_isr(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    tx_busy = pdFALSE;
+    xSemaphoreGiveFromISR(tx_done_sem, &xHigherPriorityTaskWoken);
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+void print_port_emergency_write(const uint8_t *data, uint16_t length)
+{
+    // Whatever the hung print task left on the wire is abandoned, so the
+    // alert comes out whole instead of interleaved with a stale burst
+    HAL_UART_AbortTransmit(&huart2);
+    HAL_UART_Transmit(&huart2, data, length, PRINT_PORT_EMERGENCY_TIMEOUT_MS);
+
+    // Leave the port idle in case the print task recovers
+    tx_busy = pdFALSE;
+    xSemaphoreGive(tx_done_sem);
+}
+
+void print_port_send_priority(uint8_t c)
+{
+    USART_TypeDef *usart = huart2.Instance;
+    uint32_t dma_enabled = READ_BIT(usart->CR3, USART_CR3_DMAT);
+
+    // Stop further DMA requests; the stream keeps its position
+    CLEAR_BIT(usart->CR3, USART_CR3_DMAT);
+    __DSB();
+
+    // Wait for the byte the DMA may just have written to move on
+    while (!__HAL_UART_GET_FLAG(&huart2, UART_FLAG_TXE)) {
+    }
+    usart->DR = c;
+
+    // Resume the burst right behind the injected byte
+    if (dma_enabled) {
+        SET_BIT(usart->CR3, USART_CR3_DMAT);
+    }
+}
+
+/**
+ * @brief  UART TX Complete Callback (called from ISR context)
+ * @param  huart: UART handle
+ * @retval None
+ *
+ * Called by HAL_UART_IRQHandler() on the USART TC interrupt that follows
+ * the DMA transfer-complete.
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart == &huart2) {
+        print_port_tx_complete_from_isr();
+    }
+}
@@ -5,64 +5,378 @@
  ******************************************************************************
  * @description
  * This module implements a dedicated print task that owns UART TX hardware
- * exclusively. Other tasks send messages via a queue, making UART printing
- * non-blocking and eliminating the need for mutex protection.
+ * exclusively. Other tasks send messages via a message buffer, making UART
+ * printing non-blocking and eliminating the need for mutex protection
+ * around the UART.
  *
  * Key Features:
  * - Exclusive UART TX ownership (no concurrent access issues)
  * - Non-blocking API for application tasks
- * - Queue-based message passing
+ * - Variable-length message passing (no fixed 512-byte slots)
  * - FIFO message ordering
- * - Simple error handling (queue full detection)
+ * - Simple error handling (buffer full detection)
  *
  * Architecture Benefits:
- * - Eliminates priority inversion (queue is faster than mutex)
+ * - Eliminates priority inversion on the UART (no mutex held during TX)
  * - Better separation of concerns (tasks don't need UART knowledge)
  * - Centralized UART control (easier to debug and extend)
  * - Scalable (can add features without changing application code)
  *
+ * Tokenized Logging (print_log(), see print_log.h):
+ * - Same control record as print_printf(), carrying the event ID
+ * - Text mode formats it like print_printf(); binary mode emits a
+ *   3-byte header + raw argument bytes decoded on the host
+ *
+ * Constant Strings (print_const()):
+ * - Menus and banners are literals in flash; only a 12-byte record
+ *   (pointer + length) is enqueued
+ * - The print task copies the text once, flash -> TX burst, instead of
+ *   caller -> buffer -> burst (a menu redraw drops from ~800 to ~24 bytes
+ *   of buffer traffic, see bytes_by_reference in print_get_stats())
+ *
+ * Deferred Formatting (print_printf()):
+ * - The caller enqueues a control record: NUL marker, format pointer and
+ *   the packed argument words (8 + 4 × argc bytes)
+ * - The print task runs snprintf() directly into the TX burst, so callers
+ *   need no 128-byte response buffer on their stack
+ * - Text messages never begin with NUL, which is how records are told
+ *   apart from text without any extra per-message header
+ * - print_write_binary() uses the same marker with the bytes inline, so
+ *   binary frames (which start with NUL) pass through unchanged
+ *
+ * Message Buffer vs Queue:
+ * - A queue item is always PRINT_MESSAGE_MAX_SIZE bytes, so an echoed
+ *   character cost 512 bytes in + 512 bytes out
+ * - A message buffer stores length + payload, so the same echo costs
+ *   5 bytes in + 5 bytes out (~100× less copying)
+ * - Message buffers assume a single writer, so producers are serialized
+ *   by a per-lane write lock. The lock is only held for the copy itself,
+ *   never during UART transmission.
+ *
+ * Priority Lanes:
+ * - Urgent lane (print_message_urgent(), print_log_urgent()) for alerts
+ *   and diagnostics; bulk lane (everything else) for menus and echo
+ * - Each lane has its own message buffer, so a full bulk lane never
+ *   blocks or delays an urgent producer
+ * - The print task drains the urgent lane first at every message
+ *   boundary; a 400-byte menu already in the burst still finishes, but
+ *   ten queued menus no longer stand in front of an alert
+ * - Per-lane depth and latency counters: print_get_lane_stats()
+ *
+ * UART Transmission (DMA, double-buffered):
+ * - Each message is received into one of two TX buffers and handed to
+ *   print_port_transmit() (USART2 TX via DMA, TC interrupt on completion)
+ * - While buffer A drains over DMA, the task blocks on the message buffer
+ *   and fills buffer B; it only waits for A's completion right before
+ *   starting B
+ * - The CPU is free during transmission (no TXE busy-polling)
+ *
+ * Coalescing Drain:
+ * - After the first message wakes the task, every other pending message is
+ *   appended to the same TX buffer (up to PRINT_COALESCE_BUDGET bytes)
+ * - Messages arriving while the previous burst drains are appended too,
+ *   right before the new burst starts
+ * - A menu redraw issued as several print_message() calls therefore goes
+ *   out as one DMA transfer after one task wakeup
+ * - All hardware access goes through print_port.h, so this file also runs
+ *   under a host simulation of the TX-complete interrupt
+ *
+ * Interrupt Output (print_message_from_isr()):
+ * - One lock-free single-producer ring per ISR source, so interrupts
+ *   never touch the message buffers or their mutexes
+ * - ISR cost is bounded by PRINT_ISR_MESSAGE_MAX_SIZE byte copies plus
+ *   one task notification; a full ring drops the message and counts it
+ * - The print task drains the rings ahead of both lanes
+ *
  * Memory Usage:
- * - Queue: ~5.1 KB (10 messages × 512 bytes)
+ * - Buffers: 1 KB bulk (PRINT_BUFFER_SIZE) + 512 B urgent
+ *   (PRINT_URGENT_BUFFER_SIZE)
+ * - TX buffers: 1.5 KB (2 × PRINT_COALESCE_BUDGET, static)
  * - Task stack: ~2 KB (512 words)
- * - Total: ~7.1 KB (well within available 75 KB heap)
+ * - Total: ~5 KB (well within available 75 KB heap)
  *
  * Performance:
- * - Message enqueue: ~20-50μs
+ * - Message enqueue: ~5-20μs (proportional to message length)
  * - Context switch overhead: ~30-50μs
  * - Total added latency: ~50-100μs (imperceptible for human-readable text)
  ******************************************************************************
  */
 
 #include "print_task.h"
+#include "print_log.h"
+#include "print_port.h"
 #include "watchdog.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+
+/* Message buffer length header (size_t prefix stored by FreeRTOS) */
+#define PRINT_MSG_HEADER_SIZE sizeof(size_t)
+
+/* First byte of a control record. Text messages never start with NUL:
+ * print_message() stops at the terminator and print_char() skips '\0'. */
+#define PRINT_RECORD_MARKER 0x00
+
+/* Control record types */
+#define PRINT_RECORD_FORMAT 1       // print_printf(): format pointer + args
+#define PRINT_RECORD_LOG    2       // print_log(): event ID + args
+#define PRINT_RECORD_CONST  3       // print_const(): string pointer + length
+#define PRINT_RECORD_BYTES  4       // print_write_binary(): bytes inline after the type
+
+/* One packed print_printf() argument (32 bits on Cortex-M4) */
+typedef uintptr_t print_arg_t;
+
+/**
+ * Deferred-format record (see print_printf())
+ * Only the header and the argc used arguments are enqueued.
+ */
+typedef struct {
+    uint8_t marker;                         // PRINT_RECORD_MARKER
+    uint8_t type;                           // PRINT_RECORD_FORMAT, _LOG or _CONST
+    uint8_t argc;                           // Number of packed arguments
+    uint8_t id;                             // print_log_id_t (LOG records)
+    const char *format;                     // Format string (static storage)
+    print_arg_t args[PRINT_PRINTF_MAX_ARGS];
+} print_record_t;
+
+#define PRINT_RECORD_SIZE(argc) (offsetof(print_record_t, args) + (argc) * sizeof(print_arg_t))
+
+#if PRINT_COALESCE_BUDGET < PRINT_MESSAGE_MAX_SIZE
+#error "PRINT_COALESCE_BUDGET must hold at least one maximum-size message"
+#endif
+
+/**
+ * Per-lane state
+ * Each lane is its own message buffer with its own writer lock, so a
+ * producer on one lane never waits behind a producer on the other.
+ */
+typedef struct {
+    MessageBufferHandle_t buffer;           // Lane storage
+    SemaphoreHandle_t write_lock;           // Serializes producers (single-writer buffer)
+    size_t size;                            // Buffer size in bytes
+    uint32_t messages_sent;                 // See print_lane_stats_t
+    uint32_t messages_dropped;
+    uint32_t max_depth_bytes;
+    uint32_t last_latency_ms;
+    uint32_t max_latency_ms;
+    TickType_t backlog_start;               // When the lane last went non-empty
+    BaseType_t backlog_active;              // Lane has undelivered messages
+} print_lane_state_t;
+
+/**
+ * Interrupt output ring (one per ISR source, see print_message_from_isr())
+ * Single producer (the ISR) and single consumer (the print task), so the
+ * free-running indices need no lock: head is written only by the ISR,
+ * tail only by the print task. Each message is a length byte + text.
+ */
+typedef struct {
+    uint8_t data[PRINT_ISR_RING_SIZE];
+    volatile uint16_t head;                 // Next write position (ISR)
+    volatile uint16_t tail;                 // Next read position (print task)
+    volatile uint32_t messages;             // Messages accepted (ISR)
+    volatile uint32_t dropped;              // Messages rejected, ring full (ISR)
+} print_isr_ring_t;
+
+#define PRINT_ISR_RING_MASK (PRINT_ISR_RING_SIZE - 1)
+
+#if (PRINT_ISR_RING_SIZE & PRINT_ISR_RING_MASK) != 0 || PRINT_ISR_RING_SIZE > 256
+#error "PRINT_ISR_RING_SIZE must be a power of two no larger than 256"
+#endif
+
+#if PRINT_ISR_MESSAGE_MAX_SIZE >= PRINT_ISR_RING_SIZE
+#error "PRINT_ISR_MESSAGE_MAX_SIZE must leave room for the length byte"
+#endif
 
 /* FreeRTOS Objects */
-QueueHandle_t print_queue = NULL;        // Message queue for print requests
-extern UART_HandleTypeDef huart2;        // UART2 peripheral handle (from main.c)
+MessageBufferHandle_t print_buffer = NULL;          // Bulk/UI lane message buffer
+MessageBufferHandle_t print_urgent_buffer = NULL;   // Urgent/diagnostic lane message buffer
+static TaskHandle_t print_task_handle = NULL;       // Woken by producers on every enqueue
+
+/* Lane table, indexed by print_lane_t */
+static print_lane_state_t print_lanes[PRINT_LANE_COUNT];
+
+/* Interrupt rings, indexed by print_isr_source_t */
+static print_isr_ring_t print_isr_rings[PRINT_ISR_SOURCE_COUNT];
+
+/* Double TX buffers: one drains over DMA while the other is filled
+ * (+1 byte of slack for the snprintf() terminator when expanding records) */
+static uint8_t tx_buffers[2][PRINT_COALESCE_BUDGET + 1];
+
+/* Log event format strings, indexed by print_log_id_t */
+static const char *const print_log_formats[LOG_COUNT] = {
+#define PRINT_LOG_FORMAT_ENTRY(name, format) format,
+    PRINT_LOG_TABLE(PRINT_LOG_FORMAT_ENTRY)
+#undef PRINT_LOG_FORMAT_ENTRY
+};
+
+/* Log output mode (pdTRUE = binary frames) */
+static volatile BaseType_t log_binary = PRINT_LOG_BINARY_DEFAULT ? pdTRUE : pdFALSE;
+
+/* Record that did not fit in the previous burst (expanded first next time) */
+static print_record_t carry_record;
+static BaseType_t carry_valid = pdFALSE;
+
+/* Print task is blocked waiting for work (everything gathered was sent) */
+static volatile BaseType_t print_idle = pdFALSE;
+
+/* Statistics (writer side updated in a critical section, since urgent and bulk
+ * writers hold different lane locks; reader side only by the print task) */
+static uint32_t stat_bytes_in = 0;
+static uint32_t stat_bytes_out = 0;
+static uint32_t stat_bytes_by_reference = 0;
+static uint32_t stat_tx_timeouts = 0;
+static uint32_t stat_tx_refused = 0;
+static uint32_t stat_tx_lost = 0;
+static uint32_t stat_bursts = 0;
+static uint32_t stat_burst_messages = 0;
+static uint32_t stat_burst_bytes = 0;
+static uint32_t stat_largest_burst = 0;
 
 /**
- * @brief  Initialize print task and message queue
+ * @brief  Enqueue a raw message into a print lane
+ * @param  lane: PRINT_LANE_URGENT or PRINT_LANE_BULK
+ * @param  data: Message bytes (not null-terminated)
+ * @param  length: Number of bytes (1..PRINT_MESSAGE_MAX_SIZE)
+ * @retval BaseType_t: pdPASS if queued, pdFAIL on timeout
+ *
+ * Common back end for every print API. The write lock and the buffer send
+ * share one PRINT_ENQUEUE_TIMEOUT_MS budget, so a caller never waits
+ * longer than before. Urgent producers never wait at all: an alert that
+ * cannot be queued at once is dropped and counted rather than stalling a
+ * high-priority reporter. The print task is notified after every enqueue
+ * because it waits on both lanes at once.
+ */
+static BaseType_t print_enqueue(print_lane_t lane, const void *data, size_t length)
+{
+    print_lane_state_t *state = &print_lanes[lane];
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = (lane == PRINT_LANE_URGENT) ? 0 : pdMS_TO_TICKS(PRINT_ENQUEUE_TIMEOUT_MS);
+
+    if (xSemaphoreTake(state->write_lock, timeout) != pdPASS) {
+        taskENTER_CRITICAL();
+        state->messages_dropped++;
+        taskEXIT_CRITICAL();
+        return pdFAIL;
+    }
+
+    // Spend whatever is left of the timeout waiting for buffer space
+    TickType_t waited = xTaskGetTickCount() - start;
+    TickType_t remaining = (waited < timeout) ? (timeout - waited) : 0;
+
+    size_t sent = xMessageBufferSend(state->buffer, data, length, remaining);
+    if (sent == length) {
+        uint32_t depth = state->size - xMessageBufferSpacesAvailable(state->buffer);
+
+        taskENTER_CRITICAL();
+        state->messages_sent++;
+        if (depth > state->max_depth_bytes) {
+            state->max_depth_bytes = depth;
+        }
+        if (!state->backlog_active) {
+            state->backlog_start = xTaskGetTickCount();
+            state->backlog_active = pdTRUE;
+        }
+        stat_bytes_in += length + PRINT_MSG_HEADER_SIZE;
+        taskEXIT_CRITICAL();
+    } else {
+        taskENTER_CRITICAL();
+        state->messages_dropped++;
+        taskEXIT_CRITICAL();
+    }
+
+    xSemaphoreGive(state->write_lock);
+
+    if (sent == length) {
+        xTaskNotifyGive(print_task_handle);
+        return pdPASS;
+    }
+    return pdFAIL;
+}
+
+/**
+ * @brief  Receive the next message of a lane into a TX burst
+ * @param  lane: Lane to read
+ * @param  dest: Destination in the burst
+ * @param  space: Bytes available at dest
+ * @retval Message length, or 0 if the lane is empty or the message does
+ *         not fit
+ *
+ * Also maintains the lane's latency counters. Latency is the age of the
+ * lane's backlog when a message is picked up - an upper bound on how long
+ * that message waited.
+ */
+static size_t print_lane_receive(print_lane_t lane, uint8_t *dest, size_t space)
+{
+    print_lane_state_t *state = &print_lanes[lane];
+    size_t received = xMessageBufferReceive(state->buffer, dest, space, 0);
+
+    taskENTER_CRITICAL();
+    if (received > 0 && state->backlog_active) {
+        uint32_t latency = pdTICKS_TO_MS(xTaskGetTickCount() - state->backlog_start);
+        state->last_latency_ms = latency;
+        if (latency > state->max_latency_ms) {
+            state->max_latency_ms = latency;
+        }
+    }
+    if (xMessageBufferIsEmpty(state->buffer)) {
+        state->backlog_active = pdFALSE;
+    }
+    taskEXIT_CRITICAL();
+
+    if (received > 0) {
+        stat_bytes_out += received + PRINT_MSG_HEADER_SIZE;
+    }
+    return received;
+}
+
+/**
+ * @brief  Initialize print task and message buffer
  * @note   Must be called BEFORE starting the scheduler
  * @retval None
  *
  * Creates:
- * 1. Print Queue - Message queue for passing strings to print task
- *    Size: PRINT_QUEUE_DEPTH × PRINT_MESSAGE_MAX_SIZE bytes
+ * 1. Print Buffers - One message buffer per lane
+ *    Size: PRINT_BUFFER_SIZE (bulk) + PRINT_URGENT_BUFFER_SIZE (urgent)
  *    Purpose: Decouples application tasks from UART transmission
  *
- * 2. Print Task - Dedicated task for UART TX operations
+ * 2. Write Locks - One mutex per lane serializing its producers
+ *    Purpose: Message buffers support only one concurrent writer
+ *
+ * 3. TX Port - DMA transmit completion signalling (print_port_init())
+ *
+ * 4. Print Task - Dedicated task for UART TX operations
  *    Priority: PRINT_TASK_PRIORITY (1) - lower than application tasks
  *    Stack: PRINT_TASK_STACK_SIZE (512 words)
  *    Purpose: Exclusive owner of UART TX hardware
  */
 void print_task_init(void)
 {
-    // Create message queue for print requests
-    // Queue holds complete messages (copied, not referenced)
-    print_queue = xQueueCreate(PRINT_QUEUE_DEPTH, PRINT_MESSAGE_MAX_SIZE);
-    configASSERT(print_queue != NULL);
+    static const size_t lane_sizes[PRINT_LANE_COUNT] = {
+        [PRINT_LANE_URGENT] = PRINT_URGENT_BUFFER_SIZE,
+        [PRINT_LANE_BULK]   = PRINT_BUFFER_SIZE,
+    };
+
+    for (int lane = 0; lane < PRINT_LANE_COUNT; lane++) {
+        print_lane_state_t *state = &print_lanes[lane];
+
+        // Create message buffer for this lane
+        // Buffer holds complete messages (copied, not referenced), each stored
+        // as a length header followed by exactly that many bytes
+        state->size = lane_sizes[lane];
+        state->buffer = xMessageBufferCreate(state->size);
+        configASSERT(state->buffer != NULL);
+
+        // Create writer lock (mutex gives priority inheritance to producers)
+        state->write_lock = xSemaphoreCreateMutex();
+        configASSERT(state->write_lock != NULL);
+    }
+
+    print_urgent_buffer = print_lanes[PRINT_LANE_URGENT].buffer;
+    print_buffer = print_lanes[PRINT_LANE_BULK].buffer;
+
+    // Prepare asynchronous (DMA) UART transmission
+    print_port_init();
 
     // Create print task
     // Priority 1: Lower than UART/Command tasks (printing not time-critical)
@@ -71,56 +385,220 @@ void print_task_init(void)
                                     PRINT_TASK_STACK_SIZE,
                                     NULL,
                                     PRINT_TASK_PRIORITY,
-                                    NULL);
+                                    &print_task_handle);
     configASSERT(status == pdPASS);
 }
 
 /**
- * @brief  Send a message to the print queue
+ * @brief  Send a message to the print buffer
  * @param  message: Null-terminated string to print
  * @retval BaseType_t: pdPASS if queued successfully, pdFAIL if timeout
  *
  * Behavior:
- * - Copies message into queue (safe to pass stack/local buffers)
- * - Blocks up to PRINT_ENQUEUE_TIMEOUT_MS if queue full
+ * - Copies strlen(message) bytes into the buffer (safe to pass stack/local
+ *   buffers); the terminator is not stored
+ * - Blocks up to PRINT_ENQUEUE_TIMEOUT_MS if buffer full
  * - Returns immediately after enqueuing (non-blocking for caller)
  * - Print task will transmit when scheduled
  *
  * Error Handling:
  * - If message exceeds PRINT_MESSAGE_MAX_SIZE, it will be truncated
- * - If queue full after timeout, returns pdFAIL (message dropped)
+ * - If buffer full after timeout, returns pdFAIL (message dropped)
  *
  * Thread Safety: Safe to call from any task
  */
 BaseType_t print_message(const char *message)
 {
-    char buffer[PRINT_MESSAGE_MAX_SIZE];
-
     // Validate input
     if (message == NULL) {
         return pdFAIL;
     }
 
-    // Copy message to local buffer with size limit
-    // strncpy ensures we don't overflow the buffer
-    strncpy(buffer, message, PRINT_MESSAGE_MAX_SIZE - 1);
-    buffer[PRINT_MESSAGE_MAX_SIZE - 1] = '\0';  // Ensure null termination
+    // Only the message itself is copied - no intermediate stack buffer
+    size_t length = strnlen(message, PRINT_MESSAGE_MAX_SIZE);
+    if (length == 0) {
+        return pdPASS;  // Nothing to print
+    }
 
-    // Send to queue (copies buffer into queue storage)
-    // Timeout prevents deadlock if queue unexpectedly fills
-    BaseType_t result = xQueueSend(print_queue, buffer, pdMS_TO_TICKS(PRINT_ENQUEUE_TIMEOUT_MS));
+    return print_enqueue(PRINT_LANE_BULK, message, length);
+}
 
-    return result;
+/**
+ * @brief  Send a message on the urgent lane
+ * @param  message: Null-terminated string to print
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL if timeout
+ *
+ * Same as print_message(), but the print task takes it ahead of any
+ * pending bulk output at the next message boundary. Never blocks.
+ */
+BaseType_t print_message_urgent(const char *message)
+{
+    if (message == NULL) {
+        return pdFAIL;
+    }
+
+    size_t length = strnlen(message, PRINT_MESSAGE_MAX_SIZE);
+    if (length == 0) {
+        return pdPASS;
+    }
+
+    return print_enqueue(PRINT_LANE_URGENT, message, length);
+}
+
+/**
+ * @brief  Send an immutable string by reference
+ * @param  message: Null-terminated string with static storage (literal)
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL if timeout
+ *
+ * Enqueues a pointer + length record instead of the text. The string is
+ * read by the print task when it builds the burst, so it must never
+ * change or go out of scope.
+ */
+BaseType_t print_const(const char *message)
+{
+    print_record_t record;
+
+    if (message == NULL) {
+        return pdFAIL;
+    }
+
+    size_t length = strnlen(message, PRINT_MESSAGE_MAX_SIZE);
+    if (length == 0) {
+        return pdPASS;
+    }
+
+    record.marker = PRINT_RECORD_MARKER;
+    record.type = PRINT_RECORD_CONST;
+    record.argc = 1;
+    record.id = 0;
+    record.format = message;
+    record.args[0] = (print_arg_t)length;
+
+    return print_enqueue(PRINT_LANE_BULK, &record, PRINT_RECORD_SIZE(record.argc));
 }
 
 /**
- * @brief  Send a single character to the print queue
+ * @brief  Append one message to an interrupt ring (ISR context)
+ * @param  ring: Ring owned by the calling ISR
+ * @param  data: Message bytes
+ * @param  length: Number of bytes (1..PRINT_ISR_MESSAGE_MAX_SIZE)
+ * @param  pxHigherPriorityTaskWoken: Set if the print task was woken
+ * @retval BaseType_t: pdPASS if queued, pdFAIL if the ring is full
+ *
+ * Bounded: at most PRINT_ISR_MESSAGE_MAX_SIZE + 1 byte stores, no loops
+ * on shared state, no locks. A message that does not fit is dropped
+ * whole and counted.
+ *
+ * The priority check comes first: an interrupt above the syscall
+ * priority must not touch the ring or notify the print task, even
+ * before the task exists.
+ */
+static BaseType_t print_isr_ring_put(print_isr_ring_t *ring, const void *data, size_t length,
+                                     BaseType_t *pxHigherPriorityTaskWoken)
+{
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    const uint8_t *bytes = data;
+    uint16_t head = ring->head;
+    uint16_t used = (uint16_t)(head - ring->tail);
+
+    if ((size_t)(PRINT_ISR_RING_SIZE - used) < length + 1) {
+        ring->dropped++;
+        return pdFAIL;
+    }
+
+    ring->data[head & PRINT_ISR_RING_MASK] = (uint8_t)length;
+    for (size_t i = 0; i < length; i++) {
+        ring->data[(head + 1 + i) & PRINT_ISR_RING_MASK] = bytes[i];
+    }
+
+    // Message bytes must be visible before the print task sees the new head
+    __DMB();
+    ring->head = (uint16_t)(head + 1 + length);
+    ring->messages++;
+
+    if (print_task_handle != NULL) {
+        vTaskNotifyGiveFromISR(print_task_handle, pxHigherPriorityTaskWoken);
+    }
+
+    return pdPASS;
+}
+
+/**
+ * @brief  Send a string message from interrupt context
+ * @param  source: Calling ISR's ring
+ * @param  message: Null-terminated string (max PRINT_ISR_MESSAGE_MAX_SIZE)
+ * @param  pxHigherPriorityTaskWoken: Set if a context switch is needed
+ * @retval BaseType_t: pdPASS if queued, pdFAIL if the ring is full
+ */
+BaseType_t print_message_from_isr(print_isr_source_t source, const char *message,
+                                  BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if ((unsigned)source >= PRINT_ISR_SOURCE_COUNT || message == NULL) {
+        return pdFAIL;
+    }
+
+    size_t length = strnlen(message, PRINT_ISR_MESSAGE_MAX_SIZE);
+    if (length == 0) {
+        return pdPASS;
+    }
+
+    return print_isr_ring_put(&print_isr_rings[source], message, length,
+                              pxHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief  Send raw bytes from interrupt context
+ * @param  source: Calling ISR's ring
+ * @param  data: Bytes to print (need not be null-terminated)
+ * @param  length: Number of bytes (1..PRINT_ISR_MESSAGE_MAX_SIZE)
+ * @param  pxHigherPriorityTaskWoken: Set if a context switch is needed
+ * @retval BaseType_t: pdPASS if queued, pdFAIL if the ring is full or
+ *         length is out of range
+ */
+BaseType_t print_write_from_isr(print_isr_source_t source, const void *data, size_t length,
+                                BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if ((unsigned)source >= PRINT_ISR_SOURCE_COUNT || data == NULL ||
+        length > PRINT_ISR_MESSAGE_MAX_SIZE) {
+        return pdFAIL;
+    }
+    if (length == 0) {
+        return pdPASS;
+    }
+
+    return print_isr_ring_put(&print_isr_rings[source], data, length,
+                              pxHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief  Send a single character from interrupt context
+ * @param  source: Calling ISR's ring
+ * @param  c: Character to print
+ * @param  pxHigherPriorityTaskWoken: Set if a context switch is needed
+ * @retval BaseType_t: pdPASS if queued, pdFAIL if the ring is full
+ */
+BaseType_t print_char_from_isr(print_isr_source_t source, char c,
+                               BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if ((unsigned)source >= PRINT_ISR_SOURCE_COUNT) {
+        return pdFAIL;
+    }
+    if (c == '\0') {
+        return pdPASS;
+    }
+
+    return print_isr_ring_put(&print_isr_rings[source], &c, 1, pxHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief  Send a single character to the print buffer
  * @param  c: Character to print
  * @retval BaseType_t: pdPASS if queued successfully, pdFAIL if timeout
  *
  * Behavior:
  * - Optimized for single character printing (echo use case)
- * - Creates minimal message: [character, null terminator]
+ * - Enqueues a 1-byte message (plus the 4-byte length header)
  * - Returns immediately after enqueuing
  *
  * Use Case:
@@ -129,33 +607,645 @@ BaseType_t print_message(const char *message)
  */
 BaseType_t print_char(char c)
 {
-    char buffer[2];
+    // NUL would be mistaken for a control record marker (and prints nothing)
+    if (c == '\0') {
+        return pdPASS;
+    }
+
+    return print_enqueue(PRINT_LANE_BULK, &c, 1);
+}
+
+/**
+ * @brief  Send a run of raw bytes to the print buffer
+ * @param  data: Bytes to print
+ * @param  length: Number of bytes (0..PRINT_MESSAGE_MAX_SIZE)
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL if timeout
+ *
+ * Task-context counterpart of print_write_from_isr(), used for echoing a
+ * received run of text in one message.
+ */
+BaseType_t print_write(const void *data, size_t length)
+{
+    const uint8_t *bytes = data;
+
+    if (data == NULL || length > PRINT_MESSAGE_MAX_SIZE) {
+        return pdFAIL;
+    }
+
+    // A leading NUL would be mistaken for a control record marker
+    while (length > 0 && bytes[0] == '\0') {
+        bytes++;
+        length--;
+    }
+    if (length == 0) {
+        return pdPASS;
+    }
+
+    return print_enqueue(PRINT_LANE_BULK, bytes, length);
+}
+
+/**
+ * @brief  Send binary data that may contain NUL bytes
+ * @param  data: Bytes to send unchanged
+ * @param  length: Number of bytes (max PRINT_BINARY_MAX_SIZE)
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL if timeout or
+ *         too long
+ *
+ * The marker and type byte let the print task tell the data apart from
+ * text; it strips them in place when building the burst.
+ */
+BaseType_t print_write_binary(const void *data, size_t length)
+{
+    uint8_t message[2 + PRINT_BINARY_MAX_SIZE];
+
+    if (data == NULL || length > PRINT_BINARY_MAX_SIZE) {
+        return pdFAIL;
+    }
+    if (length == 0) {
+        return pdPASS;
+    }
+
+    message[0] = PRINT_RECORD_MARKER;
+    message[1] = PRINT_RECORD_BYTES;
+    memcpy(&message[2], data, length);
+
+    return print_enqueue(PRINT_LANE_BULK, message, 2 + length);
+}
+
+/* Position in a format string while its arguments are counted */
+typedef struct {
+    const char *p;
+    BaseType_t in_spec;         // Stopped at a '*' inside a conversion
+} print_format_scan_t;
+
+/**
+ * @brief  Find the next argument-consuming item in a format string
+ * @param  scan: [IN/OUT] Scan state (p = format, in_spec = pdFALSE to start)
+ * @retval Conversion specifier character, '*' for a '*' width or
+ *         precision, or '\0' at end of string
+ *
+ * "%%" is skipped, as are flags, width, precision and length modifiers.
+ * A '*' takes an argument of its own, before the conversion's one, so
+ * "%*d" yields '*' and then 'd' (the order vsnprintf() reads them in).
+ */
+static char print_next_conversion(print_format_scan_t *scan)
+{
+    const char *p = scan->p;
+
+    while (*p != '\0') {
+        if (!scan->in_spec) {
+            if (*p++ != '%') {
+                continue;
+            }
+            if (*p == '%') {
+                p++;    // Literal percent
+                continue;
+            }
+        }
+        scan->in_spec = pdFALSE;
+
+        // Skip flags, width, precision and length modifiers
+        while (*p != '\0' && strchr("-+ #0123456789.hlLzjt", *p) != NULL) {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        if (*p == '*') {
+            scan->in_spec = pdTRUE;     // The conversion follows
+        }
+
+        scan->p = p + 1;
+        return *p;
+    }
+
+    scan->p = p;
+    scan->in_spec = pdFALSE;
+    return '\0';
+}
+
+/**
+ * @brief  Build and enqueue a control record
+ * @param  lane: Destination lane
+ * @param  type: PRINT_RECORD_FORMAT or PRINT_RECORD_LOG
+ * @param  id: Log event ID (LOG records only)
+ * @param  format: Format string describing the arguments
+ * @param  ap: Caller's argument list
+ * @retval BaseType_t: pdPASS if queued, pdFAIL on timeout
+ *
+ * Each conversion and each '*' consumes one argument word; arguments beyond
+ * PRINT_PRINTF_MAX_ARGS are dropped.
+ */
+static BaseType_t print_enqueue_record(print_lane_t lane, uint8_t type, uint8_t id,
+                                       const char *format, va_list ap)
+{
+    print_record_t record;
+    print_format_scan_t scan = { format, pdFALSE };
+
+    record.marker = PRINT_RECORD_MARKER;
+    record.type = type;
+    record.argc = 0;
+    record.id = id;
+    record.format = format;
+
+    while (record.argc < PRINT_PRINTF_MAX_ARGS && print_next_conversion(&scan) != '\0') {
+        record.args[record.argc++] = va_arg(ap, print_arg_t);
+    }
 
-    // Create 2-byte message: character + null terminator
-    buffer[0] = c;
-    buffer[1] = '\0';
+    return print_enqueue(lane, &record, PRINT_RECORD_SIZE(record.argc));
+}
 
-    // Send to queue
-    BaseType_t result = xQueueSend(print_queue, buffer, pdMS_TO_TICKS(PRINT_ENQUEUE_TIMEOUT_MS));
+/**
+ * @brief  Enqueue a format string and its arguments for deferred formatting
+ * @param  format: printf-style format string with static storage duration
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL if timeout
+ *
+ * Caller-side cost is one pass over the format string to count
+ * conversions, copying each argument as one word, and enqueuing
+ * 8 + 4 × argc bytes. snprintf() runs later in the print task.
+ */
+BaseType_t print_printf(const char *format, ...)
+{
+    va_list ap;
+    BaseType_t result;
+
+    if (format == NULL) {
+        return pdFAIL;
+    }
+
+    va_start(ap, format);
+    result = print_enqueue_record(PRINT_LANE_BULK, PRINT_RECORD_FORMAT, 0, format, ap);
+    va_end(ap);
 
     return result;
 }
 
 /**
- * @brief  Print task main loop - processes messages from queue
+ * @brief  Log a tokenized event (text or binary decided by the print task)
+ * @param  id: Event ID from PRINT_LOG_TABLE
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL otherwise
+ */
+BaseType_t print_log(print_log_id_t id, ...)
+{
+    va_list ap;
+    BaseType_t result;
+
+    if ((unsigned)id >= LOG_COUNT) {
+        return pdFAIL;
+    }
+
+    va_start(ap, id);
+    result = print_enqueue_record(PRINT_LANE_BULK, PRINT_RECORD_LOG, (uint8_t)id,
+                                  print_log_formats[id], ap);
+    va_end(ap);
+
+    return result;
+}
+
+/**
+ * @brief  Log a tokenized event on the urgent lane
+ * @param  id: Event ID from PRINT_LOG_TABLE
+ * @retval BaseType_t: pdPASS if queued successfully, pdFAIL otherwise
+ */
+BaseType_t print_log_urgent(print_log_id_t id, ...)
+{
+    va_list ap;
+    BaseType_t result;
+
+    if ((unsigned)id >= LOG_COUNT) {
+        return pdFAIL;
+    }
+
+    va_start(ap, id);
+    result = print_enqueue_record(PRINT_LANE_URGENT, PRINT_RECORD_LOG, (uint8_t)id,
+                                  print_log_formats[id], ap);
+    va_end(ap);
+
+    return result;
+}
+
+const char *print_log_format(print_log_id_t id)
+{
+    return ((unsigned)id < LOG_COUNT) ? print_log_formats[id] : "";
+}
+
+void print_log_set_binary(BaseType_t enable)
+{
+    log_binary = enable ? pdTRUE : pdFALSE;
+}
+
+/**
+ * @brief  Check that no output is left anywhere in the print path
+ */
+static BaseType_t print_is_drained(void)
+{
+    if (!print_idle || carry_valid || print_port_is_busy()) {
+        return pdFALSE;
+    }
+    for (int lane = 0; lane < PRINT_LANE_COUNT; lane++) {
+        if (!xMessageBufferIsEmpty(print_lanes[lane].buffer)) {
+            return pdFALSE;
+        }
+    }
+    for (int source = 0; source < PRINT_ISR_SOURCE_COUNT; source++) {
+        if (print_isr_rings[source].head != print_isr_rings[source].tail) {
+            return pdFALSE;
+        }
+    }
+    return pdTRUE;
+}
+
+BaseType_t print_flush(TickType_t timeout)
+{
+    TickType_t start = xTaskGetTickCount();
+
+    while (!print_is_drained()) {
+        if ((xTaskGetTickCount() - start) >= timeout) {
+            return pdFAIL;
+        }
+        vTaskDelay(1);
+    }
+    return pdPASS;
+}
+
+/**
+ * @brief  Get the print task handle
+ * @retval Task handle, or NULL before print_task_init()
+ */
+TaskHandle_t print_task_get_handle(void)
+{
+    return print_task_handle;
+}
+
+/**
+ * @brief  Get print pipeline statistics
+ * @param  stats: [OUT] Snapshot of the counters
+ * @retval None
+ */
+void print_get_stats(print_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    stats->messages_sent = print_lanes[PRINT_LANE_URGENT].messages_sent +
+                           print_lanes[PRINT_LANE_BULK].messages_sent;
+    stats->messages_dropped = print_lanes[PRINT_LANE_URGENT].messages_dropped +
+                              print_lanes[PRINT_LANE_BULK].messages_dropped;
+    stats->bytes_copied = stat_bytes_in + stat_bytes_out;
+    stats->bytes_by_reference = stat_bytes_by_reference;
+    stats->isr_messages = 0;
+    stats->isr_dropped = 0;
+    for (int source = 0; source < PRINT_ISR_SOURCE_COUNT; source++) {
+        stats->isr_messages += print_isr_rings[source].messages;
+        stats->isr_dropped += print_isr_rings[source].dropped;
+    }
+    stats->tx_timeouts = stat_tx_timeouts;
+    stats->tx_refused = stat_tx_refused;
+    stats->tx_lost = stat_tx_lost;
+    stats->bursts = stat_bursts;
+    stats->burst_messages = stat_burst_messages;
+    stats->burst_bytes = stat_burst_bytes;
+    stats->wakeups_saved = stat_burst_messages - stat_bursts;
+    stats->largest_burst = stat_largest_burst;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief  Get depth and latency counters of one lane
+ * @param  lane: PRINT_LANE_URGENT or PRINT_LANE_BULK
+ * @param  stats: [OUT] Snapshot of the counters
+ * @retval None
+ */
+void print_get_lane_stats(print_lane_t lane, print_lane_stats_t *stats)
+{
+    if (stats == NULL || (unsigned)lane >= PRINT_LANE_COUNT) {
+        return;
+    }
+
+    print_lane_state_t *state = &print_lanes[lane];
+    uint32_t depth = state->size - xMessageBufferSpacesAvailable(state->buffer);
+
+    taskENTER_CRITICAL();
+    stats->messages_sent = state->messages_sent;
+    stats->messages_dropped = state->messages_dropped;
+    stats->depth_bytes = depth;
+    stats->max_depth_bytes = state->max_depth_bytes;
+    stats->last_latency_ms = state->last_latency_ms;
+    stats->max_latency_ms = state->max_latency_ms;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief  Encode a log record as a binary frame (see print_log.h)
+ * @param  record: LOG record
+ * @param  dest: Current end of the burst
+ * @param  space: Bytes left in the coalescing budget
+ * @param  written: [OUT] Number of bytes produced
+ * @retval BaseType_t: pdTRUE if encoded, pdFALSE if it did not fit
+ *
+ * Frames are never truncated (a cut frame would desynchronize the host
+ * decoder). Log arguments are short (task names, numbers), so frames are
+ * tens of bytes; the payload length byte caps a frame at 258 bytes.
+ */
+static BaseType_t print_encode_log_frame(const print_record_t *record, uint8_t *dest,
+                                         size_t space, size_t *written)
+{
+    print_format_scan_t scan = { record->format, pdFALSE };
+    size_t length = 3;      // Sync, ID, payload length
+
+    for (uint8_t i = 0; i < record->argc; i++) {
+        char conversion = print_next_conversion(&scan);
+
+        if (conversion == 's') {
+            const char *str = (const char *)record->args[i];
+            size_t str_len = (str != NULL) ? strnlen(str, 255) : 0;
+
+            if (length + 1 + str_len > space) {
+                return pdFALSE;
+            }
+            dest[length++] = (uint8_t)str_len;
+            memcpy(&dest[length], str, str_len);
+            length += str_len;
+        } else {
+            uint32_t value = (uint32_t)record->args[i];
+
+            if (length + 4 > space) {
+                return pdFALSE;
+            }
+            dest[length++] = (uint8_t)(value);
+            dest[length++] = (uint8_t)(value >> 8);
+            dest[length++] = (uint8_t)(value >> 16);
+            dest[length++] = (uint8_t)(value >> 24);
+        }
+    }
+
+    if (length - 3 > 255 || length > space) {
+        return pdFALSE;
+    }
+
+    dest[0] = PRINT_LOG_SYNC;
+    dest[1] = record->id;
+    dest[2] = (uint8_t)(length - 3);
+    *written = length;
+    return pdTRUE;
+}
+
+/**
+ * @brief  Expand a control record into a TX burst
+ * @param  record: Record received from print_printf(), print_log() or
+ *                 print_const()
+ * @param  dest: Current end of the burst
+ * @param  space: Bytes left in the coalescing budget
+ * @param  truncate: pdTRUE to cut oversized output, pdFALSE to refuse it
+ * @param  written: [OUT] Number of bytes produced
+ * @retval BaseType_t: pdTRUE if expanded, pdFALSE if it did not fit
+ *
+ * All PRINT_PRINTF_MAX_ARGS words are passed; the format string consumes
+ * only the ones it references. The TX buffers carry one byte of slack so
+ * snprintf() can place its terminator past the budget.
+ */
+static BaseType_t print_expand_record(const print_record_t *record, uint8_t *dest,
+                                      size_t space, BaseType_t truncate, size_t *written)
+{
+    const print_arg_t *a = record->args;
+
+    // Constant strings are copied straight from flash - no formatting
+    if (record->type == PRINT_RECORD_CONST) {
+        size_t length = (size_t)a[0];
+        if (length > space) {
+            if (!truncate) {
+                return pdFALSE;
+            }
+            length = space;
+        }
+        memcpy(dest, record->format, length);
+        stat_bytes_by_reference += length;
+        *written = length;
+        return pdTRUE;
+    }
+
+    // Log events in binary mode go out as frames instead of text
+    if (record->type == PRINT_RECORD_LOG && log_binary) {
+        if (print_encode_log_frame(record, dest, space, written)) {
+            return pdTRUE;
+        }
+        if (!truncate) {
+            return pdFALSE;
+        }
+        *written = 0;      // Cannot fit even in an empty burst - drop it
+        return pdTRUE;
+    }
+
+    int result = snprintf((char *)dest, space + 1, record->format,
+                          a[0], a[1], a[2], a[3], a[4], a[5]);
+    if (result < 0) {
+        *written = 0;      // Encoding error - drop the record
+        return pdTRUE;
+    }
+
+    if ((size_t)result > space) {
+        if (!truncate) {
+            return pdFALSE;
+        }
+        result = (int)space;
+    }
+
+    *written = (size_t)result;
+    return pdTRUE;
+}
+
+/**
+ * @brief  Move the next interrupt message into a TX burst
+ * @param  dest: Destination in the burst
+ * @param  space: Bytes available at dest
+ * @param  pending: [OUT] pdTRUE if a message is waiting but does not fit
+ * @retval Message length, or 0 if nothing was moved
+ *
+ * Rings are served in source order. Only whole messages are moved, so
+ * interrupt text never interleaves with task output.
+ */
+static size_t print_isr_receive(uint8_t *dest, size_t space, BaseType_t *pending)
+{
+    *pending = pdFALSE;
+
+    for (int source = 0; source < PRINT_ISR_SOURCE_COUNT; source++) {
+        print_isr_ring_t *ring = &print_isr_rings[source];
+        uint16_t tail = ring->tail;
+
+        if (ring->head == tail) {
+            continue;
+        }
+
+        // Read the ISR's bytes only after observing its head update
+        __DMB();
+        size_t length = ring->data[tail & PRINT_ISR_RING_MASK];
+        if (length > space) {
+            *pending = pdTRUE;
+            return 0;
+        }
+
+        for (size_t i = 0; i < length; i++) {
+            dest[i] = ring->data[(tail + 1 + i) & PRINT_ISR_RING_MASK];
+        }
+
+        // Finish reading before handing the space back to the ISR
+        __DMB();
+        ring->tail = (uint16_t)(tail + 1 + length);
+        return length;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  Gather pending messages into a TX burst
+ * @param  burst: Start of the TX buffer
+ * @param  length: Bytes already in the burst
+ * @param  messages: [IN/OUT] Message count of the burst
+ * @retval New burst length
+ *
+ * Never blocks; the caller waits for the producers' task notification.
+ * Interrupt rings, then the urgent lane, are checked first at every
+ * message boundary, so an alert overtakes pending bulk output as soon as
+ * the current message is done.
+ *
+ * Text messages are received straight into the burst. Deferred-format
+ * records (first byte PRINT_RECORD_MARKER) are received into the same
+ * place, copied out, and formatted over their own bytes. Inline binary
+ * records only lose their 2-byte header.
+ *
+ * Stops at the first message that does not fit in the remaining space.
+ * xMessageBufferReceive() leaves an oversized text message in the buffer;
+ * a record whose formatted text does not fit is carried over. Either way
+ * FIFO order within the lane is preserved and that message starts the
+ * next burst. An urgent message that does not fit also ends the burst, so
+ * bulk output never slips in ahead of it.
+ */
+static size_t print_fill_burst(uint8_t *burst, size_t length, uint32_t *messages)
+{
+    size_t written;
+
+    // A record deferred from the previous burst keeps its place in line
+    if (carry_valid) {
+        if (!print_expand_record(&carry_record, burst + length,
+                                 PRINT_COALESCE_BUDGET - length, length == 0, &written)) {
+            return length;
+        }
+        carry_valid = pdFALSE;
+        length += written;
+        (*messages)++;
+    }
+
+    while (length < PRINT_COALESCE_BUDGET) {
+        uint8_t *dest = burst + length;
+        size_t space = PRINT_COALESCE_BUDGET - length;
+        BaseType_t isr_pending;
+        size_t received = print_isr_receive(dest, space, &isr_pending);
+
+        if (received > 0) {
+            length += received;
+            (*messages)++;
+            continue;
+        }
+        if (isr_pending) {
+            break;  // Interrupt message too large for this burst - send it next
+        }
+
+        received = print_lane_receive(PRINT_LANE_URGENT, dest, space);
+
+        if (received == 0) {
+            if (!xMessageBufferIsEmpty(print_urgent_buffer)) {
+                break;  // Urgent message too large for this burst - send it next
+            }
+            received = print_lane_receive(PRINT_LANE_BULK, dest, space);
+            if (received == 0) {
+                break;  // Both lanes empty or next message too large for this burst
+            }
+        }
+
+        if (dest[0] != PRINT_RECORD_MARKER) {
+            // Plain text - already in place
+            length += received;
+            (*messages)++;
+            continue;
+        }
+
+        if (received >= 2 && dest[1] == PRINT_RECORD_BYTES) {
+            // Inline binary data - already in place behind the 2-byte header
+            memmove(dest, dest + 2, received - 2);
+            length += received - 2;
+            (*messages)++;
+            continue;
+        }
+
+        // Deferred-format record - copy out before formatting over it
+        memset(&carry_record, 0, sizeof(carry_record));
+        memcpy(&carry_record, dest,
+               (received < sizeof(carry_record)) ? received : sizeof(carry_record));
+
+        if (!print_expand_record(&carry_record, dest,
+                                 PRINT_COALESCE_BUDGET - length, length == 0, &written)) {
+            carry_valid = pdTRUE;   // Goes first in the next burst
+            break;
+        }
+        length += written;
+        (*messages)++;
+    }
+
+    return length;
+}
+
+/**
+ * @brief  Hand a burst to the TX port, retrying a refused start
+ * @param  burst: TX buffer
+ * @param  length: Bytes in the burst
+ * @retval BaseType_t: pdPASS if the transfer started, pdFAIL if the
+ *         burst was discarded
+ *
+ * Every refusal is counted. The start is retried one tick later, up to
+ * PRINT_TX_START_RETRIES times; after that the burst is dropped so the
+ * lanes keep draining instead of backing up behind a stuck UART.
+ */
+static BaseType_t print_start_burst(const uint8_t *burst, size_t length)
+{
+    for (int attempt = 0; ; attempt++) {
+        if (print_port_transmit(burst, (uint16_t)length) == pdPASS) {
+            return pdPASS;
+        }
+        stat_tx_refused++;
+        if (attempt >= PRINT_TX_START_RETRIES) {
+            break;
+        }
+        vTaskDelay(1);
+    }
+
+    stat_tx_lost++;
+    return pdFAIL;
+}
+
+/**
+ * @brief  Print task main loop - processes messages from buffer
  * @param  parameters: Task parameters (unused)
  * @retval None (task never returns)
  *
  * Task Behavior:
- * 1. Block waiting for message in queue (portMAX_DELAY = infinite wait)
- * 2. When message arrives:
- *    - Dequeue message into local buffer
- *    - Transmit via HAL_UART_Transmit()
- *    - Loop back to wait for next message
+ * 1. Block on the task notification given by every enqueue (2s timeout for
+ *    watchdog feeding), so one wait covers both lanes
+ * 2. When a message arrives:
+ *    - Dequeue it and every other pending message into the free TX buffer,
+ *      urgent lane first at each message boundary
+ *    - Wait for the previous DMA transfer to finish (usually already done)
+ *    - Top up the burst with messages that arrived during the wait
+ *    - Start DMA transfer of this buffer and swap buffers
+ *    - Loop back to wait for next message while DMA drains
  *
  * Features:
- * - FIFO message ordering (queue guarantees)
- * - Processes all queued messages before blocking
+ * - FIFO message ordering within each lane (message buffer guarantees)
+ * - Urgent output waits for at most the burst in flight plus the one
+ *   being filled, regardless of bulk backlog
+ * - Processes all queued messages before blocking, one burst per wakeup
  * - Yields to higher priority tasks between messages
  *
  * UART Access:
@@ -164,19 +1254,21 @@ BaseType_t print_char(char c)
  * - No mutex needed (single owner of hardware resource)
  *
  * Error Handling:
- * - If HAL_UART_Transmit() fails, message is discarded
- * - Could add error logging or LED indication in future
+ * - If the DMA transfer cannot start, it is retried one tick later (up
+ *   to PRINT_TX_START_RETRIES times), then the burst is discarded; both
+ *   are counted (tx_refused, tx_lost)
+ * - If TX completion never arrives, the transfer is aborted after
+ *   PRINT_PORT_TX_TIMEOUT_MS and counted in tx_timeouts
  *
  * Performance Notes:
- * - Priority 1 ensures higher priority tasks (UART RX, Command Handler)
- *   can preempt this task
+ * - Message length comes from the buffer header, so no strlen() scan
  * - UART transmission time: ~87μs per character @ 115200 baud
  * - Longest message (menu): ~400 chars = ~35ms transmission time
- * - During transmission, higher priority tasks can still run
+ * - During transmission this task is BLOCKED - all tasks can run
  */
 void print_task_handler(void *parameters)
 {
-    char message_buffer[PRINT_MESSAGE_MAX_SIZE];
+    uint8_t fill_index = 0;     // TX buffer currently being filled
 
     // Register with watchdog (5 second timeout = 2.5× the 2s blocking period)
     watchdog_id_t wd_id = watchdog_register("Print_Task", 5000);
@@ -189,27 +1281,55 @@ void print_task_handler(void *parameters)
         /*
          * Main Print Loop
          * ---------------
-         * Block waiting for messages in the queue. When a message arrives,
-         * dequeue it and transmit via UART. This task owns UART TX exclusively.
+         * Block waiting for messages in the buffer. When a message arrives,
+         * dequeue it and transmit via UART DMA. This task owns UART TX
+         * exclusively.
          *
          * Flow:
-         * 1. Block on queue (task sleeps, no CPU usage)
+         * 1. Block on notification (task sleeps, no CPU usage)
          * 2. Message available -> task wakes up
-         * 3. Dequeue message into local buffer
-         * 4. Transmit message via UART
-         * 5. Return to step 1
+         * 3. Drain all pending messages into the free TX buffer
+         * 4. Wait for the other buffer's DMA transfer to complete
+         * 5. Drain anything that arrived meanwhile (same budget)
+         * 6. Start DMA transfer, swap buffers, return to step 1
          */
 
-        // Block waiting for message with finite timeout
+        // Block waiting for message with finite timeout, then gather
+        // everything else already pending into the same burst
         // Timeout allows periodic watchdog feeding even when no print activity
-        if (xQueueReceive(print_queue, message_buffer, pdMS_TO_TICKS(2000)) == pdPASS) {
-            // Message received - transmit it
-            // HAL_MAX_DELAY: Wait indefinitely for UART to be ready
-            // This is safe because we're the only task using UART TX
-            HAL_UART_Transmit(&huart2,
-                            (uint8_t *)message_buffer,
-                            strlen(message_buffer),
-                            HAL_MAX_DELAY);
+        uint8_t *burst = tx_buffers[fill_index];
+        uint32_t messages = 0;
+        size_t length = print_fill_burst(burst, 0, &messages);
+
+        if (messages == 0) {
+            print_idle = pdTRUE;
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(2000));
+            print_idle = pdFALSE;
+            length = print_fill_burst(burst, 0, &messages);
+        }
+
+        if (messages > 0) {
+            // Previous buffer may still be draining - block (not poll)
+            // until its TX-complete interrupt fires
+            if (print_port_wait_idle(pdMS_TO_TICKS(PRINT_PORT_TX_TIMEOUT_MS)) != pdPASS) {
+                stat_tx_timeouts++;
+            }
+
+            // Messages queued while we waited ride along at no extra cost
+            length = print_fill_burst(burst, length, &messages);
+
+            // Burst statistics
+            stat_bursts++;
+            stat_burst_messages += messages;
+            stat_burst_bytes += length;
+            if (messages > stat_largest_burst) {
+                stat_largest_burst = messages;
+            }
+
+            // Hand this buffer to DMA and fill the other one next
+            if (print_start_burst(burst, length) == pdPASS) {
+                fill_index ^= 1;
+            }
         }
 
         // Feed watchdog to prove task is alive
@@ -0,0 +1,90 @@
+/**
+ ******************************************************************************
+ * @file           : uart_baud.c
+ * @brief          : Baud Rate Table and Auto-Baud Estimation
+ ******************************************************************************
+ * @description
+ * See uart_baud.h for the measurement. Only integer arithmetic: the edge
+ * times are CPU cycles, so span / bits is exact to a cycle and the rate
+ * is rounded once at the end.
+ ******************************************************************************
+ */
+
+#include "uart_baud.h"
+
+/* Supported rates, ascending */
+static const uint32_t uart_baud_rates[] = {
+    9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600, 2000000,
+};
+
+#define UART_BAUD_RATE_COUNT (sizeof(uart_baud_rates) / sizeof(uart_baud_rates[0]))
+
+int uart_baud_supported(uint32_t baud)
+{
+    for (size_t i = 0; i < UART_BAUD_RATE_COUNT; i++) {
+        if (uart_baud_rates[i] == baud) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+uint32_t uart_baud_nearest(uint32_t measured)
+{
+    for (size_t i = 0; i < UART_BAUD_RATE_COUNT; i++) {
+        uint32_t rate = uart_baud_rates[i];
+        uint32_t error = (measured > rate) ? measured - rate : rate - measured;
+
+        // Neighbouring rates are at least 1.5x apart, so at most one matches
+        if ((uint64_t)error * 100 <= (uint64_t)rate * UART_BAUD_TOLERANCE_PERCENT) {
+            return rate;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  Check that the gaps are whole numbers of bits (+-1/4 bit each)
+ *         adding up to the given number of bits
+ */
+static int uart_baud_fits(const uint32_t *edges, size_t count, uint32_t span, uint32_t bits)
+{
+    uint32_t total = 0;
+
+    for (size_t i = 1; i < count; i++) {
+        // Gap in bits is run * bits / span; compare against the nearest integer
+        uint64_t scaled = (uint64_t)(edges[i] - edges[i - 1]) * bits;
+        uint64_t whole = (scaled + span / 2) / span;
+        uint64_t target = whole * span;
+        uint64_t error = (scaled > target) ? scaled - target : target - scaled;
+
+        if (whole == 0 || error * 4 > span) {
+            return 0;
+        }
+        total += (uint32_t)whole;
+    }
+    return total == bits;
+}
+
+uint32_t uart_baud_estimate(const uint32_t *edges, size_t count, uint32_t clock_hz)
+{
+    if (count < 2) {
+        return 0;
+    }
+
+    uint32_t span = edges[count - 1] - edges[0];
+    if (span == 0) {
+        return 0;
+    }
+
+    // The fewest bits that explain every gap, i.e. the shortest gap is one
+    // bit. The edges after the start edge lie on bits 1-9, so the span is
+    // at most 8 bits.
+    for (uint32_t bits = 1; bits < UART_BAUD_MAX_EDGES; bits++) {
+        if (uart_baud_fits(edges, count, span, bits)) {
+            uint32_t measured = (uint32_t)(((uint64_t)clock_hz * bits + span / 2) / span);
+            return uart_baud_nearest(measured);
+        }
+    }
+    return 0;
+}
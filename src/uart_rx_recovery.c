@@ -0,0 +1,53 @@
+/**
+ ******************************************************************************
+ * @file           : uart_rx_recovery.c
+ * @brief          : RX Error Accounting and Re-arm Decision
+ ******************************************************************************
+ * @description
+ * One error can carry several flags (noise with a framing error is
+ * common), so each flag is counted on its own. A re-arm counts as a
+ * restart only when an error asked for it; the liveness check counts its
+ * own re-arms as stalls instead.
+ ******************************************************************************
+ */
+
+#include "uart_rx_recovery.h"
+
+uart_rx_action_t uart_rx_recovery_error(uart_rx_recovery_t *rx, uint32_t errors, int stopped)
+{
+    if (errors & UART_RX_ERROR_PE)  rx->parity++;
+    if (errors & UART_RX_ERROR_NE)  rx->noise++;
+    if (errors & UART_RX_ERROR_FE)  rx->framing++;
+    if (errors & UART_RX_ERROR_ORE) rx->overrun++;
+    if (errors & UART_RX_ERROR_DMA) rx->dma++;
+
+    if (!stopped) {
+        return UART_RX_KEEP;
+    }
+    rx->after_error = 1;
+    return UART_RX_RESTART;
+}
+
+uart_rx_action_t uart_rx_recovery_rearmed(uart_rx_recovery_t *rx, int started)
+{
+    uint8_t after_error = rx->after_error;
+
+    rx->after_error = 0;
+    if (!started) {
+        rx->rearm_failures++;
+        return UART_RX_RETRY;
+    }
+    if (after_error) {
+        rx->restarts++;
+    }
+    return UART_RX_KEEP;
+}
+
+uart_rx_action_t uart_rx_recovery_check(uart_rx_recovery_t *rx, int armed)
+{
+    if (armed) {
+        return UART_RX_KEEP;
+    }
+    rx->stalls++;
+    return UART_RX_RESTART;
+}
@@ -5,28 +5,43 @@
  ******************************************************************************
  * @description
  * This module implements an efficient interrupt-driven UART reception task
- * using FreeRTOS Stream Buffers. It handles character-by-character input
- * with echo and command buffering.
+ * using FreeRTOS Stream Buffers. It drains received input in blocks and
+ * assembles commands with echo and line editing.
  *
  * Architecture:
  * ┌─────────────┐     ┌──────────────┐     ┌──────────────┐
- * │ UART RX ISR │ ──> │ Stream Buffer│ ──> │  UART Task   │
- * │  (Instant)  │     │  (Lock-free) │     │  (BLOCKED)   │
+ * │ UART RX DMA │ ──> │ Stream Buffer│ ──> │  UART Task   │
+ * │ + IDLE ISR  │     │  (Lock-free) │     │  (BLOCKED)   │
  * └─────────────┘     └──────────────┘     └──────────────┘
  *
  * Key Features:
  * - TRUE task blocking (yields CPU when idle)
- * - Interrupt-driven reception (zero CPU waste)
+ * - Circular DMA reception: one interrupt per burst (idle line) or half
+ *   buffer instead of one per byte
  * - Command buffering with overflow protection
  * - Backspace handling
- * - Queue-based command passing to handler task
+ * - Block reads from the stream buffer, split into text runs with a
+ *   word-at-a-time scanner (line_scan.h)
+ * - Commands are assembled in place in a pool of line buffers; only the
+ *   buffer index is queued to the handler task
+ * - Binary command frames (COBS + CRC-16, cmd_frame.h) recognised next to
+ *   typed input: a 0x00 delimiter switches to frame mode, frames are
+ *   never echoed or edited, and decoded frames share the command queue
+ * - Receive error accounting with automatic re-arm, plus a liveness check
+ *   that restarts a stalled reception
+ * - Optional RX flow control (RTS/CTS or XON/XOFF) from stream buffer
+ *   watermarks, so a fast sender is throttled instead of losing input
+ * - Optional RX timing histograms (UART_RX_TIMING): every RX interrupt is
+ *   stamped with the DWT cycle counter
  * - All UART TX operations delegated to print task
  *
  * Synchronization Strategy:
  * - uart_stream_buffer: ISR deposits bytes, task reads (lock-free)
- * - command_queue: Decouples reception from command processing
- * - Task notification: Wakes up command handler when command ready
- * - print_message()/print_char(): Thread-safe UART TX via print task
+ * - command_queue: Pool indices from UART task to handler; the handler
+ *   blocks on it (no separate task notification)
+ * - Command pool (cmd_pool.h): buffers are returned in order, so a release is one
+ *   counter increment
+ * - print_const()/print_message()/print_char(): Thread-safe UART TX via print task
  *
  * Thread Safety:
  * - UART TX: All output goes through print task (no direct HAL calls)
@@ -42,7 +57,17 @@
 #include "uart_task.h"
 #include "command_handler.h"
 #include "print_task.h"
+#include "print_log.h"
 #include "watchdog.h"
+#include "line_scan.h"
+#include "cmd_frame.h"
+#include "cmd_pool.h"
+#include "uart_baud.h"
+#include "uart_rx_recovery.h"
+#include "timers.h"
+#if UART_FLOW_CONTROL != UART_FLOW_NONE
+#include "print_port.h"
+#endif
 #include <string.h>
 #include <stdio.h>
 
@@ -51,13 +76,106 @@ QueueHandle_t command_queue = NULL;                  // Command queue (UART -> H
 static StreamBufferHandle_t uart_stream_buffer = NULL;  // Stream buffer (ISR -> Task)
 extern UART_HandleTypeDef huart2;                    // UART2 peripheral handle
 
-/* Single-byte buffer for interrupt reception */
-static uint8_t uart_rx_byte;
+/* Circular DMA reception (written by DMA1 Stream5, read in the RX event ISR) */
+static uint8_t uart_rx_dma_buffer[UART_RX_DMA_BUFFER_SIZE];
+static uint16_t uart_rx_dma_tail = 0;         // First byte not yet pushed to the stream
+
+/* Receive statistics (updated in ISR context only) */
+static volatile uint32_t stat_rx_bytes = 0;
+static volatile uint32_t stat_rx_events = 0;
+static volatile uint32_t stat_rx_dropped = 0;
+static volatile uint32_t stat_rx_largest_chunk = 0;
+static volatile uint32_t stat_rx_overflow_events = 0;
+static volatile uint32_t stat_isr_frame_errors = 0; // Oversized frames
+
+/* Receive error accounting (error callback, plus the task's liveness check) */
+static uart_rx_recovery_t rx_recovery;       // Error counters and re-arm decision
+
+/* Task-side statistics */
+static uint32_t stat_task_wakeups = 0;
+static uint32_t stat_task_reads = 0;
+static uint32_t stat_commands = 0;
+static uint32_t stat_frames = 0;
+static uint32_t stat_frame_errors = 0;              // Corrupt or oversized frames
+static uint32_t stat_queue_stalls = 0;
+
+#if UART_FLOW_CONTROL != UART_FLOW_NONE
+/* Sender throttle state (RX interrupt, or task inside a critical section) */
+static uart_flow_t uart_flow = {
+    .high_watermark = UART_FLOW_HIGH_WATERMARK,
+    .low_watermark = UART_FLOW_LOW_WATERMARK,
+};
+#endif
+
+#if UART_FLOW_HIGH_WATERMARK <= UART_FLOW_LOW_WATERMARK
+#error "UART_STREAM_BUFFER_SIZE too small for the flow control headroom"
+#endif
+
+#if CMD_FRAME_MAX_PAYLOAD + 2 > COMMAND_MAX_LENGTH
+#error "A decoded frame plus its 2-byte header must fit one command pool buffer"
+#endif
+
+#if COMMAND_POOL_SIZE > 256
+#error "command_queue items are 8-bit command pool indices"
+#endif
+
+#if UART_RX_ERROR_PE != HAL_UART_ERROR_PE || UART_RX_ERROR_NE != HAL_UART_ERROR_NE || \
+    UART_RX_ERROR_FE != HAL_UART_ERROR_FE || UART_RX_ERROR_ORE != HAL_UART_ERROR_ORE || \
+    UART_RX_ERROR_DMA != HAL_UART_ERROR_DMA
+#error "uart_rx_recovery.h error flags must match HAL_UART_ERROR_xx"
+#endif
+
+/* Baud rate switching */
+static TimerHandle_t baud_revert_timer = NULL;
+static uint32_t baud_confirmed = 0;          // Rate to return to while a switch is unconfirmed (0 = none)
+static volatile BaseType_t baud_revert_due = pdFALSE;   // Timer expired, the UART task reverts
+
+#if UART_AUTOBAUD
+static volatile BaseType_t autobaud_pending = pdTRUE;   // Reception waits for the first character
+static volatile uint32_t autobaud_changed = 0;          // Rate detected (0 = kept 115200)
+static BaseType_t autobaud_welcome = pdTRUE;            // UART task: welcome screen not printed yet
+#endif
+
+#if UART_RX_TIMING
+/* RX timing histograms (gap and burst: RX interrupt, wake: UART task) */
+static uart_rx_timing_t rx_timing;
+static uint32_t timing_idle_stamp = 0;       // CYCCNT at the interrupt that ended the last burst
+static uint32_t timing_burst_bytes = 0;      // Bytes of the burst in progress
+static uint32_t timing_cycles_per_us = 1;
+static volatile uint32_t timing_wake_stamp = 0;          // CYCCNT when the stream buffer became non-empty
+static volatile BaseType_t timing_wake_pending = pdFALSE;
+#endif
+
+#if UART_LINE_DISCIPLINE
+/* Line being assembled by the RX interrupt (line discipline mode) */
+static uint8_t isr_line[UART_RX_BUFFER_SIZE];
+static uint16_t isr_line_len = 0;
+
+/* Binary frame being delimited by the RX interrupt, opening delimiter
+ * included (0 = text mode) */
+static uint8_t isr_frame[CMD_FRAME_MAX_WIRE];
+static uint16_t isr_frame_len = 0;
+static BaseType_t isr_frame_discard = pdFALSE; // Skipping an oversized frame
+#endif
+
+/* Binary frame being collected by the task (bytes between the delimiters) */
+static uint8_t rx_frame[CMD_FRAME_MAX_ENCODED];
+static uint16_t rx_frame_len = 0;
+static BaseType_t rx_frame_active = pdFALSE;
+static BaseType_t rx_frame_discard = pdFALSE;
 
 /* Reception State */
-static char rx_buffer[UART_RX_BUFFER_SIZE];   // Command assembly buffer
+/* Command pool: line buffers handed to the handler by index, in order */
+static char command_pool[COMMAND_POOL_SIZE][COMMAND_MAX_LENGTH];
+static cmd_pool_t command_pool_state = CMD_POOL_INIT(COMMAND_POOL_SIZE);
+
+static volatile BaseType_t uart_echo = pdTRUE; // Echo typed input (off in machine mode)
+static char *rx_buffer = command_pool[0];     // Command assembly buffer (next pool buffer)
 static uint16_t rx_index = 0;                 // Current position in buffer
-static TaskHandle_t command_handler_task_handle = NULL;
+static watchdog_id_t uart_wd_id = WATCHDOG_INVALID_ID;
+
+static BaseType_t uart_rx_start(void);
+static void uart_baud_revert_callback(TimerHandle_t timer);
 
 /**
  * @brief  Initialize UART subsystem and create FreeRTOS objects
@@ -65,12 +183,12 @@ static TaskHandle_t command_handler_task_handle = NULL;
  * @retval None
  *
  * Creates:
- * 1. Stream Buffer - ISR-to-Task communication (128 bytes)
+ * 1. Stream Buffer - ISR-to-Task communication (512 bytes)
  *    Flow: UART RX ISR -> Stream buffer -> UART task
  *    Purpose: Efficient, lock-free byte transfer from interrupt to task
  *    Trigger: Task wakes on ANY byte (trigger level = 1)
  *
- * 2. Command Queue - Holds up to 5 commands (32 chars each)
+ * 2. Command Queue - Holds up to COMMAND_QUEUE_DEPTH command pool indices
  *    Flow: UART task -> Queue -> Command handler task
  *    Prevents: Blocking UART reception during command processing
  *
@@ -78,20 +196,20 @@ static TaskHandle_t command_handler_task_handle = NULL;
  *    Priority: 2 (same as UART task for balanced scheduling)
  *    Stack: 256 words (sufficient for menu printing)
  *
- * 4. Start UART interrupt reception
+ * 4. Start circular DMA reception with idle-line detection
  *
  * Note: Print task is initialized separately via print_task_init()
  */
 void uart_task_init(void)
 {
-    // Create stream buffer (128 bytes, trigger on 1 byte)
+    // Create stream buffer (512 bytes, trigger on 1 byte)
     // Trigger level = 1 means task wakes immediately when ANY byte arrives
     uart_stream_buffer = xStreamBufferCreate(UART_STREAM_BUFFER_SIZE, 1);
     configASSERT(uart_stream_buffer != NULL);
 
-    // Create command queue: 5 slots × 32 chars
-    // Size chosen to buffer rapid commands without blocking
-    command_queue = xQueueCreate(5, COMMAND_MAX_LENGTH * sizeof(char));
+    // Create command queue: COMMAND_QUEUE_DEPTH pool indices (1 byte each)
+    // Size chosen to buffer rapid (pipelined) commands without blocking
+    command_queue = xQueueCreate(COMMAND_QUEUE_DEPTH, sizeof(uint8_t));
     configASSERT(command_queue != NULL);
 
     // Create command handler task
@@ -101,12 +219,35 @@ void uart_task_init(void)
                                     256,           // Stack size in words
                                     NULL,          // No parameters
                                     2,             // Priority
-                                    &command_handler_task_handle);
+                                    NULL);
     configASSERT(status == pdPASS);
 
-    // Start first interrupt-based UART reception
-    // HAL will call HAL_UART_RxCpltCallback when byte arrives
-    HAL_UART_Receive_IT(&huart2, &uart_rx_byte, 1);
+    // One-shot timer that undoes an unconfirmed "baud" switch
+    baud_revert_timer = xTimerCreate("Baud_Revert",
+                                     pdMS_TO_TICKS(UART_BAUD_CONFIRM_MS),
+                                     pdFALSE,
+                                     NULL,
+                                     uart_baud_revert_callback);
+    configASSERT(baud_revert_timer != NULL);
+
+#if UART_RX_TIMING || UART_AUTOBAUD
+    // The cycle counter also needs the trace block, which only a debugger
+    // enables otherwise (main() sets CYCCNTENA)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+#if UART_RX_TIMING
+    timing_cycles_per_us = SystemCoreClock / 1000000U;
+#endif
+
+#if !UART_AUTOBAUD
+    // Start circular DMA reception
+    // HAL calls HAL_UARTEx_RxEventCallback on line idle, half and full transfer
+    // (if this fails, the task's liveness check re-arms it)
+    uart_rx_start();
+#endif
+    // With UART_AUTOBAUD the task arms the edge interrupt once the line
+    // has settled, and reception starts after the first character
 }
 
 static void print_welcome_message(void)
@@ -120,60 +261,999 @@ static void print_welcome_message(void)
         "*                                      *\r\n"
         "****************************************\r\n";
 
-    print_message(welcome);
+    print_const(welcome);
 }
 
 void print_main_menu(void)
 {
-    const char *menu =
-        "\r\n========================================\r\n"
-        "              MAIN MENU\r\n"
-        "========================================\r\n"
-        "  1 - LED Patterns\r\n"
-        "  2 - Exit Application\r\n"
-        "========================================\r\n"
-        "Enter selection: ";
+    // Generated from the menu table, same literal as command_handler.c's
+    print_const(MENU_PLAIN_TEXT(MENU_MAIN_TITLE, MENU_MAIN_OPTIONS));
+}
+
+#if UART_FLOW_CONTROL != UART_FLOW_NONE
+/**
+ * @brief  Re-evaluate the watermarks and stop or restart the sender
+ * @retval None
+ *
+ * Call from the RX interrupt, or from the task inside a critical section
+ * (the XON/XOFF path touches the USART directly).
+ */
+static void uart_rx_throttle(void)
+{
+    uart_flow_action_t action = uart_flow_update(&uart_flow,
+                                                 xStreamBufferBytesAvailable(uart_stream_buffer));
+    if (action == UART_FLOW_KEEP) {
+        return;
+    }
+
+#if UART_FLOW_CONTROL == UART_FLOW_RTS_CTS
+    // RTS is active low: high tells the host to stop sending
+    HAL_GPIO_WritePin(UART_RTS_GPIO_Port, UART_RTS_Pin,
+                      (action == UART_FLOW_STOP) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+#else
+    // Sent ahead of any queued output, not behind the current burst
+    print_port_send_priority((action == UART_FLOW_STOP) ? UART_FLOW_XOFF : UART_FLOW_XON);
+#endif
+}
+#endif
+
+#if UART_LINE_DISCIPLINE
+/**
+ * @brief  Flush pending echo bytes to the print task (ISR context)
+ */
+static void uart_rx_echo_flush(uint8_t *echo, size_t *echo_len, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    print_write_from_isr(PRINT_ISR_SOURCE_UART_RX, echo, *echo_len, pxHigherPriorityTaskWoken);
+    *echo_len = 0;
+}
+
+/**
+ * @brief  Delimit a binary command frame (ISR context)
+ * @param  c: Frame byte, or a delimiter
+ * @param  pxHigherPriorityTaskWoken: Set if a task was woken
+ * @retval Number of bytes dropped (frame did not fit the stream buffer)
+ *
+ * Frame bytes are neither echoed nor edited. A complete frame goes into
+ * the stream buffer in one piece with both delimiters, exactly as sent,
+ * and the task decodes it. An oversized frame is skipped up to its
+ * closing delimiter instead of spilling into the text path.
+ */
+static size_t uart_rx_frame_isr(uint8_t c, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (c != CMD_FRAME_DELIMITER) {
+        if (isr_frame_discard) {
+            return 0;
+        }
+        if (isr_frame_len < sizeof(isr_frame) - 1) {
+            isr_frame[isr_frame_len++] = c;
+        } else {
+            isr_frame_len = 0;
+            isr_frame_discard = pdTRUE;
+            stat_isr_frame_errors++;
+        }
+        return 0;
+    }
+
+    if (isr_frame_discard) {
+        isr_frame_discard = pdFALSE;    // End of the oversized frame
+        return 0;
+    }
+    if (isr_frame_len <= 1) {
+        // Opening delimiter (repeated delimiters keep the frame open)
+        isr_frame[0] = CMD_FRAME_DELIMITER;
+        isr_frame_len = 1;
+        return 0;
+    }
+
+    isr_frame[isr_frame_len++] = CMD_FRAME_DELIMITER;
+    size_t length = isr_frame_len;
+    isr_frame_len = 0;
+
+    if (xStreamBufferSpacesAvailable(uart_stream_buffer) < length) {
+        return length;
+    }
+    xStreamBufferSendFromISR(uart_stream_buffer, isr_frame, length, pxHigherPriorityTaskWoken);
+    return 0;
+}
+
+/**
+ * @brief  Apply the line discipline to a received chunk (ISR context)
+ * @param  data: Bytes inside the DMA buffer
+ * @param  length: Number of bytes
+ * @param  pxHigherPriorityTaskWoken: Set if a task was woken
+ * @retval Number of bytes dropped (line did not fit the stream buffer)
+ *
+ * Echo, backspace and overflow are handled here, so the UART task only
+ * ever sees complete lines. Each line is sent whole with a '\r'
+ * terminator, which wakes the task exactly once per command. Cost is
+ * bounded by the chunk size (at most UART_RX_DMA_BUFFER_SIZE bytes).
+ */
+static size_t uart_rx_line_discipline(const uint8_t *data, size_t length,
+                                      BaseType_t *pxHigherPriorityTaskWoken)
+{
+    uint8_t echo[PRINT_ISR_MESSAGE_MAX_SIZE];
+    size_t echo_len = 0;
+    size_t dropped = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        uint8_t c = data[i];
+
+        // Leave room for the longest echo sequence ("\b \b")
+        if (echo_len > sizeof(echo) - 3) {
+            uart_rx_echo_flush(echo, &echo_len, pxHigherPriorityTaskWoken);
+        }
+
+#if UART_FLOW_CONTROL == UART_FLOW_XON_XOFF
+        if (c == UART_FLOW_XON || c == UART_FLOW_XOFF) {
+            continue;   // Host's own flow control - never echo or store it
+        }
+#endif
+
+        if (c == CMD_FRAME_DELIMITER || isr_frame_len != 0 || isr_frame_discard) {
+            dropped += uart_rx_frame_isr(c, pxHigherPriorityTaskWoken);
+            continue;
+        }
+
+        if (c == UART_SESSION_MACHINE || c == UART_SESSION_INTERACTIVE) {
+            // Echo switches at this byte; the task queues the mode change
+            uart_rx_echo_flush(echo, &echo_len, pxHigherPriorityTaskWoken);
+            uart_echo = (c == UART_SESSION_INTERACTIVE) ? pdTRUE : pdFALSE;
+            if (xStreamBufferSendFromISR(uart_stream_buffer, &c, 1,
+                                         pxHigherPriorityTaskWoken) == 0) {
+                dropped++;
+            }
+            continue;
+        }
+
+        if (c == '\r' || c == '\n') {
+            if (isr_line_len == 0) {
+                continue;   // Empty line or second half of CR+LF
+            }
+            isr_line[isr_line_len++] = '\r';
+            if (xStreamBufferSpacesAvailable(uart_stream_buffer) >= isr_line_len) {
+                xStreamBufferSendFromISR(uart_stream_buffer, isr_line, isr_line_len,
+                                         pxHigherPriorityTaskWoken);
+            } else {
+                dropped += isr_line_len;
+            }
+            isr_line_len = 0;
+        }
+        else if (c == '\b' || c == 127) {
+            if (isr_line_len > 0) {
+                isr_line_len--;
+                if (uart_echo) {
+                    memcpy(&echo[echo_len], "\b \b", 3);
+                    echo_len += 3;
+                }
+            }
+        }
+        else if (isr_line_len < UART_RX_BUFFER_SIZE - 1) {
+            isr_line[isr_line_len++] = c;
+            if (uart_echo) {
+                echo[echo_len++] = c;
+            }
+        }
+        else {
+            // Line too long - discard it, user must retype the command
+            uart_rx_echo_flush(echo, &echo_len, pxHigherPriorityTaskWoken);
+            print_message_from_isr(PRINT_ISR_SOURCE_UART_RX,
+                                   "\r\nError: Buffer overflow!\r\n",
+                                   pxHigherPriorityTaskWoken);
+            dropped += isr_line_len + 1;
+            isr_line_len = 0;
+        }
+    }
+
+    if (echo_len > 0) {
+        uart_rx_echo_flush(echo, &echo_len, pxHigherPriorityTaskWoken);
+    }
+
+    return dropped;
+}
+#endif
+
+/**
+ * @brief  Push a chunk of received bytes into the stream buffer (ISR context)
+ * @param  data: Bytes inside the DMA buffer
+ * @param  length: Number of bytes
+ * @param  pxHigherPriorityTaskWoken: Set if the UART task was woken
+ * @retval Number of bytes that did not fit (dropped)
+ */
+static size_t uart_rx_push(const uint8_t *data, size_t length, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (length == 0) {
+        return 0;
+    }
 
-    print_message(menu);
+#if UART_LINE_DISCIPLINE
+    return uart_rx_line_discipline(data, length, pxHigherPriorityTaskWoken);
+#else
+    size_t sent = xStreamBufferSendFromISR(uart_stream_buffer, data, length,
+                                           pxHigherPriorityTaskWoken);
+    return length - sent;
+#endif
 }
 
 /**
- * @brief  UART RX Complete Callback (called from ISR context)
+ * @brief  (Re)start circular DMA reception
+ * @retval BaseType_t: pdPASS if reception is armed, pdFAIL if HAL refused
+ *         (HAL_BUSY/HAL_ERROR)
+ *
+ * The DMA keeps writing into uart_rx_dma_buffer without CPU help; the
+ * half-transfer interrupt stays enabled so a long paste is delivered in
+ * half-buffer chunks well before the buffer wraps.
+ */
+static BaseType_t uart_rx_start(void)
+{
+    uart_rx_dma_tail = 0;
+    HAL_StatusTypeDef status = HAL_UARTEx_ReceiveToIdle_DMA(&huart2, uart_rx_dma_buffer,
+                                                           UART_RX_DMA_BUFFER_SIZE);
+
+    return (uart_rx_recovery_rearmed(&rx_recovery, status == HAL_OK) == UART_RX_KEEP) ? pdPASS : pdFAIL;
+}
+
+#if UART_RX_TIMING
+/**
+ * @brief  Add a sample to a log2 histogram
+ */
+static void uart_rx_histogram_add(uart_rx_histogram_t *histogram, uint32_t value)
+{
+    uint32_t bucket = (value == 0) ? 0 : 32U - __CLZ(value);
+
+    if (bucket >= UART_RX_TIMING_BUCKETS) {
+        bucket = UART_RX_TIMING_BUCKETS - 1;
+    }
+    histogram->count[bucket]++;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+/**
+ * @brief  Stamp an RX interrupt (ISR context)
+ * @param  head: DMA write position the interrupt reported
+ * @param  length: New bytes
+ * @param  stream_was_empty: Stream buffer was empty before the bytes were pushed
+ * @retval None
+ *
+ * Half and full transfer interrupts fire at fixed DMA positions and keep
+ * the burst open; an interrupt anywhere else is the idle line that ends
+ * it. (An idle line that falls exactly on a half or full position joins
+ * the next burst - rare, and only merges two samples.)
+ */
+static void uart_rx_timing_event(uint16_t head, size_t length, BaseType_t stream_was_empty)
+{
+    uint32_t now = DWT->CYCCNT;
+
+    if (length == 0) {
+        return;
+    }
+
+    if (timing_burst_bytes == 0 && timing_idle_stamp != 0) {
+        uart_rx_histogram_add(&rx_timing.gap_us, (now - timing_idle_stamp) / timing_cycles_per_us);
+    }
+    timing_burst_bytes += length;
+
+    if (head != UART_RX_DMA_BUFFER_SIZE / 2 && head != UART_RX_DMA_BUFFER_SIZE) {
+        uart_rx_histogram_add(&rx_timing.burst_bytes, timing_burst_bytes);
+        timing_burst_bytes = 0;
+        timing_idle_stamp = now;
+    }
+
+    // Start a wake latency sample when the task has something new to wake for
+    if (stream_was_empty && !timing_wake_pending && !xStreamBufferIsEmpty(uart_stream_buffer)) {
+        timing_wake_stamp = now;
+        timing_wake_pending = pdTRUE;
+    }
+}
+#endif
+
+/**
+ * @brief  Hand new DMA data to the stream buffer (ISR context)
+ * @param  head: DMA write position in uart_rx_dma_buffer (bytes)
+ * @param  pxHigherPriorityTaskWoken: Set if a task was woken
+ * @retval None
+ *
+ * Everything between the last position and head is new data; it is
+ * pushed in one call (two if the DMA wrapped).
+ */
+static void uart_rx_consume(uint16_t head, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    static BaseType_t overrun_reported = pdFALSE;
+
+    uint16_t tail = uart_rx_dma_tail;
+    size_t length = 0;
+    size_t dropped = 0;
+#if UART_RX_TIMING
+    BaseType_t stream_was_empty = xStreamBufferIsEmpty(uart_stream_buffer);
+#endif
+
+    if (head > tail) {
+        length = head - tail;
+        dropped = uart_rx_push(&uart_rx_dma_buffer[tail], length, pxHigherPriorityTaskWoken);
+    } else if (head < tail) {
+        // DMA wrapped since the last event
+        length = (UART_RX_DMA_BUFFER_SIZE - tail) + head;
+        dropped = uart_rx_push(&uart_rx_dma_buffer[tail], UART_RX_DMA_BUFFER_SIZE - tail,
+                               pxHigherPriorityTaskWoken);
+        dropped += uart_rx_push(uart_rx_dma_buffer, head, pxHigherPriorityTaskWoken);
+    }
+
+    uart_rx_dma_tail = (head == UART_RX_DMA_BUFFER_SIZE) ? 0 : head;
+
+    stat_rx_events++;
+    stat_rx_bytes += length;
+    stat_rx_dropped += dropped;
+    if (dropped != 0) {
+        stat_rx_overflow_events++;
+    }
+    if (length > stat_rx_largest_chunk) {
+        stat_rx_largest_chunk = length;
+    }
+#if UART_RX_TIMING
+    uart_rx_timing_event(head, length, stream_was_empty);
+#endif
+
+#if UART_FLOW_CONTROL != UART_FLOW_NONE
+    uart_rx_throttle();
+#endif
+
+    if (dropped != 0 && !overrun_reported) {
+        print_message_from_isr(PRINT_ISR_SOURCE_UART_RX,
+                               "\r\n[UART] RX stream full, input dropped\r\n",
+                               pxHigherPriorityTaskWoken);
+        overrun_reported = pdTRUE;
+    } else if (length != 0 && dropped == 0) {
+        overrun_reported = pdFALSE;
+    }
+}
+
+/**
+ * @brief  UART RX Event Callback (called from ISR context)
  * @param  huart: UART handle
+ * @param  Size: DMA write position in uart_rx_dma_buffer (bytes)
  * @retval None
  *
  * ISR Operation:
- * 1. Called automatically by HAL when byte received
- * 2. Deposit byte into stream buffer (ISR-safe)
- * 3. Stream buffer wakes up UART task if blocked
- * 4. Re-enable reception for next byte
+ * 1. Called by HAL on line idle, DMA half-transfer or DMA transfer-complete
+ * 2. Everything between the last position and Size is new data
+ * 3. Push that chunk into the stream buffer in one call (wrap-aware), or
+ *    with UART_LINE_DISCIPLINE echo it and forward only complete lines
+ * 4. Stream buffer wakes up UART task if blocked
+ * 5. With UART_FLOW_CONTROL, stop the sender if the stream buffer has
+ *    reached the high watermark
+ * 6. If the stream buffer was full, report the overrun once (ISR-safe
+ *    print ring) until bytes flow again
  *
  * Thread Safety:
  * - Uses xStreamBufferSendFromISR (ISR-safe variant)
  * - Handles context switch if higher priority task woken
  *
  * Efficiency:
- * - Minimal ISR overhead (~2-3 μs)
- * - Lock-free stream buffer write
- * - Task woken immediately (no polling delay)
+ * - One interrupt per burst (idle line) or per half buffer, not per byte
+ * - DMA stays armed in circular mode - nothing to re-arm here
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    if (huart != &huart2) {
+        return;
+    }
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    uart_rx_consume(Size, &xHigherPriorityTaskWoken);
+
+    // Yield to higher priority task if woken
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief  UART Error Callback (called from ISR context)
+ * @param  huart: UART handle
+ * @retval None
+ *
+ * With DMA reception every receive error (parity, noise, framing,
+ * overrun) is a blocking error: HAL aborts the RX DMA and then calls
+ * this. Each error type is counted, the bytes the DMA stored before the
+ * error are handed on (a burst of line noise costs the damaged line, not
+ * the whole chunk), and reception is re-armed so input keeps flowing.
+ * A re-arm that fails is retried by uart_rx_check_alive() in the task,
+ * which is woken at once for it.
+ *
+ * A TX DMA error also lands here; reception is still running then and
+ * is left alone (print_port recovers TX by its own timeout).
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart != &huart2) {
+        return;
+    }
+
+    // Count the error; reception still busy means it was not affected
+    if (uart_rx_recovery_error(&rx_recovery, HAL_UART_GetError(huart),
+                               huart->RxState == HAL_UART_STATE_READY) != UART_RX_RESTART) {
+        return;
+    }
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    // The aborted stream keeps its counter: salvage what arrived before the error
+    uart_rx_consume(UART_RX_DMA_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(huart->hdmarx),
+                    &xHigherPriorityTaskWoken);
+
+    if (uart_rx_start() != pdPASS) {
+        // Wake the task (its receive returns 0 bytes) so the liveness
+        // check retries now rather than after the 2 s receive timeout
+        xStreamBufferSendCompletedFromISR(uart_stream_buffer, &xHigherPriorityTaskWoken);
+    }
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief  Make sure reception is armed, re-arming it if it stalled
+ * @retval BaseType_t: pdTRUE if reception is running (possibly after a
+ *         re-arm), pdFALSE if it could not be restarted
+ *
+ * Called by the UART task on every loop iteration, data or timeout.
+ * Without it, a refused re-arm would leave RX dead while the task keeps
+ * timing out and feeding the watchdog. The task stops feeding the
+ * watchdog while this returns pdFALSE, so a permanent stall is reported
+ * as a hung UART_task.
+ */
+static BaseType_t uart_rx_check_alive(void)
+{
+    BaseType_t alive = pdTRUE;
+
+#if UART_AUTOBAUD
+    if (autobaud_pending) {
+        return pdTRUE;  // Not started yet - waiting for the first character
+    }
+#endif
+
+    // Mask the USART/DMA interrupts so the check cannot race the error callback
+    taskENTER_CRITICAL();
+    if (uart_rx_recovery_check(&rx_recovery, huart2.RxState == HAL_UART_STATE_BUSY_RX) ==
+        UART_RX_RESTART) {
+        alive = uart_rx_start();
+    }
+    taskEXIT_CRITICAL();
+
+    return alive;
+}
+
+/**
+ * @brief  Reprogram the USART2 baud rate register
+ * @param  baud: New rate
+ * @retval None
+ *
+ * UE is cleared only around the BRR write; the circular RX DMA stays
+ * armed and continues at the new rate. Call from the autobaud interrupt
+ * or inside a critical section.
+ */
+static void uart_apply_baud(uint32_t baud)
+{
+    __HAL_UART_DISABLE(&huart2);
+    huart2.Init.BaudRate = baud;
+    huart2.Instance->BRR = UART_BRR_SAMPLING16(HAL_RCC_GetPCLK1Freq(), baud);
+    __HAL_UART_ENABLE(&huart2);
+}
+
+/**
+ * @brief  Confirmation time is up (timer service task)
+ * @param  timer: baud_revert_timer
+ *
+ * Only posts the revert. The timer task must not block in print_flush(),
+ * and BRR must not change while TX DMA is still sending.
+ */
+static void uart_baud_revert_callback(TimerHandle_t timer)
+{
+    (void)timer;
+
+    baud_revert_due = pdTRUE;
+}
+
+/**
+ * @brief  Undo an unconfirmed baud switch (UART task)
+ * @retval None
+ *
+ * Same order as uart_baud_request(): let the output in flight leave,
+ * rewrite BRR, then announce at the restored rate.
+ */
+static void uart_baud_revert(void)
+{
+    baud_revert_due = pdFALSE;
+    print_flush(pdMS_TO_TICKS(1000));
+
+    taskENTER_CRITICAL();
+    uint32_t previous = baud_confirmed;     // 0 if "ok" arrived meanwhile
+    baud_confirmed = 0;
+    if (previous != 0) {
+        uart_apply_baud(previous);
+    }
+    taskEXIT_CRITICAL();
+
+    if (previous != 0) {
+        print_printf("\r\nBaud rate not confirmed - back to %lu baud\r\n", previous);
+    }
+}
+
+BaseType_t uart_baud_request(uint32_t baud)
+{
+    // 16x oversampling: the USART cannot go above PCLK1 / 16
+    if (!uart_baud_supported(baud) || baud > HAL_RCC_GetPCLK1Freq() / 16U) {
+        return pdFAIL;
+    }
+
+    print_printf("\r\nSwitching to %lu baud - send 'ok' within %u s to keep it\r\n",
+                 baud, (unsigned)(UART_BAUD_CONFIRM_MS / 1000));
+    // Let the announcement (and anything before it) out at the old rate
+    print_flush(pdMS_TO_TICKS(1000));
+
+    taskENTER_CRITICAL();
+    if (baud_confirmed == 0) {
+        baud_confirmed = huart2.Init.BaudRate;  // Switching again keeps the last good rate
+    }
+    uart_apply_baud(baud);
+    baud_revert_due = pdFALSE;              // The new switch gets its own time
+    taskEXIT_CRITICAL();
+
+    xTimerReset(baud_revert_timer, 0);      // Starts the timer, or restarts it
+    return pdPASS;
+}
+
+BaseType_t uart_baud_confirm(void)
+{
+    taskENTER_CRITICAL();
+    BaseType_t pending = (baud_confirmed != 0) ? pdTRUE : pdFALSE;
+    baud_confirmed = 0;
+    baud_revert_due = pdFALSE;
+    taskEXIT_CRITICAL();
+
+    if (pending) {
+        xTimerStop(baud_revert_timer, 0);
+    }
+    return pending;
+}
+
+uint32_t uart_get_baud(void)
+{
+    return huart2.Init.BaudRate;
+}
+
+#if UART_AUTOBAUD
+/**
+ * @brief  Arm the start-bit interrupt for auto-baud
+ * @retval None
+ *
+ * PA3 stays in USART alternate function mode; EXTI taps the same input.
+ * PD3 (CTS with UART_FLOW_RTS_CTS) shares EXTI line 3 but is not routed
+ * to it.
+ */
+static void uart_autobaud_arm(void)
+{
+    __HAL_RCC_SYSCFG_CLK_ENABLE();
+    SYSCFG->EXTICR[0] = (SYSCFG->EXTICR[0] & ~SYSCFG_EXTICR1_EXTI3) | SYSCFG_EXTICR1_EXTI3_PA;
+    EXTI->RTSR &= ~EXTI_RTSR_TR3;
+    EXTI->FTSR |= EXTI_FTSR_TR3;
+    EXTI->PR = EXTI_PR_PR3;
+    EXTI->IMR |= EXTI_IMR_MR3;
+
+    // Same priority as the UART interrupts (may use FreeRTOS ISR calls)
+    HAL_NVIC_SetPriority(EXTI3_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(EXTI3_IRQn);
+}
+
+void uart_autobaud_irq(void)
+{
+    uint32_t edges[UART_BAUD_MAX_EDGES];
+    size_t count = 0;
+    uint32_t level = 0;                 // Inside the start bit
+    uint32_t last = DWT->CYCCNT;
+    // Longest possible run is 9 bits; give up after 10 at the slowest rate,
+    // or 10 of the shortest run seen once there is one
+    uint32_t silence = SystemCoreClock / UART_BAUD_MIN * 10U;
+    uint32_t shortest = UINT32_MAX;
+
+    // One shot
+    EXTI->IMR &= ~EXTI_IMR_MR3;
+    EXTI->PR = EXTI_PR_PR3;
+    HAL_NVIC_DisableIRQ(EXTI3_IRQn);
+    if (!autobaud_pending) {
+        return;
+    }
+
+    // Sample the rest of the character (at most ~1 ms, once per reset)
+    while (count < UART_BAUD_MAX_EDGES) {
+        uint32_t now = DWT->CYCCNT;
+        uint32_t pin = (GPIOA->IDR & GPIO_PIN_3) ? 1U : 0U;
+
+        if (pin != level) {
+            if (count > 0 && now - last < shortest) {
+                shortest = now - last;
+                if (shortest * 10U < silence) {
+                    silence = shortest * 10U;
+                }
+            }
+            edges[count++] = now;
+            last = now;
+            level = pin;
+        } else if (now - last > silence) {
+            break;
+        }
+    }
+
+    uint32_t baud = uart_baud_estimate(edges, count, SystemCoreClock);
+    if (baud != 0 && baud != huart2.Init.BaudRate && baud <= HAL_RCC_GetPCLK1Freq() / 16U) {
+        uart_apply_baud(baud);
+        autobaud_changed = baud;
+    }
+
+    // Drop what the USART made of the character, then start receiving
+    (void)huart2.Instance->SR;
+    (void)huart2.Instance->DR;
+    autobaud_pending = pdFALSE;
+    uart_rx_start();
+
+    // Wake the task to print the welcome screen (an empty line is ignored)
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xStreamBufferSendFromISR(uart_stream_buffer, "\r", 1, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+#endif
+
+/**
+ * @brief  Get UART receive statistics
+ * @param  stats: [OUT] Snapshot of the counters
+ * @retval None
  */
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+void uart_get_rx_stats(uart_rx_stats_t *stats)
 {
-    if (huart == &huart2) {
-        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    if (stats == NULL) {
+        return;
+    }
 
-        // Send byte to stream buffer (ISR-safe, lock-free)
-        // If UART task is blocked reading, it will be woken immediately
-        xStreamBufferSendFromISR(uart_stream_buffer,
-                                 &uart_rx_byte,
-                                 1,
-                                 &xHigherPriorityTaskWoken);
+    taskENTER_CRITICAL();
+    stats->rx_bytes = stat_rx_bytes;
+    stats->rx_events = stat_rx_events;
+    stats->rx_dropped = stat_rx_dropped;
+    stats->largest_chunk = stat_rx_largest_chunk;
+    stats->task_wakeups = stat_task_wakeups;
+    stats->task_reads = stat_task_reads;
+    stats->overflow_events = stat_rx_overflow_events;
+#if UART_FLOW_CONTROL != UART_FLOW_NONE
+    stats->throttle_events = uart_flow.throttle_events;
+#else
+    stats->throttle_events = 0;
+#endif
+    stats->queue_stalls = stat_queue_stalls;
+    stats->parity_errors = rx_recovery.parity;
+    stats->noise_errors = rx_recovery.noise;
+    stats->framing_errors = rx_recovery.framing;
+    stats->overrun_errors = rx_recovery.overrun;
+    stats->dma_errors = rx_recovery.dma;
+    stats->rx_restarts = rx_recovery.restarts;
+    stats->rearm_failures = rx_recovery.rearm_failures;
+    stats->rx_stalls = rx_recovery.stalls;
+    stats->commands = stat_commands;
+    stats->frames = stat_frames;
+    stats->frame_errors = stat_frame_errors + stat_isr_frame_errors;
+    stats->pool_in_use = cmd_pool_in_use(&command_pool_state);
+    stats->pool_peak = command_pool_state.peak;
+    taskEXIT_CRITICAL();
+}
+
+#if UART_RX_TIMING
+void uart_get_rx_timing(uart_rx_timing_t *timing)
+{
+    if (timing == NULL) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    *timing = rx_timing;
+    taskEXIT_CRITICAL();
+}
 
-        // Re-enable reception for next byte
-        HAL_UART_Receive_IT(&huart2, &uart_rx_byte, 1);
+/**
+ * @brief  Print the non-empty buckets of a histogram
+ * @param  title: Heading (string literal - formatted later by the print task)
+ * @param  histogram: Histogram to print
+ */
+static void uart_print_histogram(const char *title, const uart_rx_histogram_t *histogram)
+{
+    print_printf("%s, max %lu:\r\n", title, histogram->max);
+    for (uint32_t i = 0; i < UART_RX_TIMING_BUCKETS; i++) {
+        uint32_t low = (i == 0) ? 0 : (1UL << (i - 1));
 
-        // Yield to higher priority task if woken
-        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+        if (histogram->count[i] == 0) {
+            continue;
+        }
+        if (i == UART_RX_TIMING_BUCKETS - 1) {
+            print_printf("  %7lu+         %lu\r\n", low, histogram->count[i]);
+        } else {
+            print_printf("  %7lu-%-7lu %lu\r\n", low, (i == 0) ? 0 : (2UL << (i - 1)) - 1,
+                         histogram->count[i]);
+        }
+    }
+}
+#endif
+
+void uart_print_rx_stats(void)
+{
+    uart_rx_stats_t stats;
+
+    uart_get_rx_stats(&stats);
+    print_printf("\r\nRX: %lu bytes, %lu interrupts (largest %lu), %lu dropped\r\n",
+                 stats.rx_bytes, stats.rx_events, stats.largest_chunk, stats.rx_dropped);
+    print_printf("    %lu commands, %lu frames, %lu task wakeups, %lu reads\r\n",
+                 stats.commands, stats.frames, stats.task_wakeups, stats.task_reads);
+    print_printf("    errors: parity %lu, noise %lu, framing %lu, overrun %lu, dma %lu\r\n",
+                 stats.parity_errors, stats.noise_errors, stats.framing_errors,
+                 stats.overrun_errors, stats.dma_errors);
+    print_printf("    line buffers: %lu in use, peak %lu of %u\r\n",
+                 stats.pool_in_use, stats.pool_peak, (unsigned)COMMAND_POOL_SIZE);
+
+#if UART_RX_TIMING
+    // Static keeps the ~260-byte snapshot off the caller's stack
+    static uart_rx_timing_t timing;
+
+    uart_get_rx_timing(&timing);
+    uart_print_histogram("Burst gap (us)", &timing.gap_us);
+    uart_print_histogram("Burst length (bytes)", &timing.burst_bytes);
+    uart_print_histogram("ISR to task wake (cycles)", &timing.wake_cycles);
+#else
+    print_const("    (timing histograms: build with UART_RX_TIMING=1)\r\n");
+#endif
+}
+
+/**
+ * @brief  Append a run of ordinary text to the command buffer
+ * @param  data: Bytes containing no CR, LF, backspace or DEL
+ * @param  length: Number of bytes
+ * @retval None
+ *
+ * Same rules as the old per-character path: text is added while it fits
+ * (one byte reserved for the terminator); the first byte that does not
+ * fit reports an overflow, resets the buffer and is discarded, and the
+ * rest of the run starts a new command.
+ */
+static void uart_rx_append(const uint8_t *data, size_t length)
+{
+#if !UART_LINE_DISCIPLINE
+    // Echo the whole run in one print message (in line discipline mode
+    // the RX interrupt already echoed it)
+    if (uart_echo) {
+        print_write(data, length);
+    }
+#endif
+
+    while (length > 0) {
+        size_t space = (COMMAND_MAX_LENGTH - 1) - rx_index;
+        size_t copy = (length < space) ? length : space;
+
+        memcpy(&rx_buffer[rx_index], data, copy);
+        rx_index += copy;
+        data += copy;
+        length -= copy;
+
+        if (length > 0) {
+            // Buffer full - discard character and reset buffer
+            // This can happen if user types long string without pressing Enter
+            print_const("\r\nError: Buffer overflow!\r\n");
+            // Reset buffer - user must retype command
+            rx_index = 0;
+            data++;
+            length--;
+        }
+    }
+}
+
+char *command_buffer(uint8_t index)
+{
+    configASSERT(index < COMMAND_POOL_SIZE);
+    return command_pool[index];
+}
+
+void command_buffer_release(uint8_t index)
+{
+    // Returned in queue order: the oldest buffer still out
+    int in_order = cmd_pool_release(&command_pool_state, index);
+    configASSERT(in_order);
+    (void)in_order;
+}
+
+/**
+ * @brief  Pass the command in rx_buffer to the command handler
+ * @retval BaseType_t: pdPASS if queued, pdFAIL if the queue stayed full
+ *
+ * Only the pool index is queued. On success rx_buffer moves on to the
+ * next pool buffer; on failure it is reused for the next command.
+ */
+static BaseType_t uart_rx_submit(void)
+{
+    uint8_t index = cmd_pool_fill_index(&command_pool_state);
+
+    // Send command to queue (100ms timeout to prevent deadlock)
+    // The queue holds a full pipeline window, so this should rarely block
+    BaseType_t queued = xQueueSend(command_queue, &index, pdMS_TO_TICKS(100));
+#if UART_FLOW_CONTROL != UART_FLOW_NONE
+    // The sender is held off while we wait (the stream buffer fills
+    // up to the watermark), so keep waiting for the handler instead
+    // of dropping the command
+    while (queued != pdPASS) {
+        stat_queue_stalls++;
+        if (uart_rx_check_alive() && uart_wd_id != WATCHDOG_INVALID_ID) {
+            watchdog_feed(uart_wd_id);
+        }
+        queued = xQueueSend(command_queue, &index, pdMS_TO_TICKS(100));
+    }
+#else
+    if (queued != pdPASS) {
+        stat_queue_stalls++;
+    }
+#endif
+    // A block of commands can keep us waiting on the handler for a
+    // while: don't leave a stalled receiver until the next read
+    (void)uart_rx_check_alive();
+
+    if (queued == pdPASS) {
+        // The queue wakes the handler, which prints the response and
+        // redisplays the appropriate menu
+        stat_commands++;
+
+        // At most COMMAND_QUEUE_DEPTH queued + 1 executing: the next is free
+        int next_free = cmd_pool_submit(&command_pool_state);
+        configASSERT(next_free);
+        (void)next_free;
+        rx_buffer = command_pool[cmd_pool_fill_index(&command_pool_state)];
+    }
+    return queued;
+}
+
+/**
+ * @brief  Decode a complete frame and pass it to the command handler
+ * @retval None
+ *
+ * A corrupt frame is only counted: its sequence number cannot be
+ * trusted, so the client detects the loss by the missing response.
+ */
+static void uart_rx_frame_complete(void)
+{
+    uint8_t *item = (uint8_t *)rx_buffer;
+    size_t length;
+
+    // Decoded straight into the next line buffer. A typed line can only
+    // be pending here without the line discipline; a frame in the middle
+    // of it discards it.
+    rx_index = 0;
+    if (cmd_frame_decode(rx_frame, rx_frame_len, &item[2], &length) != CMD_FRAME_OK) {
+        stat_frame_errors++;
+        return;
+    }
+
+    item[0] = COMMAND_FRAME_MARKER;
+    item[1] = (uint8_t)length;
+
+    if (uart_rx_submit() == pdPASS) {
+        stat_frames++;
+    }
+}
+
+/**
+ * @brief  Collect frame bytes up to the closing delimiter
+ * @param  data: Received bytes (frame mode)
+ * @param  length: Number of bytes
+ * @retval Number of bytes consumed (including the delimiter, if found)
+ *
+ * Frame bytes bypass the line editor: no echo, and CR or backspace
+ * inside a frame are data. The delimiter is found with memchr(), so a
+ * frame costs one copy however it is split across blocks.
+ */
+static size_t uart_rx_frame_collect(const uint8_t *data, size_t length)
+{
+    const uint8_t *end = memchr(data, CMD_FRAME_DELIMITER, length);
+    size_t run = (end != NULL) ? (size_t)(end - data) : length;
+
+    if (!rx_frame_discard) {
+        if (run <= sizeof(rx_frame) - rx_frame_len) {
+            memcpy(&rx_frame[rx_frame_len], data, run);
+            rx_frame_len += run;
+        } else {
+            rx_frame_discard = pdTRUE;  // Oversized - skip to its delimiter
+            stat_frame_errors++;
+        }
+    }
+
+    if (end == NULL) {
+        return length;
+    }
+
+    if (rx_frame_discard) {
+        rx_frame_discard = pdFALSE;
+        rx_frame_active = pdFALSE;
+    } else if (rx_frame_len > 0) {
+        uart_rx_frame_complete();
+        rx_frame_active = pdFALSE;
+    }
+    // else: repeated delimiter - the frame is still to come
+
+    return run + 1;
+}
+
+void uart_set_echo(BaseType_t enable)
+{
+    uart_echo = enable;
+}
+
+/**
+ * @brief  Handle a CR, LF, backspace, DEL, NUL, SO or SI byte
+ * @param  c: Special character found by line_scan_special()
+ * @retval None
+ */
+static void uart_rx_special(uint8_t c)
+{
+    /*
+     * Case 1: Command Complete (CR or LF)
+     * User pressed Enter - process the complete command
+     */
+    if (c == '\n' || c == '\r') {
+        if (rx_index > 0) {
+            // Null-terminate the string for safe string operations
+            rx_buffer[rx_index] = '\0';
+
+            if (uart_rx_submit() != pdPASS) {
+                // Queue full - unlikely but handle gracefully
+                print_const("\r\nError: Command queue full!\r\n");
+            }
+
+            // Start the next command (in the next pool buffer if queued)
+            rx_index = 0;
+
+            // Note: We DON'T print "Enter command:" here
+            // The command handler will print the appropriate menu after processing
+        }
+    }
+    /*
+     * Case 2: Frame Delimiter (NUL)
+     * Start of a binary command frame - collected by uart_rx_frame_collect()
+     */
+    else if (c == CMD_FRAME_DELIMITER) {
+        rx_frame_active = pdTRUE;
+        rx_frame_len = 0;
+    }
+    /*
+     * Case 3: Session Mode Escape (SO / SI)
+     * Echo switches right away; the handler switches its output when it
+     * reaches the command, after everything typed before the escape
+     */
+    else if (c == UART_SESSION_MACHINE || c == UART_SESSION_INTERACTIVE) {
+        BaseType_t interactive = (c == UART_SESSION_INTERACTIVE) ? pdTRUE : pdFALSE;
+
+        // Queued as the equivalent command; like a frame, it takes the
+        // buffer of a partly typed line (only possible without the line
+        // discipline)
+        uart_echo = interactive;
+        strcpy(rx_buffer, interactive ? "interactive" : "machine");
+        if (uart_rx_submit() != pdPASS) {
+            print_const("\r\nError: Command queue full!\r\n");
+        }
+        rx_index = 0;
+    }
+    /*
+     * Case 4: Backspace Character
+     * User pressed backspace - remove last character from buffer
+     */
+    else if (rx_index > 0) {
+        // Remove last character from buffer
+        rx_index--;
+        rx_buffer[rx_index] = '\0';
+
+        // Visual feedback: backspace sequence erases character on terminal
+        // Sequence: \b (move cursor left) + space (overwrite char) + \b (move back)
+        if (uart_echo) {
+            print_const("\b \b");
+        }
     }
 }
 
@@ -182,7 +1262,7 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
  * @param  parameters: Task parameters (unused)
  * @retval None (task never returns)
  *
- * This task performs character-by-character reception with the following features:
+ * This task drains the stream buffer in blocks and edits the command line:
  *
  * Startup Sequence:
  * 1. Clear RX buffer to prevent boot-time garbage
@@ -190,35 +1270,33 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
  * 3. Print welcome message and main menu
  *
  * Main Loop Operations:
- * - Receive one character from stream buffer (TRUE BLOCKING - yields CPU)
- * - Echo character back to terminal
- * - Handle special characters:
+ * - Receive everything available (up to UART_RX_BLOCK_SIZE bytes) in one
+ *   stream buffer call (TRUE BLOCKING - yields CPU)
+ * - Split the block with line_scan_special() into runs of ordinary text
+ *   and the special characters between them:
+ *   * Runs: echoed and appended with one call each
  *   * CR/LF: Process complete command
  *   * Backspace: Delete last character
- *   * Normal: Add to buffer
+ *   * SO/SI: Switch to machine / interactive mode
  *
  * Command Processing Flow:
  * 1. User types command + Enter
- * 2. Command added to queue
- * 3. Command handler task notified
+ * 2. Command pool index added to queue
+ * 3. Command handler task woken by the queue
  * 4. Handler prints response and appropriate menu
  *
  * Efficiency:
  * - Task enters BLOCKED state when no data (yields CPU to other tasks)
- * - Woken immediately by ISR when byte arrives
- * - Zero CPU waste (no polling loop)
- *
- * @note Character echo is NOT mutex-protected because it's a single-byte
- *       transmission within the same task - no risk of corruption
+ * - Woken immediately by ISR when data arrives
+ * - A pasted script costs one kernel call per block instead of per byte
+ *   (see task_reads in uart_rx_stats_t)
  */
 void uart_task_handler(void *parameters)
 {
-    uint8_t received_char;
+    uint8_t block[UART_RX_BLOCK_SIZE];
     uint8_t dummy;
 
-    // Clear RX buffer to eliminate boot-time garbage characters
-    // This prevents "Buffer overflow!" message on first power-up
-    memset(rx_buffer, 0, UART_RX_BUFFER_SIZE);
+    // Start with an empty command line (no boot-time garbage)
     rx_index = 0;
 
     // Wait for UART peripheral to stabilize after initialization
@@ -231,118 +1309,117 @@ void uart_task_handler(void *parameters)
         (void)dummy;  // Suppress unused variable warning
     }
 
+#if UART_AUTOBAUD
+    // Time the first character from here on (not the power-on glitches).
+    // The welcome screen waits until it has set the rate.
+    uart_autobaud_arm();
+#else
     // Print initial UI
     print_welcome_message();
     print_main_menu();
+#endif
 
     // Register with watchdog (5 second timeout = 2.5× the 2s blocking period)
-    watchdog_id_t wd_id = watchdog_register("UART_task", 5000);
-    if (wd_id == WATCHDOG_INVALID_ID) {
-        print_message("[UART] Failed to register with watchdog!\r\n");
+    uart_wd_id = watchdog_register("UART_task", 5000);
+    if (uart_wd_id == WATCHDOG_INVALID_ID) {
+        print_log(LOG_UART_WD_REGISTER_FAIL);
     }
 
     while (1) {
         /*
          * Main Reception Loop
          * ------------------
-         * This loop processes characters one-by-one with immediate echo.
          * Uses stream buffer for TRUE BLOCKING (task yields CPU when idle).
+         * With UART_LINE_DISCIPLINE the ISR has already echoed and edited
+         * the input and delivers whole lines, so the task wakes once per
+         * command and only collects the line.
          *
          * Flow:
-         * 1. Read byte from stream buffer (TRUE BLOCKING - yields CPU)
-         * 2. ISR wakes us immediately when byte arrives
-         * 3. Echo character to terminal (user feedback)
-         * 4. Process character:
-         *    - CR/LF: Complete command -> send to queue -> notify handler
+         * 1. Read up to a block from stream buffer (TRUE BLOCKING)
+         * 2. ISR wakes us immediately when data arrives
+         * 3. Scan for the next special character; everything before it
+         *    is one run of text -> echo + append
+         * 4. Process the special character:
+         *    - CR/LF: Complete command -> queue its pool index
          *    - Backspace: Remove last character from buffer
-         *    - Normal: Add to buffer (with overflow check)
+         *    - NUL: Binary frame -> collect up to the closing delimiter,
+         *      decode into the next pool buffer -> queue its index
          */
 
-        // Read one byte from stream buffer with finite timeout
+        // Read whatever is available with finite timeout
         // Timeout allows periodic watchdog feeding even when no UART activity
         // 2 second timeout provides good balance between responsiveness and watchdog checking
+        // While a "baud" switch is unconfirmed, wake often enough to revert
+        // soon after baud_revert_timer expires
+        TickType_t wait = (baud_confirmed != 0) ? pdMS_TO_TICKS(100) : pdMS_TO_TICKS(2000);
+        BaseType_t will_block = xStreamBufferIsEmpty(uart_stream_buffer);
         size_t received = xStreamBufferReceive(uart_stream_buffer,
-                                               &received_char,
-                                               1,
-                                               pdMS_TO_TICKS(2000));
+                                               block,
+                                               sizeof(block),
+                                               wait);
+        if (received != 0) {
+            stat_task_reads++;
+            if (will_block) {
+                stat_task_wakeups++;
+            }
+#if UART_AUTOBAUD
+            if (autobaud_welcome) {
+                // First data after the timed character: the rate is set
+                autobaud_welcome = pdFALSE;
+                if (autobaud_changed != 0) {
+                    print_printf("\r\nAuto-baud: %lu baud\r\n", autobaud_changed);
+                }
+                print_welcome_message();
+                print_main_menu();
+            }
+#endif
+#if UART_RX_TIMING
+            if (timing_wake_pending) {
+                uart_rx_histogram_add(&rx_timing.wake_cycles, DWT->CYCCNT - timing_wake_stamp);
+                timing_wake_pending = pdFALSE;
+            }
+#endif
+        }
 
-        // Feed watchdog to prove task is alive
-        // Fed on every iteration (whether data received or timeout)
-        if (wd_id != WATCHDOG_INVALID_ID) {
-            watchdog_feed(wd_id);
+#if UART_FLOW_CONTROL != UART_FLOW_NONE
+        // Restart the sender once the backlog has drained to the low watermark
+        taskENTER_CRITICAL();
+        uart_rx_throttle();
+        taskEXIT_CRITICAL();
+#endif
+
+        // Undo an unconfirmed "baud" switch once its timer has expired
+        if (baud_revert_due) {
+            uart_baud_revert();
         }
 
-        // If timeout (no data received), continue to next iteration
-        if (received == 0) {
-            continue;
+        // Re-arm reception if an error left it stopped
+        BaseType_t rx_alive = uart_rx_check_alive();
+
+        // Feed watchdog to prove task is alive
+        // Fed on every iteration (whether data received or timeout), as
+        // long as input can still arrive
+        if (uart_wd_id != WATCHDOG_INVALID_ID && rx_alive) {
+            watchdog_feed(uart_wd_id);
         }
 
-        // Data received - process the character
-        {
-            /*
-             * Case 1: Command Complete (CR or LF)
-             * User pressed Enter - process the complete command
-             */
-            if (received_char == '\n' || received_char == '\r') {
-                if (rx_index > 0) {
-                    // Null-terminate the string for safe string operations
-                    rx_buffer[rx_index] = '\0';
-
-                    // Send command to queue (100ms timeout to prevent deadlock)
-                    // Queue depth is 5, so this should rarely block
-                    if (xQueueSend(command_queue, rx_buffer, pdMS_TO_TICKS(100)) == pdPASS) {
-                        // Wake up command handler task to process the command
-                        // Handler will print response and redisplay appropriate menu
-                        xTaskNotifyGive(command_handler_task_handle);
-                    } else {
-                        // Queue full - unlikely but handle gracefully
-                        print_message("\r\nError: Command queue full!\r\n");
-                    }
-
-                    // Reset buffer for next command
-                    rx_index = 0;
-                    memset(rx_buffer, 0, UART_RX_BUFFER_SIZE);
-
-                    // Note: We DON'T print "Enter command:" here
-                    // The command handler will print the appropriate menu after processing
-                }
+        // Data received - split the block into text runs, special characters
+        // and frames (nothing to do on timeout: received == 0)
+        size_t pos = 0;
+        while (pos < received) {
+            if (rx_frame_active) {
+                pos += uart_rx_frame_collect(&block[pos], received - pos);
+                continue;
             }
-            /*
-             * Case 2: Backspace Character
-             * User pressed backspace - remove last character from buffer
-             */
-            else if (received_char == '\b' || received_char == 127) {
-                if (rx_index > 0) {
-                    // Remove last character from buffer
-                    rx_index--;
-                    rx_buffer[rx_index] = '\0';
-
-                    // Visual feedback: backspace sequence erases character on terminal
-                    // Sequence: \b (move cursor left) + space (overwrite char) + \b (move back)
-                    print_message("\b \b");
-                }
+
+            size_t run = line_scan_special(&block[pos], received - pos);
+
+            if (run > 0) {
+                uart_rx_append(&block[pos], run);
+                pos += run;
             }
-            /*
-             * Case 3: Normal Character
-             * Add to buffer if space available, otherwise report overflow
-             */
-            else {
-                // Echo character through print task for exclusive UART TX ownership
-                // Print task has priority 3 (higher) so processes immediately
-                print_char(received_char);
-
-                // Check buffer space (reserve 1 byte for null terminator)
-                if (rx_index < (UART_RX_BUFFER_SIZE - 1)) {
-                    // Add character to buffer
-                    rx_buffer[rx_index++] = received_char;
-                } else {
-                    // Buffer full - discard character and reset buffer
-                    // This can happen if user types long string without pressing Enter
-                    print_message("\r\nError: Buffer overflow!\r\n");
-                    // Reset buffer - user must retype command
-                    rx_index = 0;
-                    memset(rx_buffer, 0, UART_RX_BUFFER_SIZE);
-                }
+            if (pos < received) {
+                uart_rx_special(block[pos++]);
             }
         }
     }
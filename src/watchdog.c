@@ -12,21 +12,24 @@
  * - Watchdog task wakes every WATCHDOG_CHECK_PERIOD_MS
  * - Checks all tasks: if time_since_last_feed > timeout → ALERT!
  *
+ * Output:
+ * - Status lines go through the print task like any other log event
+ * - Alerts use the urgent print lane: they never block this (highest
+ *   priority) task and overtake pending menu output
+ * - Only if the hung task is the print task itself is the alert written
+ *   with polled UART TX (print_port_emergency_write()), since nothing
+ *   queued would ever reach the wire
+ *
  ******************************************************************************
  */
 
 #include "watchdog.h"
+#include "print_task.h"
+#include "print_log.h"
+#include "print_port.h"
 #include <string.h>
 #include <stdio.h>
-
-/* Optional: Use print task if available */
-#ifdef PRINT_TASK_H_
-#include "print_task.h"
-#define WATCHDOG_PRINT(msg) print_message(msg)
-#else
-extern UART_HandleTypeDef huart2;
-#define WATCHDOG_PRINT(msg) HAL_UART_Transmit(&huart2, (uint8_t*)(msg), strlen(msg), 100)
-#endif
+#include <stdarg.h>
 
 /*============================================================================
  * Private Types
@@ -35,6 +38,7 @@ extern UART_HandleTypeDef huart2;
 /** Watchdog entry for each registered task */
 typedef struct {
     char task_name[16];           // Task name (for debugging)
+    TaskHandle_t task;            // Registering task
     uint32_t timeout_ms;          // Max time between feeds
     TickType_t last_feed_tick;    // Last time task fed watchdog
     BaseType_t registered;        // Is this slot in use?
@@ -62,6 +66,29 @@ static TaskHandle_t watchdog_task_handle = NULL;
 
 static void watchdog_task(void *parameters);
 
+/**
+ * @brief  Format a log event and transmit it with polled UART TX
+ * @note   Emergency path only - used when the print task is the hung task
+ */
+static void watchdog_log_emergency(print_log_id_t id, ...)
+{
+    char msg[160];
+    va_list ap;
+
+    va_start(ap, id);
+    int length = vsnprintf(msg, sizeof(msg), print_log_format(id), ap);
+    va_end(ap);
+
+    if (length < 0) {
+        return;
+    }
+    if ((size_t)length >= sizeof(msg)) {
+        length = sizeof(msg) - 1;
+    }
+
+    print_port_emergency_write((const uint8_t *)msg, (uint16_t)length);
+}
+
 /*============================================================================
  * Public Functions
  *===========================================================================*/
@@ -88,7 +115,7 @@ void watchdog_init(void)
 
     configASSERT(status == pdPASS);
 
-    WATCHDOG_PRINT("\r\n[WATCHDOG] Initialized\r\n");
+    print_log(LOG_WATCHDOG_INIT);
 }
 
 /**
@@ -98,7 +125,7 @@ watchdog_id_t watchdog_register(const char *task_name, uint32_t timeout_ms)
 {
     // Check if we have space
     if (num_registered >= WATCHDOG_MAX_TASKS) {
-        WATCHDOG_PRINT("[WATCHDOG] ERROR: Max tasks reached!\r\n");
+        print_log_urgent(LOG_WATCHDOG_MAX_TASKS);
         return WATCHDOG_INVALID_ID;
     }
 
@@ -119,6 +146,7 @@ watchdog_id_t watchdog_register(const char *task_name, uint32_t timeout_ms)
     {
         strncpy(watchdog_tasks[id].task_name, task_name, sizeof(watchdog_tasks[id].task_name) - 1);
         watchdog_tasks[id].task_name[sizeof(watchdog_tasks[id].task_name) - 1] = '\0';
+        watchdog_tasks[id].task = xTaskGetCurrentTaskHandle();
         watchdog_tasks[id].timeout_ms = timeout_ms;
         watchdog_tasks[id].last_feed_tick = xTaskGetTickCount();
         watchdog_tasks[id].registered = pdTRUE;
@@ -126,11 +154,8 @@ watchdog_id_t watchdog_register(const char *task_name, uint32_t timeout_ms)
     }
     taskEXIT_CRITICAL();
 
-    // Log registration
-    char msg[64];
-    snprintf(msg, sizeof(msg), "[WATCHDOG] Registered '%s' (ID=%u, timeout=%lums)\r\n",
-             task_name, id, timeout_ms);
-    WATCHDOG_PRINT(msg);
+    // Log registration (name from the static table: outlives deferred formatting)
+    print_log(LOG_WATCHDOG_REGISTERED, watchdog_tasks[id].task_name, id, timeout_ms);
 
     return id;
 }
@@ -202,23 +227,25 @@ static void watchdog_task(void *parameters)
 
     TickType_t last_wake = xTaskGetTickCount();
 
-    WATCHDOG_PRINT("[WATCHDOG] Monitor task started\r\n");
+    print_log_urgent(LOG_WATCHDOG_STARTED);
 
     while (1) {
         // Sleep for check period
         vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(WATCHDOG_CHECK_PERIOD_MS));
 
-        // Get current time
-        TickType_t now = xTaskGetTickCount();
-
         // Check all registered tasks
         for (uint8_t id = 0; id < WATCHDOG_MAX_TASKS; id++) {
             if (!watchdog_tasks[id].registered) {
                 continue;  // Skip unregistered slots
             }
 
-            // Calculate time since last feed
+            // Calculate time since last feed. Read the clock together with
+            // the feed time: a feed landing after an earlier reading of the
+            // clock would make the difference wrap to a huge false timeout
+            taskENTER_CRITICAL();
+            TickType_t now = xTaskGetTickCount();
             TickType_t elapsed_ticks = now - watchdog_tasks[id].last_feed_tick;
+            taskEXIT_CRITICAL();
             uint32_t elapsed_ms = pdTICKS_TO_MS(elapsed_ticks);
 
             // Check if timeout exceeded
@@ -228,20 +255,21 @@ static void watchdog_task(void *parameters)
                 if (timeout_callback) {
                     // Call user callback
                     timeout_callback(id, watchdog_tasks[id].task_name, elapsed_ms);
+                } else if (watchdog_tasks[id].task != NULL &&
+                           watchdog_tasks[id].task == print_task_get_handle()) {
+                    // Print task hung: queued output would never appear
+                    watchdog_log_emergency(LOG_WATCHDOG_ALERT,
+                                           watchdog_tasks[id].task_name,
+                                           id,
+                                           elapsed_ms,
+                                           watchdog_tasks[id].timeout_ms);
                 } else {
-                    // Default: print warning
-                    char alert_msg[128];
-                    snprintf(alert_msg, sizeof(alert_msg),
-                             "\r\n*** WATCHDOG ALERT ***\r\n"
-                             "Task: %s (ID=%u)\r\n"
-                             "Last feed: %lu ms ago\r\n"
-                             "Timeout: %lu ms\r\n"
-                             "Status: HUNG or DEADLOCKED!\r\n\r\n",
-                             watchdog_tasks[id].task_name,
-                             id,
-                             elapsed_ms,
-                             watchdog_tasks[id].timeout_ms);
-                    WATCHDOG_PRINT(alert_msg);
+                    // Default: print warning (non-blocking, ahead of menus)
+                    print_log_urgent(LOG_WATCHDOG_ALERT,
+                                     watchdog_tasks[id].task_name,
+                                     id,
+                                     elapsed_ms,
+                                     watchdog_tasks[id].timeout_ms);
                 }
 
                 // Reset timer to avoid spam (task may be permanently hung)
@@ -0,0 +1,227 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_args_bench.c
+ * @brief          : Host benchmark for the typed command argument parser
+ ******************************************************************************
+ * @description
+ * Parses a mix of parameterised commands ("blink green 37", "duty orange
+ * 25", "pattern 2", "baud 115200", plus a few with argument errors) the
+ * way process_global_command() does: split in place, find the command by
+ * its first word, check the word count, convert the arguments. Then the
+ * same with the usual library route (strtok_r, strtoul with end-pointer
+ * and errno checks) for comparison. Both must produce the same results.
+ *
+ * Each command is first copied into a line buffer, as split modifies it;
+ * the copy is part of both timings.
+ *
+ * The target budget is a few microseconds per command at 168 MHz. The
+ * host is several times faster than a Cortex-M4, so compare the parser's
+ * host time against the budget with that margin in mind.
+ *
+ * Build and run (from the repository root):
+ *   cc -O2 -Iincludes tools/cmd_args_bench.c src/cmd_args.c -o cmd_args_bench
+ *   ./cmd_args_bench [million_commands]
+ ******************************************************************************
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "cmd_args.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_LINE_SIZE 64      /* COMMAND_MAX_LENGTH */
+
+/* Command table, as global_commands[] in command_handler.c */
+typedef enum { CMD_BAUD, CMD_PATTERN, CMD_BLINK, CMD_DUTY, CMD_COUNT } bench_cmd_t;
+
+static const struct {
+    const char *name;
+    uint8_t args;
+    uint32_t min, max;          /* Range of the numeric argument */
+    uint8_t led;                /* First argument is an LED name */
+} commands[CMD_COUNT] = {
+    [CMD_BAUD]    = { "baud",    1, 9600, 2000000, 0 },
+    [CMD_PATTERN] = { "pattern", 1, 0,    3,       0 },
+    [CMD_BLINK]   = { "blink",   2, 10,   10000,   1 },
+    [CMD_DUTY]    = { "duty",    2, 0,    100,     1 },
+};
+
+static const char *const led_names[] = { "green", "orange" };
+
+static const char *const input[16] = {
+    "blink green 37",  "duty orange 25", "pattern 2",   "blink orange 500",
+    "duty green 100",  "pattern 0",      "baud 115200", "blink green 5",
+    "duty orange 75",  "pattern 3",      "blink red 100", "duty green 50",
+    "blink orange 10000", "pattern 9",   "duty green 1x", "blink green 250",
+};
+
+/* Result code: command, LED and value (or error) folded into one number */
+static unsigned long result_ok(unsigned cmd, unsigned led, uint32_t value)
+{
+    return ((unsigned long)cmd << 28) ^ ((unsigned long)led << 24) ^ value;
+}
+
+static unsigned long result_error(int error)
+{
+    return 0xE0000000ul | (unsigned long)error;
+}
+
+/* --- cmd_args: in place, no library conversions --- */
+
+static unsigned long parse_cmd_args(char *line)
+{
+    cmd_args_t args;
+    size_t cmd, led = 0;
+    uint32_t value;
+
+    cmd_args_status_t status = cmd_args_split(line, &args);
+    if (args.argc == 0) {
+        return result_error(CMD_ARGS_ERR_COUNT);
+    }
+    for (cmd = 0; cmd < CMD_COUNT; cmd++) {
+        if (strcmp(args.argv[0], commands[cmd].name) == 0) {
+            break;
+        }
+    }
+    if (cmd == CMD_COUNT) {
+        return result_error(-1);
+    }
+    if (status != CMD_ARGS_OK || args.argc - 1 != commands[cmd].args) {
+        return result_error(CMD_ARGS_ERR_COUNT);
+    }
+
+    if (commands[cmd].led) {
+        status = cmd_args_keyword(args.argv[1], led_names, 2, &led);
+        if (status != CMD_ARGS_OK) {
+            return result_error(status);
+        }
+    }
+    status = cmd_args_uint(args.argv[args.argc - 1], commands[cmd].min, commands[cmd].max, &value);
+    if (status != CMD_ARGS_OK) {
+        return result_error(status);
+    }
+    return result_ok((unsigned)cmd, (unsigned)led, value);
+}
+
+/* --- library route: strtok_r + strtoul --- */
+
+static unsigned long parse_library(char *line)
+{
+    char *save;
+    char *argv[CMD_ARGS_MAX + 1];
+    size_t argc = 0, cmd, led = 0;
+
+    for (char *word = strtok_r(line, " \t", &save); word != NULL; word = strtok_r(NULL, " \t", &save)) {
+        if (argc == CMD_ARGS_MAX) {
+            argc++;
+            break;
+        }
+        argv[argc++] = word;
+    }
+    if (argc == 0) {
+        return result_error(CMD_ARGS_ERR_COUNT);
+    }
+    for (cmd = 0; cmd < CMD_COUNT; cmd++) {
+        if (strcmp(argv[0], commands[cmd].name) == 0) {
+            break;
+        }
+    }
+    if (cmd == CMD_COUNT) {
+        return result_error(-1);
+    }
+    if (argc - 1 != commands[cmd].args) {
+        return result_error(CMD_ARGS_ERR_COUNT);
+    }
+
+    if (commands[cmd].led) {
+        for (led = 0; led < 2 && strcmp(argv[1], led_names[led]) != 0; led++) {
+        }
+        if (led == 2) {
+            return result_error(CMD_ARGS_ERR_KEYWORD);
+        }
+    }
+
+    const char *word = argv[argc - 1];
+    char *end;
+    if (word[0] < '0' || word[0] > '9') {
+        return result_error(CMD_ARGS_ERR_NUMBER);   /* strtoul takes signs and spaces */
+    }
+    errno = 0;
+    unsigned long value = strtoul(word, &end, 10);
+    if (*end != '\0') {
+        return result_error(CMD_ARGS_ERR_NUMBER);
+    }
+    if (errno == ERANGE || value < commands[cmd].min || value > commands[cmd].max) {
+        return result_error(CMD_ARGS_ERR_RANGE);
+    }
+    return result_ok((unsigned)cmd, (unsigned)led, (uint32_t)value);
+}
+
+/* ------------------------------------------------------------------------- */
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double bench(unsigned long (*parse)(char *), unsigned long count, unsigned long *checksum)
+{
+    /* Copies, so the compiler cannot fold the input */
+    static char source[16][BENCH_LINE_SIZE];
+    char line[BENCH_LINE_SIZE];
+
+    for (size_t i = 0; i < 16; i++) {
+        strcpy(source[i], input[i]);
+    }
+
+    unsigned long sum = 0;
+    double start = now_seconds();
+    for (unsigned long i = 0; i < count; i++) {
+        memcpy(line, source[i & 15], BENCH_LINE_SIZE);
+        sum = sum * 31 + parse(line);
+    }
+    double elapsed = now_seconds() - start;
+
+    *checksum = sum;
+    return elapsed * 1e9 / count;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long count = (unsigned long)(((argc > 1) ? atof(argv[1]) : 20.0) * 1000000.0);
+    unsigned long sum_args, sum_library;
+    char a[BENCH_LINE_SIZE], b[BENCH_LINE_SIZE];
+
+    if (count == 0) {
+        return 1;
+    }
+
+    /* Both must agree on every command, errors included */
+    for (size_t i = 0; i < 16; i++) {
+        strcpy(a, input[i]);
+        strcpy(b, input[i]);
+        if (parse_cmd_args(a) != parse_library(b)) {
+            fprintf(stderr, "mismatch: \"%s\"\n", input[i]);
+            return 1;
+        }
+    }
+
+    double args_ns = bench(parse_cmd_args, count, &sum_args);
+    double library_ns = bench(parse_library, count, &sum_library);
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < 16; i++) {
+        bytes += strlen(input[i]);
+    }
+
+    printf("Typed command parse, %lu commands (avg %zu bytes)\n", count, bytes / 16);
+    printf("cmd_args         %6.1f ns/command  (checksum %lu)\n", args_ns, sum_args);
+    printf("strtok+strtoul   %6.1f ns/command  (checksum %lu)\n", library_ns, sum_library);
+    printf("speedup          %6.2fx\n", library_ns / args_ns);
+    return sum_args != sum_library;
+}
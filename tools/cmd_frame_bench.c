@@ -0,0 +1,276 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_frame_bench.c
+ * @brief          : Host benchmark for binary command frames
+ ******************************************************************************
+ * @description
+ * Two parts:
+ *
+ * 1. CPU cost of the firmware's frame code (cmd_frame.c built for the
+ *    host): decode + CRC check of a request and encode of its response,
+ *    per command.
+ *
+ * 2. Commands per second on the link for "select LED pattern", using the
+ *    exact bytes each protocol puts on the wire:
+ *    - menu (plain):  "2\r" in, echo + confirmation + full menu out
+ *    - menu (VT100):  "2\r" in, echo + marker/status update out
+ *    - machine mode:  "2\r" in, "ok\r\n" out (no echo, no menu)
+ *    - binary frame:  request frame in, response frame out
+ *    Stop-and-wait rate = 1 / (request time + response time + turnaround);
+ *    the turnaround (USB adapter latency + firmware) is a parameter.
+ *    The wire limit is what a client that keeps requests in flight could
+ *    reach (the link is full duplex, so the busier direction limits).
+ *
+ * 3. Commands per second against the pipeline window (commands sent
+ *    before the first acknowledgement arrives). A request/ack timeline
+ *    is simulated: the downlink and uplink serialise bytes, each direction
+ *    adds half the turnaround, and the handler runs commands one after
+ *    another. It is shown for sequenced text commands ("@<seq> 2" ->
+ *    "ack <seq> ok"), in interactive and machine mode, and for binary
+ *    frames. The command queue occupancy
+ *    is tracked too: a window up to COMMAND_QUEUE_DEPTH never fills it.
+ *
+ * 4. Time to reconfigure a board with a short script in machine mode:
+ *    one round trip per command, or the whole script as one batch line
+ *    ("1;pattern 2;...") answered once.
+ *
+ * On the board, tools/cmd_frame_client.py bench measures the real rate.
+ *
+ * Build and run (from the repository root):
+ *   cc -O2 -Iincludes tools/cmd_frame_bench.c src/cmd_frame.c -o cmd_frame_bench
+ *   ./cmd_frame_bench [turnaround_us]
+ ******************************************************************************
+ */
+
+#include "cmd_frame.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_ITERATIONS 2000000
+#define BENCH_PIPELINE_COMMANDS 10000
+#define BENCH_QUEUE_DEPTH 5         /* COMMAND_QUEUE_DEPTH default */
+#define BENCH_HANDLER_US 60.0       /* Command execution + ack enqueue */
+#define BENCH_COMMAND_MAX_LENGTH 64 /* COMMAND_MAX_LENGTH (line + NUL) */
+
+/* Text the plain menu sends for "2" (print_led_patterns_menu() and the
+ * confirmation in command_handler.c) */
+static const char led_confirmation[] = "\r\nNow playing LED Pattern 2\r\n";
+static const char led_menu[] =
+    "\r\n========================================\r\n"
+    "        LED Pattern Selection\r\n"
+    "========================================\r\n"
+    "  0 - Return to main menu\r\n"
+    "  1 - All LEDs ON\r\n"
+    "  2 - Different Frequency Blinking\r\n"
+    "  3 - Same Frequency Blinking\r\n"
+    "  4 - All LEDs OFF\r\n"
+    "========================================\r\n"
+    "Enter selection: ";
+
+typedef struct {
+    const char *name;
+    size_t in;      /* Bytes host -> board */
+    size_t out;     /* Bytes board -> host */
+} bench_protocol_t;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Request decode + response encode, as the UART task and handler do it */
+static void bench_cpu(void)
+{
+    uint8_t request[CMD_FRAME_MAX_WIRE];
+    uint8_t response_wire[CMD_FRAME_MAX_WIRE];
+    uint8_t payload[CMD_FRAME_MAX_PAYLOAD];
+    size_t request_len = cmd_frame_encode((const uint8_t[]){ CMD_OP_SET_PATTERN, 0x5A, 2 }, 3,
+                                          request, sizeof(request));
+    volatile unsigned long sink = 0;    // Keeps the work from being optimised away
+
+    double start = now_seconds();
+    for (unsigned long i = 0; i < BENCH_ITERATIONS; i++) {
+        size_t length;
+        if (cmd_frame_decode(&request[1], request_len - 2, payload, &length) != CMD_FRAME_OK) {
+            fprintf(stderr, "decode failed\n");
+            exit(1);
+        }
+        uint8_t response[3] = { (uint8_t)(payload[0] | CMD_FRAME_RESPONSE), payload[1], 0 };
+        sink += cmd_frame_encode(response, sizeof(response), response_wire, sizeof(response_wire));
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("CPU: %.0f ns per command (decode + CRC check + response encode)\n",
+           1e9 * elapsed / BENCH_ITERATIONS);
+}
+
+/**
+ * Simulate a client keeping up to window commands in flight
+ * Returns commands per second; *max_queued gets the deepest command queue.
+ */
+static double bench_pipeline(const bench_protocol_t *proto, unsigned window,
+                             unsigned long baud, double turnaround_us, unsigned *max_queued)
+{
+    static double arrive[BENCH_PIPELINE_COMMANDS];
+    static double start[BENCH_PIPELINE_COMMANDS];
+    static double acked[BENCH_PIPELINE_COMMANDS];
+    double byte_us = 10e6 / baud;
+    double downlink_free = 0, uplink_free = 0, handler_free = 0;
+    double one_way = turnaround_us / 2;
+
+    *max_queued = 0;
+    for (unsigned i = 0; i < BENCH_PIPELINE_COMMANDS; i++) {
+        // The client sends as soon as the window has room
+        double send = downlink_free;
+        if (i >= window && acked[i - window] > send) {
+            send = acked[i - window];
+        }
+        downlink_free = send + proto->in * byte_us;
+        arrive[i] = downlink_free + one_way;
+
+        // Handler takes commands in order
+        start[i] = (arrive[i] > handler_free) ? arrive[i] : handler_free;
+        handler_free = start[i] + BENCH_HANDLER_US;
+
+        // Commands that arrived earlier and still wait in the queue
+        unsigned queued = 0;
+        for (unsigned j = (i > 64) ? i - 64 : 0; j < i; j++) {
+            if (start[j] > arrive[i]) {
+                queued++;
+            }
+        }
+        if (queued > *max_queued) {
+            *max_queued = queued;
+        }
+
+        double ack_start = (handler_free > uplink_free) ? handler_free : uplink_free;
+        uplink_free = ack_start + proto->out * byte_us;
+        acked[i] = uplink_free + one_way;
+    }
+
+    return BENCH_PIPELINE_COMMANDS / (acked[BENCH_PIPELINE_COMMANDS - 1] / 1e6);
+}
+
+int main(int argc, char **argv)
+{
+    double turnaround_us = (argc > 1) ? atof(argv[1]) : 1000.0;
+    static const unsigned long bauds[] = { 115200, 460800, 921600 };
+    char vt100[64];
+    uint8_t frame[CMD_FRAME_MAX_WIRE];
+
+    bench_cpu();
+
+    // VT100 update for pattern 1 -> 2 (vt100_update_led_patterns_menu())
+    int vt100_len = snprintf(vt100, sizeof(vt100), "\x1b[%u;1H \x1b[%u;1H>"
+                             "\x1b[%u;%uH%s\x1b[K\x1b" "8\x1b[K", 5u, 6u, 10u, 9u, "BLINK DIFF");
+
+    size_t frame_in = cmd_frame_encode((const uint8_t[]){ CMD_OP_SET_PATTERN, 7, 2 }, 3,
+                                       frame, sizeof(frame));
+    size_t frame_out = cmd_frame_encode((const uint8_t[]){ CMD_OP_SET_PATTERN | CMD_FRAME_RESPONSE,
+                                                           7, CMD_FRAME_OK }, 3,
+                                        frame, sizeof(frame));
+
+    const bench_protocol_t protocols[] = {
+        { "menu (plain)",  2, 1 + strlen(led_confirmation) + strlen(led_menu) },
+        { "menu (VT100)",  2, 1 + (size_t)vt100_len },
+        { "machine mode",  2, strlen("ok\r\n") },
+        { "binary frame",  frame_in, frame_out },
+    };
+
+    printf("\nSelect LED pattern, turnaround %.0f us\n", turnaround_us);
+    printf("%-14s %6s %6s", "protocol", "in B", "out B");
+    for (size_t b = 0; b < sizeof(bauds) / sizeof(bauds[0]); b++) {
+        printf("   %7lu: stop-wait  wire", bauds[b]);
+    }
+    printf("\n");
+
+    for (size_t p = 0; p < sizeof(protocols) / sizeof(protocols[0]); p++) {
+        const bench_protocol_t *proto = &protocols[p];
+        printf("%-14s %6zu %6zu", proto->name, proto->in, proto->out);
+        for (size_t b = 0; b < sizeof(bauds) / sizeof(bauds[0]); b++) {
+            double byte_time = 10.0 / bauds[b];    // 8N1
+            double round_trip = (proto->in + proto->out) * byte_time + turnaround_us / 1e6;
+            size_t busier = (proto->in > proto->out) ? proto->in : proto->out;
+            printf("   %18.0f %5.0f", 1.0 / round_trip, 1.0 / (busier * byte_time));
+        }
+        printf("   cmd/s\n");
+    }
+
+    // Sequenced text: "@123 2\r" in; echo (no CR) + "\r\nack 123 ok\r\n" out,
+    // in machine mode only "ack 123 ok\r\n"
+    const bench_protocol_t pipelined[] = {
+        { "text + ack",    7, 6 + 14 },
+        { "machine + ack", 7, 12 },
+        { "binary frame",  frame_in, frame_out },
+    };
+    static const unsigned windows[] = { 1, 2, 3, 4, 5, 8 };
+
+    for (size_t b = 0; b < sizeof(bauds) / sizeof(bauds[0]); b++) {
+        printf("\nPipelined at %lu baud (turnaround %.0f us, handler %.0f us, queue depth %d)\n",
+               bauds[b], turnaround_us, BENCH_HANDLER_US, BENCH_QUEUE_DEPTH);
+        printf("%-14s", "window");
+        for (size_t w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+            printf(" %9u", windows[w]);
+        }
+        printf("\n");
+        for (size_t p = 0; p < sizeof(pipelined) / sizeof(pipelined[0]); p++) {
+            unsigned deepest = 0;
+            printf("%-14s", pipelined[p].name);
+            for (size_t w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+                unsigned queued;
+                printf(" %9.0f", bench_pipeline(&pipelined[p], windows[w], bauds[b],
+                                                turnaround_us, &queued));
+                if (queued > deepest) {
+                    deepest = queued;
+                }
+            }
+            printf("   cmd/s (queue <= %u)\n", deepest);
+        }
+    }
+
+    // Reconfiguration script; "status" answers with its line before "ok"
+    static const char *const script[] = {
+        "1", "pattern 2", "blink green 37", "duty orange 25", "status",
+    };
+    const size_t script_count = sizeof(script) / sizeof(script[0]);
+    const size_t status_out = strlen("\r\nStatus: pattern 2, menu 1\r\n");
+    size_t single_in = 0, batch_in = 0;
+
+    for (size_t i = 0; i < script_count; i++) {
+        single_in += strlen(script[i]) + 1;             // Each with its CR
+        batch_in += strlen(script[i]) + 1;              // Each with ';' or the final CR
+    }
+    if (batch_in > BENCH_COMMAND_MAX_LENGTH) {
+        fprintf(stderr, "batch line does not fit COMMAND_MAX_LENGTH\n");
+        return 1;
+    }
+    size_t single_out = script_count * strlen("ok\r\n") + status_out;
+    size_t batch_out = strlen("ok\r\n") + status_out;
+
+    printf("\nReconfigure with %zu commands, machine mode (turnaround %.0f us, handler %.0f us)\n",
+           script_count, turnaround_us, BENCH_HANDLER_US);
+    printf("%-14s %6s %6s %10s", "protocol", "in B", "out B", "trips");
+    for (size_t b = 0; b < sizeof(bauds) / sizeof(bauds[0]); b++) {
+        printf(" %9lu", bauds[b]);
+    }
+    printf("\n");
+    for (int batch = 0; batch <= 1; batch++) {
+        size_t in = batch ? batch_in : single_in;
+        size_t out = batch ? batch_out : single_out;
+        size_t trips = batch ? 1 : script_count;
+
+        printf("%-14s %6zu %6zu %10zu", batch ? "one batch" : "one by one", in, out, trips);
+        for (size_t b = 0; b < sizeof(bauds) / sizeof(bauds[0]); b++) {
+            double byte_time = 10.0 / bauds[b];
+            double total_us = (in + out) * byte_time * 1e6 + trips * turnaround_us +
+                              script_count * BENCH_HANDLER_US;
+            printf(" %9.2f", total_us / 1000.0);
+        }
+        printf("   ms\n");
+    }
+    return 0;
+}
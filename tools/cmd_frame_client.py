@@ -0,0 +1,348 @@
+#!/usr/bin/env python3
+"""
+Host client for the binary command frames (see includes/cmd_frame.h).
+
+Sends COBS + CRC-16 framed requests over the board's UART and matches the
+responses by sequence number. Text the board prints in between (menus,
+log lines) is passed to a callback instead of breaking the stream.
+
+Wire format:
+    0x00 | COBS(payload | CRC-16/CCITT-FALSE, little-endian) | 0x00
+    request payload:  OP | SEQ | args
+    response payload: OP|0x80 | SEQ | STATUS | data
+
+Usage (needs pyserial):
+    tools/cmd_frame_client.py /dev/ttyACM0 ping
+    tools/cmd_frame_client.py /dev/ttyACM0 pattern 2
+    tools/cmd_frame_client.py /dev/ttyACM0 status
+    tools/cmd_frame_client.py /dev/ttyACM0 rxstats
+    tools/cmd_frame_client.py /dev/ttyACM0 bench --count 1000 --window 4
+    tools/cmd_frame_client.py /dev/ttyACM0 bench --text --window 4
+
+bench --window N keeps up to N requests in flight (the board reports its
+window in the ping response). --text uses sequenced menu commands
+("@<seq> 2" answered by "ack <seq> ok") instead of frames.
+
+As a library:
+    client = Client(serial.Serial("/dev/ttyACM0", 115200, timeout=0.5))
+    client.set_pattern(2)
+"""
+
+import argparse
+import re
+import struct
+import sys
+import time
+
+DELIMITER = 0x00
+RESPONSE = 0x80
+MAX_PAYLOAD = 28
+
+OP_PING = 0x01
+OP_SET_PATTERN = 0x02
+OP_GET_STATUS = 0x03
+OP_GET_RX_STATS = 0x04
+
+STATUS_NAMES = ["ok", "bad cobs", "bad length", "bad crc", "unknown opcode", "bad argument"]
+PATTERN_NAMES = ["off", "on", "blink diff", "blink same"]
+MENU_NAMES = ["main", "led patterns"]
+
+
+ACK_RE = re.compile(rb"ack (\d+) (\w+)")
+
+# Session mode escapes (uart_task.h): Shift Out / Shift In
+SESSION_MACHINE = b"\x0e"
+SESSION_INTERACTIVE = b"\x0f"
+
+
+class FrameError(Exception):
+    """Request failed: timeout, corrupt response or non-zero status."""
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, same as cmd_frame_crc16()."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_pos, code = 0, 1
+    for i, byte in enumerate(data):
+        if byte:
+            out.append(byte)
+            code += 1
+        if byte == 0 or code == 0xFF:
+            out[code_pos] = code
+            code = 1
+            code_pos = len(out)
+            if byte == 0 or i + 1 < len(data):
+                out.append(0)
+    if code_pos < len(out):
+        out[code_pos] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    """Decode a COBS block; returns None if malformed."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data) or 0 in data[i:i + code - 1]:
+            return None
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def encode_frame(payload):
+    """Complete wire frame for a payload, delimiters included."""
+    if len(payload) > MAX_PAYLOAD:
+        raise ValueError("payload longer than %d bytes" % MAX_PAYLOAD)
+    raw = bytes(payload) + struct.pack("<H", crc16(payload))
+    return bytes([DELIMITER]) + cobs_encode(raw) + bytes([DELIMITER])
+
+
+def decode_frame(encoded):
+    """Payload of a frame (bytes between the delimiters), or None if corrupt."""
+    raw = cobs_decode(encoded)
+    if raw is None or len(raw) < 4:
+        return None
+    payload, (crc,) = raw[:-2], struct.unpack("<H", raw[-2:])
+    return payload if crc16(payload) == crc else None
+
+
+class FrameReader:
+    """Split a byte stream into text and frames, like the firmware receiver."""
+
+    def __init__(self):
+        self.in_frame = False
+        self.frame = bytearray()
+        self.text = bytearray()
+
+    def feed(self, data):
+        """Return the ("text", bytes) and ("frame", payload or None) items
+        completed by data."""
+        items = []
+        for byte in data:
+            if byte == DELIMITER:
+                if not self.in_frame:
+                    if self.text:
+                        items.append(("text", bytes(self.text)))
+                        self.text.clear()
+                    self.in_frame = True
+                elif self.frame:
+                    items.append(("frame", decode_frame(bytes(self.frame))))
+                    self.frame.clear()
+                    self.in_frame = False
+            elif self.in_frame:
+                self.frame.append(byte)
+            else:
+                self.text.append(byte)
+        if self.text:
+            items.append(("text", bytes(self.text)))
+            self.text.clear()
+        return items
+
+
+class Client:
+    """Request/response client over any object with read(n) and write(b)."""
+
+    def __init__(self, port, on_text=None, timeout=0.5):
+        self.port = port
+        self.reader = FrameReader()
+        self.on_text = on_text
+        self.timeout = timeout
+        self.seq = 0
+        self.corrupt = 0
+        self.pending = []   # Items read along with an earlier response
+
+    def send(self, op, args=b""):
+        """Send a request without waiting; returns its sequence number."""
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        self.port.write(encode_frame(bytes([op, seq]) + bytes(args)))
+        return seq
+
+    def receive(self):
+        """Wait for the next response; returns (op, seq, status, data)."""
+        deadline = time.monotonic() + self.timeout
+        while time.monotonic() < deadline:
+            if not self.pending:
+                chunk = self.port.read(max(1, getattr(self.port, "in_waiting", 0)))
+                self.pending = self.reader.feed(chunk)
+            while self.pending:
+                kind, value = self.pending.pop(0)
+                if kind == "text":
+                    if self.on_text:
+                        self.on_text(value)
+                elif value is None or len(value) < 3 or not value[0] & RESPONSE:
+                    self.corrupt += 1
+                else:
+                    return value[0] & ~RESPONSE, value[1], value[2], value[3:]
+        raise FrameError("no response within %.1f s" % self.timeout)
+
+    def request(self, op, args=b""):
+        """Send a request and return the response data (raises on error)."""
+        seq = self.send(op, args)
+        while True:
+            r_op, r_seq, status, data = self.receive()
+            if r_seq != seq or r_op != op:
+                continue    # Late response to an earlier request
+            if status != 0:
+                name = STATUS_NAMES[status] if status < len(STATUS_NAMES) else status
+                raise FrameError("op 0x%02x failed: %s" % (op, name))
+            return data
+
+    def ping(self):
+        return self.request(OP_PING)[0]
+
+    def window(self):
+        """Commands the board accepts in flight (1 for older firmware)."""
+        data = self.request(OP_PING)
+        return data[1] if len(data) > 1 else 1
+
+    def set_pattern(self, pattern):
+        self.request(OP_SET_PATTERN, [pattern])
+
+    def status(self):
+        pattern, menu = self.request(OP_GET_STATUS)[:2]
+        return pattern, menu
+
+    def rx_stats(self):
+        names = ("rx_bytes", "rx_dropped", "commands", "frame_errors")
+        return dict(zip(names, struct.unpack("<4I", self.request(OP_GET_RX_STATS)[:16])))
+
+
+class TextClient:
+    """Sequenced menu commands ("@<seq> <command>" -> "ack <seq> <status>")."""
+
+    def __init__(self, port, timeout=0.5, machine=False):
+        self.port = port
+        self.timeout = timeout
+        self.seq = 0
+        self.buffer = b""
+        if machine:
+            # Machine mode: no echo or menus, acks only
+            self.port.write(SESSION_MACHINE)
+
+    def send(self, command):
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFFFF
+        self.port.write(b"@%d %s\r" % (seq, command.encode("ascii")))
+        return seq
+
+    def receive(self):
+        """Wait for the next ack; returns (seq, status)."""
+        deadline = time.monotonic() + self.timeout
+        while time.monotonic() < deadline:
+            match = ACK_RE.search(self.buffer)
+            if match and self.buffer.find(b"\n", match.end()) >= 0:
+                self.buffer = self.buffer[match.end():]
+                return int(match.group(1)), match.group(2).decode("ascii")
+            self.buffer += self.port.read(max(1, getattr(self.port, "in_waiting", 0)))
+        raise FrameError("no ack within %.1f s" % self.timeout)
+
+
+def bench(client, count, window, out, text=False):
+    """Request rate with up to window commands in flight, alternating
+    LED patterns 2 and 3 (window 1 is plain request/response)."""
+    if text:
+        # Enter the LED menu once; the pattern commands then stay there
+        client.send("1")
+        client.receive()
+        issue = lambda i: client.send(str(2 + (i & 1)))
+    else:
+        issue = lambda i: client.send(OP_SET_PATTERN, [2 + (i & 1)])
+
+    failed = 0
+    in_flight = []
+    start = time.monotonic()
+    for i in range(count + window):
+        if len(in_flight) == window or i >= count:
+            if not in_flight:
+                break
+            reply = client.receive()
+            seq, ok = (reply[0], reply[1] == "ok") if text else (reply[1], reply[2] == 0)
+            if seq != in_flight.pop(0) or not ok:
+                failed += 1
+        if i < count:
+            in_flight.append(issue(i))
+    elapsed = time.monotonic() - start
+
+    out.write("%d commands, window %d, in %.2f s: %.0f commands/s\n"
+              % (count, window, elapsed, count / elapsed))
+    if failed:
+        out.write("%d commands failed or were acknowledged out of order\n" % failed)
+    if getattr(client, "corrupt", 0):
+        out.write("%d corrupt frames skipped\n" % client.corrupt)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port", help="serial port (e.g. /dev/ttyACM0)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=0.5,
+                        help="response timeout in seconds")
+    parser.add_argument("--show-text", action="store_true",
+                        help="echo text the board prints between frames")
+    sub = parser.add_subparsers(dest="command", required=True)
+    sub.add_parser("ping")
+    sub.add_parser("status")
+    sub.add_parser("rxstats")
+    p = sub.add_parser("pattern")
+    p.add_argument("id", type=int, choices=range(4), help="0 = off, 1-3 = pattern")
+    p = sub.add_parser("bench")
+    p.add_argument("--count", type=int, default=1000)
+    p.add_argument("--window", type=int, default=1,
+                   help="commands in flight (0 = the board's window)")
+    p.add_argument("--text", action="store_true",
+                   help="sequenced menu commands instead of frames")
+    p.add_argument("--machine", action="store_true",
+                   help="with --text: machine mode (no echo or menus)")
+    args = parser.parse_args()
+
+    import serial  # pyserial, only needed against real hardware
+
+    on_text = (lambda text: sys.stdout.write(text.decode("ascii", "replace"))) \
+        if args.show_text else None
+    with serial.Serial(args.port, args.baud, timeout=0.01) as port:
+        # A board waiting for auto-baud times the first character; a frame
+        # starts with NUL, which cannot be timed, so send Enter first
+        port.write(b"\r")
+        port.flush()
+        time.sleep(0.2)
+        port.reset_input_buffer()
+        client = Client(port, on_text=on_text, timeout=args.timeout)
+        if args.command == "ping":
+            print("protocol version %d" % client.ping())
+        elif args.command == "pattern":
+            client.set_pattern(args.id)
+            print("pattern %s" % PATTERN_NAMES[args.id])
+        elif args.command == "status":
+            pattern, menu = client.status()
+            print("pattern %s, menu %s" % (PATTERN_NAMES[pattern], MENU_NAMES[menu]))
+        elif args.command == "rxstats":
+            for name, value in client.rx_stats().items():
+                print("%-14s %u" % (name, value))
+        elif args.command == "bench":
+            window = args.window or client.window()
+            if args.text:
+                client = TextClient(port, timeout=args.timeout, machine=args.machine)
+            bench(client, args.count, window, sys.stdout, text=args.text)
+            if args.text and args.machine:
+                port.write(SESSION_INTERACTIVE)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,262 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_macro_sim.c
+ * @brief          : Host check and model of recorded command macros
+ ******************************************************************************
+ * @description
+ * Three parts, the first of which fails the run if anything is wrong:
+ *
+ * 1. Store: record, replay walk, replacement, deletion with compaction and
+ *    the error cases (bad name, slots or storage full, empty recording,
+ *    nested recording) on the firmware's own src/cmd_macro.c.
+ *
+ * 2. Cost: RAM taken by a typical macro in the arena against one
+ *    COMMAND_MAX_LENGTH buffer per step, and link bytes (and time at
+ *    115200 baud) to run it N times by sending every line against one
+ *    "macro run <name> repeat <n>" line.
+ *
+ * 3. Timing: a blink sequence with "delay" steps replayed for many
+ *    passes, each step taking a random 0.05 ... 2 ms to run (LED update,
+ *    queued output). Relative delays (vTaskDelay(ms) after each step) add
+ *    every step's run time to the schedule; anchored delays (each
+ *    deadline = previous deadline + ms, as command_delay() does in a
+ *    replay) only lag by the run time of the steps since the last delay.
+ *    The model uses a 1 ms tick; times are in microseconds.
+ *
+ * Build and run (from the repository root):
+ *   cc -O2 -Itools/host -Iincludes tools/cmd_macro_sim.c src/cmd_macro.c \
+ *      -o cmd_macro_sim
+ *   ./cmd_macro_sim [passes]
+ ******************************************************************************
+ */
+
+#include "host_sim.h"
+#include "cmd_macro.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_LINE_SIZE   64      /* COMMAND_MAX_LENGTH */
+#define SIM_TICK_US     1000    /* configTICK_RATE_HZ = 1000 */
+#define SIM_BAUD        115200
+
+/* The blink sequence used for the cost and timing parts */
+static const char *const blink_steps[] = {
+    "pattern 0", "duty green 100", "delay 250", "duty green 0",
+    "duty orange 100", "delay 250", "duty orange 0", "blink green 500;blink orange 500",
+};
+#define BLINK_STEPS (sizeof(blink_steps) / sizeof(blink_steps[0]))
+
+static void record(cmd_macro_store_t *store, const char *name, const char *const *steps, size_t count)
+{
+    CHECK(cmd_macro_record(store, name) == CMD_MACRO_OK);
+    for (size_t i = 0; i < count; i++) {
+        CHECK(cmd_macro_append(store, steps[i]) == CMD_MACRO_OK);
+    }
+    CHECK(cmd_macro_end(store) == CMD_MACRO_OK);
+}
+
+/* Steps of a macro must read back in order */
+static void check_steps(const cmd_macro_store_t *store, const char *name,
+                        const char *const *steps, size_t count)
+{
+    int slot = cmd_macro_find(store, name);
+    size_t i = 0;
+
+    CHECK(slot >= 0);
+    if (slot < 0) {
+        return;
+    }
+    for (const char *step = cmd_macro_next(store, slot, NULL); step != NULL;
+         step = cmd_macro_next(store, slot, step)) {
+        CHECK(i < count && strcmp(step, steps[i]) == 0);
+        i++;
+    }
+    CHECK(i == count);
+    CHECK(store->slots[slot].steps == count);
+}
+
+static void test_store(void)
+{
+    static const char *const a[] = { "1", "2" };
+    static const char *const b[] = { "pattern 3", "delay 100", "pattern 0" };
+    static const char *const c[] = { "status" };
+    static cmd_macro_store_t store;
+    char step[SIM_LINE_SIZE];
+
+    cmd_macro_init(&store);
+    CHECK(cmd_macro_recording(&store) == NULL);
+    CHECK(cmd_macro_append(&store, "1") == CMD_MACRO_ERR_IDLE);
+    CHECK(cmd_macro_end(&store) == CMD_MACRO_ERR_IDLE);
+
+    // Names
+    CHECK(cmd_macro_record(&store, "") == CMD_MACRO_ERR_NAME);
+    CHECK(cmd_macro_record(&store, "toolong12") == CMD_MACRO_ERR_NAME);
+    CHECK(cmd_macro_record(&store, "a;b") == CMD_MACRO_ERR_NAME);
+
+    // Three macros back to back, then walk them
+    record(&store, "a", a, 2);
+    record(&store, "b", b, 3);
+    record(&store, "c", c, 1);
+    check_steps(&store, "a", a, 2);
+    check_steps(&store, "b", b, 3);
+    check_steps(&store, "c", c, 1);
+    CHECK(store.used == 4 + 30 + 7);
+
+    // Deleting the middle one moves "c" down, "a" stays
+    CHECK(cmd_macro_delete(&store, "b") == CMD_MACRO_OK);
+    CHECK(cmd_macro_delete(&store, "b") == CMD_MACRO_ERR_UNKNOWN);
+    CHECK(store.used == 4 + 7);
+    check_steps(&store, "a", a, 2);
+    check_steps(&store, "c", c, 1);
+
+    // Re-recording replaces; a recording is invisible until it ends
+    CHECK(cmd_macro_record(&store, "a") == CMD_MACRO_OK);
+    CHECK(cmd_macro_find(&store, "a") < 0);
+    CHECK(strcmp(cmd_macro_recording(&store), "a") == 0);
+    CHECK(cmd_macro_record(&store, "d") == CMD_MACRO_ERR_RECORDING);
+    CHECK(cmd_macro_append(&store, "pattern 3") == CMD_MACRO_OK);
+    CHECK(cmd_macro_delete(&store, "c") == CMD_MACRO_OK);    // Moves the recording
+    CHECK(cmd_macro_append(&store, "delay 100") == CMD_MACRO_OK);
+    CHECK(cmd_macro_append(&store, "pattern 0") == CMD_MACRO_OK);
+    CHECK(cmd_macro_end(&store) == CMD_MACRO_OK);
+    check_steps(&store, "a", b, 3);
+    CHECK(store.used == 30);
+
+    // An empty recording is dropped
+    CHECK(cmd_macro_record(&store, "e") == CMD_MACRO_OK);
+    CHECK(cmd_macro_end(&store) == CMD_MACRO_ERR_EMPTY);
+    CHECK(cmd_macro_find(&store, "e") < 0);
+
+    // Slots run out
+    for (int i = 1; i < CMD_MACRO_SLOTS; i++) {
+        char name[4] = { 'm', (char)('0' + i), '\0' };
+        record(&store, name, c, 1);
+    }
+    CHECK(cmd_macro_record(&store, "x") == CMD_MACRO_ERR_SLOTS);
+    CHECK(cmd_macro_recording(&store) == NULL);
+
+    // Storage runs out: the step that does not fit is refused, the
+    // recording stays usable
+    cmd_macro_init(&store);
+    memset(step, 'x', SIM_LINE_SIZE - 1);
+    step[SIM_LINE_SIZE - 1] = '\0';
+    CHECK(cmd_macro_record(&store, "big") == CMD_MACRO_OK);
+    unsigned fitted = 0;
+    while (cmd_macro_append(&store, step) == CMD_MACRO_OK) {
+        fitted++;
+    }
+    CHECK(fitted == CMD_MACRO_STORAGE / SIM_LINE_SIZE);
+    CHECK(cmd_macro_end(&store) == CMD_MACRO_OK);
+    CHECK(cmd_macro_delete(&store, "big") == CMD_MACRO_OK);
+    CHECK(store.used == 0);
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void report_cost(unsigned repeat)
+{
+    static cmd_macro_store_t store;
+    size_t line_bytes = 0;
+
+    cmd_macro_init(&store);
+    record(&store, "blink", blink_steps, BLINK_STEPS);
+    for (size_t i = 0; i < BLINK_STEPS; i++) {
+        line_bytes += strlen(blink_steps[i]) + 1;   // CR
+    }
+
+    char run[SIM_LINE_SIZE];
+    int run_bytes = snprintf(run, sizeof(run), "macro run blink repeat %u\r", repeat);
+    double byte_us = 10.0 * 1e6 / SIM_BAUD;
+
+    printf("Storage (%zu-step blink sequence)\n", BLINK_STEPS);
+    printf("  arena          %5u bytes\n", (unsigned)store.used);
+    printf("  line buffers   %5zu bytes (%zu x %d)\n", BLINK_STEPS * SIM_LINE_SIZE,
+           BLINK_STEPS, SIM_LINE_SIZE);
+    printf("  %u such macros fit in %d bytes\n\n", CMD_MACRO_STORAGE / store.used,
+           CMD_MACRO_STORAGE);
+
+    printf("Link, %u passes @ %d baud (commands only, no responses)\n", repeat, SIM_BAUD);
+    printf("  line by line   %8zu bytes %9.1f ms\n", line_bytes * repeat,
+           line_bytes * repeat * byte_us / 1000.0);
+    printf("  macro run      %8d bytes %9.1f ms\n\n", run_bytes, run_bytes * byte_us / 1000.0);
+}
+
+/* ------------------------------------------------------------------------- */
+
+static unsigned long rng_state = 12345;
+
+static unsigned long rng(void)
+{
+    rng_state = rng_state * 1103515245ul + 12345ul;
+    return (rng_state >> 16) & 0x7FFF;
+}
+
+/* Delay in ms of a step, 0 for other commands */
+static unsigned step_delay_ms(const char *step)
+{
+    return (strncmp(step, "delay ", 6) == 0) ? (unsigned)atoi(&step[6]) : 0;
+}
+
+/*
+ * Replay the blink sequence; returns the largest and the final lag of a
+ * step start behind its ideal time (sum of the delays before it)
+ */
+static void simulate(unsigned passes, int anchored, double *max_lag_ms, double *end_lag_ms)
+{
+    unsigned long now = 0;          // us
+    unsigned long ideal = 0;        // us
+    unsigned long deadline = 0;     // ticks
+    double max_lag = 0.0, lag = 0.0;
+
+    rng_state = 12345;              // Same step times for both modes
+    for (unsigned pass = 0; pass < passes; pass++) {
+        for (size_t i = 0; i < BLINK_STEPS; i++) {
+            lag = (double)(now - ideal) / 1000.0;
+            if (lag > max_lag) {
+                max_lag = lag;
+            }
+
+            unsigned ms = step_delay_ms(blink_steps[i]);
+            if (ms == 0) {
+                now += 50 + rng() * 1950 / 0x7FFF;      // Run the command
+                continue;
+            }
+
+            ideal += ms * 1000ul;
+            if (anchored) {
+                deadline += ms;                         // Tick the step is due
+                if (deadline * SIM_TICK_US > now) {
+                    now = deadline * SIM_TICK_US;
+                }
+            } else {
+                // vTaskDelay(ms) wakes ms tick interrupts later
+                now = (now / SIM_TICK_US + ms) * SIM_TICK_US;
+            }
+        }
+    }
+    *max_lag_ms = max_lag;
+    *end_lag_ms = lag;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned passes = (argc > 1) ? (unsigned)atoi(argv[1]) : 1000;
+    double rel_max, rel_end, anc_max, anc_end;
+
+    if (passes == 0) {
+        return 1;
+    }
+
+    test_store();
+    printf("Store checks: %s\n\n", failures ? "FAILED" : "ok");
+
+    report_cost(passes);
+
+    simulate(passes, 0, &rel_max, &rel_end);
+    simulate(passes, 1, &anc_max, &anc_end);
+    printf("Step start lag over %u passes (%.0f s of delays)\n", passes, passes * 0.5);
+    printf("  relative delays  max %8.1f ms  last %8.1f ms\n", rel_max, rel_end);
+    printf("  anchored delays  max %8.1f ms  last %8.1f ms\n", anc_max, anc_end);
+    return failures != 0;
+}
@@ -0,0 +1,81 @@
+/**
+ ******************************************************************************
+ * @file           : FreeRTOS.h
+ * @brief          : Host stand-in for the FreeRTOS kernel headers
+ ******************************************************************************
+ * @description
+ * Lets the simulations in tools/ build the firmware's own print path
+ * (print_task.c, print_port.c, watchdog.c) unchanged. Only the kernel
+ * services those files use are provided, see freertos_host.c.
+ *
+ * Model:
+ * - A task is a POSIX thread. Priorities are ignored and tasks really run
+ *   in parallel, which is harsher than one core: any code that is only
+ *   safe because it is never preempted fails here first. Tasks start
+ *   running at vTaskStartScheduler(), which returns on the host.
+ * - taskENTER_CRITICAL() takes one global lock. Simulated interrupts at or
+ *   below configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY take it too (they
+ *   are masked by BASEPRI on target); higher ones do not.
+ * - One tick is HOST_TICK_US microseconds of real time (default 1000, a
+ *   smaller value runs watchdog timeouts faster).
+ *
+ * The configuration comes from includes/FreeRTOSConfig.h, so priorities
+ * and the tick rate match the target. Put tools/host ahead of includes/
+ * on the include path.
+ ******************************************************************************
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#include "FreeRTOSConfig.h"
+
+#ifndef HOST_TICK_US
+#define HOST_TICK_US 1000
+#endif
+
+#define pdFALSE         ((BaseType_t)0)
+#define pdTRUE          ((BaseType_t)1)
+#define pdFAIL          pdFALSE
+#define pdPASS          pdTRUE
+#define portMAX_DELAY   ((TickType_t)0xFFFFFFFFUL)
+
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((TickType_t)(ms) * configTICK_RATE_HZ) / (TickType_t)1000U))
+#define pdTICKS_TO_MS(t)    ((TickType_t)(((TickType_t)(t) * (TickType_t)1000U) / configTICK_RATE_HZ))
+
+/* Kernel objects (opaque, see freertos_host.c) */
+typedef struct host_task *TaskHandle_t;
+typedef struct host_semaphore *SemaphoreHandle_t;
+typedef struct host_message_buffer *MessageBufferHandle_t;
+
+void host_assert_failed(const char *expression, const char *file, int line);
+void host_critical_enter(void);
+void host_critical_exit(void);
+BaseType_t host_interrupt_priority_valid(void);
+
+/* Target configASSERT() spins with interrupts off; on host, fail loudly */
+#undef configASSERT
+#define configASSERT(x) \
+    do { \
+        if ((x) == 0) { \
+            host_assert_failed(#x, __FILE__, __LINE__); \
+        } \
+    } while (0)
+
+/* vPortValidateInterruptPriority() on target */
+#define portASSERT_IF_INTERRUPT_PRIORITY_INVALID() configASSERT(host_interrupt_priority_valid())
+
+#define taskENTER_CRITICAL()            host_critical_enter()
+#define taskEXIT_CRITICAL()             host_critical_exit()
+#define taskENTER_CRITICAL_FROM_ISR()   (host_critical_enter(), (UBaseType_t)0)
+#define taskEXIT_CRITICAL_FROM_ISR(x)   ((void)(x), host_critical_exit())
+#define portYIELD_FROM_ISR(x)           ((void)(x))
+
+#endif /* HOST_FREERTOS_H */
@@ -0,0 +1,528 @@
+/**
+ ******************************************************************************
+ * @file           : freertos_host.c
+ * @brief          : Host model of the FreeRTOS services used by the print path
+ ******************************************************************************
+ * @description
+ * Tasks are detached POSIX threads, semaphores and message buffers are a
+ * mutex + condition variable each, the critical section is one global
+ * recursive mutex and the tick count is real time divided by
+ * HOST_TICK_US. See FreeRTOS.h for what this model does and does not
+ * reproduce.
+ *
+ * Every kernel call made by a task is a checkpoint where a frozen task
+ * stops, which is how a simulation plays a task that never gets the CPU.
+ ******************************************************************************
+ */
+
+#define _GNU_SOURCE
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "message_buffer.h"
+#include "host_sim.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+struct host_task {
+    pthread_t thread;
+    TaskFunction_t code;
+    void *parameters;
+    const char *name;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    uint32_t notification;
+    BaseType_t frozen;          // See host_task_freeze()
+};
+
+struct host_semaphore {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    uint32_t count;
+};
+
+struct host_message_buffer {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    uint8_t *data;
+    size_t size;
+    size_t head;                // Next byte to read
+    size_t used;                // Bytes stored (headers included)
+};
+
+/* Task running on this thread (NULL for the simulation's main thread) */
+static __thread struct host_task *current_task = NULL;
+
+/* Priority of the simulated interrupt running on this thread, -1 = task */
+static __thread int current_interrupt = -1;
+
+/* Critical sections this thread is in */
+static __thread int critical_nesting = 0;
+
+static pthread_mutex_t critical_lock;
+static pthread_once_t host_once = PTHREAD_ONCE_INIT;
+static struct timespec host_start;
+
+static void host_setup(void)
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&critical_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    clock_gettime(CLOCK_MONOTONIC, &host_start);
+}
+
+static void host_init_sync(pthread_mutex_t *lock, pthread_cond_t *changed)
+{
+    pthread_condattr_t attr;
+
+    pthread_once(&host_once, host_setup);
+    pthread_mutex_init(lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(changed, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static uint64_t host_now_us(void)
+{
+    struct timespec now;
+
+    pthread_once(&host_once, host_setup);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - host_start.tv_sec) * 1000000u +
+           (uint64_t)(now.tv_nsec / 1000) - (uint64_t)(host_start.tv_nsec / 1000);
+}
+
+static struct timespec host_deadline(TickType_t ticks)
+{
+    struct timespec when;
+    uint64_t ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &when);
+    ns = (uint64_t)when.tv_nsec + (uint64_t)ticks * HOST_TICK_US * 1000u;
+    when.tv_sec += (time_t)(ns / 1000000000u);
+    when.tv_nsec = (long)(ns % 1000000000u);
+    return when;
+}
+
+/* Wait on a condition; pdFALSE once the deadline has passed */
+static BaseType_t host_wait(pthread_cond_t *changed, pthread_mutex_t *lock, TickType_t ticks,
+                            const struct timespec *deadline)
+{
+    if (ticks == portMAX_DELAY) {
+        pthread_cond_wait(changed, lock);
+        return pdTRUE;
+    }
+    return (pthread_cond_timedwait(changed, lock, deadline) == ETIMEDOUT) ? pdFALSE : pdTRUE;
+}
+
+static void host_sleep_us(uint64_t us)
+{
+    struct timespec delay = { (time_t)(us / 1000000u), (long)(us % 1000000u) * 1000 };
+
+    while (nanosleep(&delay, &delay) != 0 && errno == EINTR) {
+    }
+}
+
+/*
+ * A frozen task stops at its next kernel call, and does not come back out
+ * of one it is blocked in, until it is thawed (see host_task_freeze()).
+ * Never inside a critical section: nothing preempts a task there on target.
+ */
+static void host_checkpoint(void)
+{
+    struct host_task *task = current_task;
+
+    if (task == NULL || current_interrupt >= 0 || critical_nesting > 0) {
+        return;
+    }
+    pthread_mutex_lock(&task->lock);
+    while (task->frozen) {
+        pthread_cond_wait(&task->changed, &task->lock);
+    }
+    pthread_mutex_unlock(&task->lock);
+}
+
+void host_task_freeze(TaskHandle_t task, BaseType_t freeze)
+{
+    pthread_mutex_lock(&task->lock);
+    task->frozen = freeze;
+    pthread_cond_broadcast(&task->changed);
+    pthread_mutex_unlock(&task->lock);
+}
+
+/*============================================================================
+ * Asserts, critical sections, interrupts
+ *===========================================================================*/
+
+void host_assert_failed(const char *expression, const char *file, int line)
+{
+    fprintf(stderr, "configASSERT(%s) failed at %s:%d\n", expression, file, line);
+    abort();
+}
+
+void host_critical_enter(void)
+{
+    pthread_once(&host_once, host_setup);
+    host_checkpoint();
+    pthread_mutex_lock(&critical_lock);
+    critical_nesting++;
+}
+
+void host_critical_exit(void)
+{
+    critical_nesting--;
+    pthread_mutex_unlock(&critical_lock);
+}
+
+void host_interrupt_enter(int priority)
+{
+    current_interrupt = priority;
+    if (priority >= configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY) {
+        host_critical_enter();
+    }
+}
+
+void host_interrupt_exit(void)
+{
+    if (current_interrupt >= configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY) {
+        host_critical_exit();
+    }
+    current_interrupt = -1;
+}
+
+BaseType_t host_interrupt_priority_valid(void)
+{
+    // Task context passes, as on target
+    return (current_interrupt < 0 ||
+            current_interrupt >= configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY) ? pdTRUE : pdFALSE;
+}
+
+/*============================================================================
+ * Tasks and notifications
+ *===========================================================================*/
+
+/* Tasks created before vTaskStartScheduler() wait for it, as on target */
+static pthread_mutex_t scheduler_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t scheduler_started_cond = PTHREAD_COND_INITIALIZER;
+static BaseType_t scheduler_started = pdFALSE;
+
+static void *host_task_entry(void *argument)
+{
+    struct host_task *task = argument;
+
+    pthread_mutex_lock(&scheduler_lock);
+    while (!scheduler_started) {
+        pthread_cond_wait(&scheduler_started_cond, &scheduler_lock);
+    }
+    pthread_mutex_unlock(&scheduler_lock);
+
+    current_task = task;
+    task->code(task->parameters);
+    return NULL;
+}
+
+void vTaskStartScheduler(void)
+{
+    pthread_mutex_lock(&scheduler_lock);
+    scheduler_started = pdTRUE;
+    pthread_cond_broadcast(&scheduler_started_cond);
+    pthread_mutex_unlock(&scheduler_lock);
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name, uint16_t stack_depth,
+                       void *parameters, UBaseType_t priority, TaskHandle_t *created)
+{
+    struct host_task *task = calloc(1, sizeof(*task));
+    pthread_attr_t attr;
+
+    (void)stack_depth;
+    (void)priority;
+    if (task == NULL) {
+        return pdFAIL;
+    }
+    task->code = code;
+    task->parameters = parameters;
+    task->name = name;
+    host_init_sync(&task->lock, &task->changed);
+
+    // The handle is valid before the task runs, as when the scheduler starts
+    if (created != NULL) {
+        *created = task;
+    }
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&task->thread, &attr, host_task_entry, task) != 0) {
+        pthread_attr_destroy(&attr);
+        return pdFAIL;
+    }
+    pthread_attr_destroy(&attr);
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return current_task;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(host_now_us() / HOST_TICK_US);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    host_checkpoint();
+    host_sleep_us((uint64_t)ticks * HOST_TICK_US);
+    host_checkpoint();
+}
+
+void vTaskDelayUntil(TickType_t *previous_wake, TickType_t increment)
+{
+    uint64_t wake_us;
+    uint64_t now_us = host_now_us();
+
+    host_checkpoint();
+    *previous_wake += increment;
+    wake_us = (uint64_t)*previous_wake * HOST_TICK_US;
+    if (wake_us > now_us) {
+        host_sleep_us(wake_us - now_us);
+    }
+    host_checkpoint();
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+    task->notification++;
+    pthread_cond_signal(&task->changed);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken)
+{
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+    xTaskNotifyGive(task);
+    if (higher_priority_task_woken != NULL) {
+        *higher_priority_task_woken = pdTRUE;
+    }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    struct host_task *task = current_task;
+    struct timespec deadline = host_deadline(ticks_to_wait);
+    uint32_t value;
+
+    configASSERT(task != NULL);
+    host_checkpoint();
+    pthread_mutex_lock(&task->lock);
+    while (task->notification == 0 && ticks_to_wait != 0) {
+        if (!host_wait(&task->changed, &task->lock, ticks_to_wait, &deadline)) {
+            break;
+        }
+    }
+    value = task->notification;
+    if (value != 0) {
+        task->notification = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&task->lock);
+    host_checkpoint();
+    return value;
+}
+
+/*============================================================================
+ * Semaphores
+ *===========================================================================*/
+
+static SemaphoreHandle_t host_semaphore_create(uint32_t initial)
+{
+    struct host_semaphore *semaphore = calloc(1, sizeof(*semaphore));
+
+    if (semaphore != NULL) {
+        host_init_sync(&semaphore->lock, &semaphore->changed);
+        semaphore->count = initial;
+    }
+    return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return host_semaphore_create(0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return host_semaphore_create(1);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    struct timespec deadline = host_deadline(ticks_to_wait);
+    BaseType_t taken = pdFAIL;
+
+    host_checkpoint();
+    pthread_mutex_lock(&semaphore->lock);
+    while (semaphore->count == 0 && ticks_to_wait != 0) {
+        if (!host_wait(&semaphore->changed, &semaphore->lock, ticks_to_wait, &deadline)) {
+            break;
+        }
+    }
+    if (semaphore->count != 0) {
+        semaphore->count--;
+        taken = pdPASS;
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    host_checkpoint();
+    return taken;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    BaseType_t given = pdFAIL;
+
+    pthread_mutex_lock(&semaphore->lock);
+    if (semaphore->count == 0) {
+        semaphore->count = 1;
+        given = pdPASS;
+        pthread_cond_signal(&semaphore->changed);
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    return given;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t *higher_priority_task_woken)
+{
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+    if (higher_priority_task_woken != NULL) {
+        *higher_priority_task_woken = pdTRUE;
+    }
+    return xSemaphoreGive(semaphore);
+}
+
+/*============================================================================
+ * Message buffers
+ *===========================================================================*/
+
+static void host_ring_copy_in(struct host_message_buffer *buffer, const void *data, size_t length)
+{
+    const uint8_t *bytes = data;
+    size_t at = (buffer->head + buffer->used) % buffer->size;
+
+    for (size_t i = 0; i < length; i++) {
+        buffer->data[(at + i) % buffer->size] = bytes[i];
+    }
+    buffer->used += length;
+}
+
+static void host_ring_peek(const struct host_message_buffer *buffer, size_t offset, void *data,
+                           size_t length)
+{
+    uint8_t *bytes = data;
+
+    for (size_t i = 0; i < length; i++) {
+        bytes[i] = buffer->data[(buffer->head + offset + i) % buffer->size];
+    }
+}
+
+MessageBufferHandle_t xMessageBufferCreate(size_t size)
+{
+    struct host_message_buffer *buffer = calloc(1, sizeof(*buffer));
+
+    if (buffer == NULL) {
+        return NULL;
+    }
+    buffer->data = malloc(size);
+    if (buffer->data == NULL) {
+        free(buffer);
+        return NULL;
+    }
+    buffer->size = size;
+    host_init_sync(&buffer->lock, &buffer->changed);
+    return buffer;
+}
+
+size_t xMessageBufferSend(MessageBufferHandle_t buffer, const void *data, size_t length,
+                          TickType_t ticks_to_wait)
+{
+    struct timespec deadline = host_deadline(ticks_to_wait);
+    size_t needed = length + sizeof(size_t);
+    size_t sent = 0;
+
+    if (needed > buffer->size) {
+        return 0;
+    }
+
+    host_checkpoint();
+    pthread_mutex_lock(&buffer->lock);
+    while (buffer->size - buffer->used < needed && ticks_to_wait != 0) {
+        if (!host_wait(&buffer->changed, &buffer->lock, ticks_to_wait, &deadline)) {
+            break;
+        }
+    }
+    if (buffer->size - buffer->used >= needed) {
+        host_ring_copy_in(buffer, &length, sizeof(length));
+        host_ring_copy_in(buffer, data, length);
+        sent = length;
+        pthread_cond_broadcast(&buffer->changed);
+    }
+    pthread_mutex_unlock(&buffer->lock);
+    return sent;
+}
+
+size_t xMessageBufferReceive(MessageBufferHandle_t buffer, void *data, size_t space,
+                             TickType_t ticks_to_wait)
+{
+    struct timespec deadline = host_deadline(ticks_to_wait);
+    size_t length = 0;
+
+    host_checkpoint();
+    pthread_mutex_lock(&buffer->lock);
+    while (buffer->used == 0 && ticks_to_wait != 0) {
+        if (!host_wait(&buffer->changed, &buffer->lock, ticks_to_wait, &deadline)) {
+            break;
+        }
+    }
+    if (buffer->used != 0) {
+        host_ring_peek(buffer, 0, &length, sizeof(length));
+        if (length > space) {
+            length = 0;     // Too large for the caller: stays in the buffer
+        } else {
+            host_ring_peek(buffer, sizeof(length), data, length);
+            buffer->head = (buffer->head + sizeof(length) + length) % buffer->size;
+            buffer->used -= sizeof(length) + length;
+            pthread_cond_broadcast(&buffer->changed);
+        }
+    }
+    pthread_mutex_unlock(&buffer->lock);
+    return length;
+}
+
+size_t xMessageBufferSpacesAvailable(MessageBufferHandle_t buffer)
+{
+    size_t space;
+
+    pthread_mutex_lock(&buffer->lock);
+    space = buffer->size - buffer->used;
+    pthread_mutex_unlock(&buffer->lock);
+    return space;
+}
+
+BaseType_t xMessageBufferIsEmpty(MessageBufferHandle_t buffer)
+{
+    BaseType_t empty;
+
+    pthread_mutex_lock(&buffer->lock);
+    empty = (buffer->used == 0) ? pdTRUE : pdFALSE;
+    pthread_mutex_unlock(&buffer->lock);
+    return empty;
+}
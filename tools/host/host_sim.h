@@ -0,0 +1,142 @@
+/**
+ ******************************************************************************
+ * @file           : host_sim.h
+ * @brief          : Controls of the host kernel and UART models
+ ******************************************************************************
+ * @description
+ * Used by the simulations in tools/ to play the interrupts and the wire
+ * around the firmware's own print path:
+ *
+ *   cc -O2 -pthread -Itools/host -Iincludes tools/<sim>.c \
+ *      tools/host/freertos_host.c tools/host/uart_host.c \
+ *      tools/host/watchdog_host.c src/print_task.c src/print_port.c ...
+ *
+ * tools/host must come first on the include path so that its FreeRTOS.h,
+ * task.h, ... and stm32f4xx_hal.h replace the target ones. Link
+ * src/watchdog.c instead of watchdog_host.c to run the real watchdog.
+ *
+ * CHECK() is shared by every simulation in tools/, including the ones
+ * that need none of the kernel model.
+ ******************************************************************************
+ */
+
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include "FreeRTOS.h"
+#include <stdio.h>
+
+/*============================================================================
+ * Checks
+ *===========================================================================*/
+
+/** Failed CHECK()s so far; a simulation exits non-zero if any */
+static int failures = 0;
+
+static inline void host_check_failed(int line, const char *condition)
+{
+    fprintf(stderr, "FAIL line %d: %s\n", line, condition);
+    failures++;
+}
+
+/**
+ * @brief  Count and report a failed condition, then carry on
+ */
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            host_check_failed(__LINE__, #condition); \
+        } \
+    } while (0)
+
+/*============================================================================
+ * Interrupts (freertos_host.c)
+ *===========================================================================*/
+
+/**
+ * @brief  Enter simulated interrupt context on the calling thread
+ * @param  priority: NVIC priority (0 = most urgent)
+ *
+ * An interrupt at or below configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+ * waits for any critical section in progress, as BASEPRI masking does on
+ * target. portASSERT_IF_INTERRUPT_PRIORITY_INVALID() fails inside a
+ * more urgent one.
+ */
+void host_interrupt_enter(int priority);
+
+/**
+ * @brief  Leave simulated interrupt context
+ */
+void host_interrupt_exit(void);
+
+/**
+ * @brief  Freeze or thaw a task, as if starved of the CPU
+ * @param  task: Task to freeze
+ * @param  freeze: pdTRUE to freeze, pdFALSE to let it run again
+ *
+ * The task stops at its next kernel call. A task blocked in a kernel call
+ * stays in it, even after its timeout, until thawed.
+ */
+void host_task_freeze(TaskHandle_t task, BaseType_t freeze);
+
+/*============================================================================
+ * USART2 transmitter (uart_host.c)
+ *===========================================================================*/
+
+/** Transmitter counters */
+typedef struct {
+    uint32_t dma_started;       /**< HAL_UART_Transmit_DMA() calls accepted */
+    uint32_t dma_refused;       /**< ... refused (HAL_BUSY) */
+    uint32_t dma_aborted;       /**< Transfers cut short by HAL_UART_AbortTransmit() */
+    uint32_t bytes_aborted;     /**< Bytes of those transfers that never left */
+    uint32_t tc_interrupts;     /**< Transfer-complete interrupts raised */
+    uint32_t tc_lost;           /**< Transfer-complete interrupts swallowed */
+    uint32_t polled_bytes;      /**< Bytes sent by HAL_UART_Transmit() */
+} host_uart_stats_t;
+
+/**
+ * @brief  Start the transmitter model
+ * @param  char_time_us: Time on the wire per byte (87 = 115200 baud)
+ * @param  capacity: Bytes of wire capture to keep
+ *
+ * A DMA transfer moves one byte per character time onto the wire, then
+ * raises the TC interrupt (priority 6, as USART2 on target), which calls
+ * HAL_UART_TxCpltCallback().
+ */
+void host_uart_init(uint32_t char_time_us, size_t capacity);
+
+/**
+ * @brief  Refuse the next DMA starts
+ * @param  starts: Number of HAL_UART_Transmit_DMA() calls to answer HAL_BUSY
+ *         (replaces any refusals not used yet, 0 cancels them)
+ */
+void host_uart_refuse(uint32_t starts);
+
+/**
+ * @brief  Swallow the next transfer-complete interrupts
+ * @param  interrupts: Number of transfers that finish without a TC interrupt
+ */
+void host_uart_lose_tc(uint32_t interrupts);
+
+/**
+ * @brief  Stall the DMA transfer in flight
+ * @param  hold: pdTRUE stops the DMA before its next byte, pdFALSE resumes
+ *
+ * The transfer stays in flight (no TC interrupt) until resumed or
+ * aborted. Polled HAL_UART_Transmit() is not held.
+ */
+void host_uart_hold(BaseType_t hold);
+
+/**
+ * @brief  Bytes that reached the wire so far
+ * @param  data: [OUT] Start of the capture (stable, only ever appended to)
+ * @retval Number of bytes
+ */
+size_t host_uart_wire(const uint8_t **data);
+
+/**
+ * @brief  Snapshot of the transmitter counters
+ */
+void host_uart_get_stats(host_uart_stats_t *stats);
+
+#endif /* HOST_SIM_H */
@@ -0,0 +1,27 @@
+/**
+ ******************************************************************************
+ * @file           : message_buffer.h
+ * @brief          : Host stand-in for FreeRTOS message buffers (see FreeRTOS.h)
+ ******************************************************************************
+ * @description
+ * Same contract as the kernel's: each message is stored as a size_t
+ * length followed by its bytes, a receive into too small a buffer returns
+ * 0 and leaves the message in place, and a send that cannot fit whole
+ * within the timeout stores nothing.
+ ******************************************************************************
+ */
+
+#ifndef HOST_MESSAGE_BUFFER_H
+#define HOST_MESSAGE_BUFFER_H
+
+#include "FreeRTOS.h"
+
+MessageBufferHandle_t xMessageBufferCreate(size_t size);
+size_t xMessageBufferSend(MessageBufferHandle_t buffer, const void *data, size_t length,
+                          TickType_t ticks_to_wait);
+size_t xMessageBufferReceive(MessageBufferHandle_t buffer, void *data, size_t space,
+                             TickType_t ticks_to_wait);
+size_t xMessageBufferSpacesAvailable(MessageBufferHandle_t buffer);
+BaseType_t xMessageBufferIsEmpty(MessageBufferHandle_t buffer);
+
+#endif /* HOST_MESSAGE_BUFFER_H */
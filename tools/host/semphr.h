@@ -0,0 +1,23 @@
+/**
+ ******************************************************************************
+ * @file           : semphr.h
+ * @brief          : Host stand-in for FreeRTOS semaphores (see FreeRTOS.h)
+ ******************************************************************************
+ * @description
+ * Mutexes are binary semaphores that start given: no owner tracking and
+ * no priority inheritance, since host threads have no priorities.
+ ******************************************************************************
+ */
+
+#ifndef HOST_SEMPHR_H
+#define HOST_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t *higher_priority_task_woken);
+
+#endif /* HOST_SEMPHR_H */
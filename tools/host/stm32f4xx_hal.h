@@ -0,0 +1,55 @@
+/**
+ ******************************************************************************
+ * @file           : stm32f4xx_hal.h
+ * @brief          : Host stand-in for the HAL UART transmit API
+ ******************************************************************************
+ * @description
+ * Just what src/print_port.c needs, implemented by uart_host.c: DMA
+ * transmit with a transfer-complete callback, abort and polled transmit.
+ * The USART registers are plain memory; print_port_send_priority()
+ * compiles but its register writes reach no simulated wire.
+ ******************************************************************************
+ */
+
+#ifndef HOST_STM32F4XX_HAL_H
+#define HOST_STM32F4XX_HAL_H
+
+#include <stdint.h>
+
+typedef enum {
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct {
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+    volatile uint32_t CR3;
+} USART_TypeDef;
+
+typedef struct {
+    USART_TypeDef *Instance;
+} UART_HandleTypeDef;
+
+#define USART_CR3_DMAT  (1U << 7)
+#define UART_FLAG_TXE   (1U << 7)
+
+#define READ_BIT(reg, bit)      ((reg) & (bit))
+#define SET_BIT(reg, bit)       ((reg) |= (bit))
+#define CLEAR_BIT(reg, bit)     ((reg) &= ~(bit))
+
+#define __HAL_UART_GET_FLAG(handle, flag)   ((((handle)->Instance->SR) & (flag)) == (flag))
+
+#define __DMB() __sync_synchronize()
+#define __DSB() __sync_synchronize()
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t size,
+                                    uint32_t timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *data,
+                                        uint16_t size);
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef *huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+
+#endif /* HOST_STM32F4XX_HAL_H */
@@ -0,0 +1,31 @@
+/**
+ ******************************************************************************
+ * @file           : task.h
+ * @brief          : Host stand-in for the FreeRTOS task API (see FreeRTOS.h)
+ ******************************************************************************
+ */
+
+#ifndef HOST_TASK_H
+#define HOST_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *parameters);
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name, uint16_t stack_depth,
+                       void *parameters, UBaseType_t priority, TaskHandle_t *created);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+/* Starts the tasks created so far and returns: the simulation's main
+ * thread carries on as an observer outside any task */
+void vTaskStartScheduler(void);
+
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t *previous_wake, TickType_t increment);
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait);
+
+#endif /* HOST_TASK_H */
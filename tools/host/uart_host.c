@@ -0,0 +1,253 @@
+/**
+ ******************************************************************************
+ * @file           : uart_host.c
+ * @brief          : Host model of USART2 TX with DMA and the TC interrupt
+ ******************************************************************************
+ * @description
+ * Stands in for the HAL under src/print_port.c. One thread plays DMA1
+ * Stream6 and the shift register: it moves a byte of the current transfer
+ * onto the captured wire every character time and, after the last one,
+ * raises the USART2 TC interrupt, which ends in HAL_UART_TxCpltCallback()
+ * exactly as HAL_UART_IRQHandler() does on target.
+ *
+ * HAL_UART_Transmit() (polled) writes straight to the wire from the
+ * calling thread. Like the real data register it does not care whether a
+ * DMA transfer is still running, so a caller that forgets to abort one
+ * gets the two byte streams interleaved on the wire. While it runs, a DMA
+ * start is refused with HAL_BUSY, as the HAL's TX state is busy.
+ ******************************************************************************
+ */
+
+#define _GNU_SOURCE
+#include "host_sim.h"
+#include "stm32f4xx_hal.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+/* USART2 IRQ priority (stm32f4xx_hal_msp.c) */
+#define HOST_UART_IRQ_PRIORITY 6
+
+static USART_TypeDef host_usart2;
+UART_HandleTypeDef huart2 = { &host_usart2 };
+
+static pthread_mutex_t uart_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t uart_changed;
+
+/* Transfer in flight */
+static const uint8_t *dma_data;
+static uint16_t dma_length;
+static uint16_t dma_sent;
+static BaseType_t dma_active = pdFALSE;
+static BaseType_t held = pdFALSE;
+static BaseType_t polled_active = pdFALSE;  // HAL_UART_Transmit() running (gState busy)
+static struct timespec next_byte_due;
+
+/* Fault injection */
+static uint32_t refuse_starts = 0;
+static uint32_t lose_tc = 0;
+
+static uint32_t char_time_ns;
+static uint8_t *wire;
+static size_t wire_length;
+static size_t wire_capacity;
+static host_uart_stats_t stats;
+
+static void wire_put(uint8_t byte)
+{
+    if (wire_length < wire_capacity) {
+        wire[wire_length++] = byte;
+    }
+}
+
+/* Next byte leaves one character time from now */
+static void schedule_from_now(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &next_byte_due);
+    next_byte_due.tv_nsec += char_time_ns;
+    if (next_byte_due.tv_nsec >= 1000000000L) {
+        next_byte_due.tv_sec++;
+        next_byte_due.tv_nsec -= 1000000000L;
+    }
+}
+
+static void *dma_thread(void *argument)
+{
+    (void)argument;
+
+    pthread_mutex_lock(&uart_lock);
+    for (;;) {
+        while (!dma_active || held) {
+            pthread_cond_wait(&uart_changed, &uart_lock);
+        }
+
+        struct timespec due = next_byte_due;
+        pthread_mutex_unlock(&uart_lock);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) == EINTR) {
+        }
+        pthread_mutex_lock(&uart_lock);
+
+        if (!dma_active || held) {
+            continue;   // Aborted or held while the byte was on its way
+        }
+
+        wire_put(dma_data[dma_sent++]);
+        next_byte_due.tv_nsec += char_time_ns;
+        if (next_byte_due.tv_nsec >= 1000000000L) {
+            next_byte_due.tv_sec++;
+            next_byte_due.tv_nsec -= 1000000000L;
+        }
+        if (dma_sent < dma_length) {
+            continue;
+        }
+
+        // Last stop bit out: the HAL marks TX ready, then calls back
+        dma_active = pdFALSE;
+        if (lose_tc > 0) {
+            lose_tc--;
+            stats.tc_lost++;
+            continue;
+        }
+        stats.tc_interrupts++;
+        pthread_mutex_unlock(&uart_lock);
+
+        host_interrupt_enter(HOST_UART_IRQ_PRIORITY);
+        HAL_UART_TxCpltCallback(&huart2);
+        host_interrupt_exit();
+
+        pthread_mutex_lock(&uart_lock);
+    }
+    return NULL;
+}
+
+void host_uart_init(uint32_t char_time_us, size_t capacity)
+{
+    pthread_condattr_t attr;
+    pthread_t thread;
+
+    char_time_ns = char_time_us * 1000u;
+    wire = malloc(capacity);
+    wire_capacity = (wire != NULL) ? capacity : 0;
+    host_usart2.SR = UART_FLAG_TXE;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&uart_changed, &attr);
+    pthread_condattr_destroy(&attr);
+
+    pthread_create(&thread, NULL, dma_thread, NULL);
+    pthread_detach(thread);
+}
+
+void host_uart_refuse(uint32_t starts)
+{
+    pthread_mutex_lock(&uart_lock);
+    refuse_starts = starts;
+    pthread_mutex_unlock(&uart_lock);
+}
+
+void host_uart_lose_tc(uint32_t interrupts)
+{
+    pthread_mutex_lock(&uart_lock);
+    lose_tc += interrupts;
+    pthread_mutex_unlock(&uart_lock);
+}
+
+void host_uart_hold(BaseType_t hold)
+{
+    pthread_mutex_lock(&uart_lock);
+    if (held && !hold) {
+        schedule_from_now();
+    }
+    held = hold;
+    pthread_cond_broadcast(&uart_changed);
+    pthread_mutex_unlock(&uart_lock);
+}
+
+size_t host_uart_wire(const uint8_t **data)
+{
+    size_t length;
+
+    pthread_mutex_lock(&uart_lock);
+    *data = wire;
+    length = wire_length;
+    pthread_mutex_unlock(&uart_lock);
+    return length;
+}
+
+void host_uart_get_stats(host_uart_stats_t *snapshot)
+{
+    pthread_mutex_lock(&uart_lock);
+    *snapshot = stats;
+    pthread_mutex_unlock(&uart_lock);
+}
+
+/*============================================================================
+ * HAL UART transmit API
+ *===========================================================================*/
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *data,
+                                        uint16_t size)
+{
+    HAL_StatusTypeDef status = HAL_OK;
+
+    (void)huart;
+    pthread_mutex_lock(&uart_lock);
+    if (refuse_starts > 0 || dma_active || polled_active || size == 0) {
+        if (refuse_starts > 0) {
+            refuse_starts--;
+        }
+        stats.dma_refused++;
+        status = HAL_BUSY;
+    } else {
+        dma_data = data;
+        dma_length = size;
+        dma_sent = 0;
+        dma_active = pdTRUE;
+        stats.dma_started++;
+        schedule_from_now();
+        pthread_cond_broadcast(&uart_changed);
+    }
+    pthread_mutex_unlock(&uart_lock);
+    return status;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+    pthread_mutex_lock(&uart_lock);
+    if (dma_active) {
+        dma_active = pdFALSE;
+        stats.dma_aborted++;
+        stats.bytes_aborted += (uint32_t)(dma_length - dma_sent);
+    }
+    pthread_mutex_unlock(&uart_lock);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t size,
+                                    uint32_t timeout)
+{
+    struct timespec delay = { 0, (long)char_time_ns };
+
+    (void)huart;
+    (void)timeout;
+    pthread_mutex_lock(&uart_lock);
+    polled_active = pdTRUE;
+    pthread_mutex_unlock(&uart_lock);
+
+    for (uint16_t i = 0; i < size; i++) {
+        pthread_mutex_lock(&uart_lock);
+        wire_put(data[i]);
+        stats.polled_bytes++;
+        pthread_mutex_unlock(&uart_lock);
+        nanosleep(&delay, NULL);
+    }
+
+    pthread_mutex_lock(&uart_lock);
+    polled_active = pdFALSE;
+    pthread_mutex_unlock(&uart_lock);
+    return HAL_OK;
+}
@@ -0,0 +1,26 @@
+/**
+ ******************************************************************************
+ * @file           : watchdog_host.c
+ * @brief          : Host stand-in for the software watchdog
+ ******************************************************************************
+ * @description
+ * The print task registers with the watchdog and feeds it. Simulations
+ * that do not run src/watchdog.c link this file instead: registration
+ * fails quietly, as on target when the task table is full, and feeding
+ * does nothing. Simulations of the watchdog itself link src/watchdog.c.
+ ******************************************************************************
+ */
+
+#include "watchdog.h"
+
+watchdog_id_t watchdog_register(const char *task_name, uint32_t timeout_ms)
+{
+    (void)task_name;
+    (void)timeout_ms;
+    return WATCHDOG_INVALID_ID;
+}
+
+void watchdog_feed(watchdog_id_t id)
+{
+    (void)id;
+}
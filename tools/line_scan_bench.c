@@ -0,0 +1,161 @@
+/**
+ ******************************************************************************
+ * @file           : line_scan_bench.c
+ * @brief          : Host benchmark for the RX line scanner
+ ******************************************************************************
+ * @description
+ * Feeds synthetic terminal input (menu selections, pasted command
+ * scripts with the odd backspace, and long pasted lines) through the same run/special-character loop as
+ * uart_task_handler(), once with the SWAR scanner and once with the
+ * byte-at-a-time reference, and reports MB/s for each.
+ *
+ * Build and run (from the repository root):
+ *   cc -O2 -Iincludes tools/line_scan_bench.c src/line_scan.c -o line_scan_bench
+ *   ./line_scan_bench [megabytes]
+ ******************************************************************************
+ */
+
+#include "line_scan.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_BLOCK_SIZE  64        /* Same as UART_RX_BLOCK_SIZE */
+#define BENCH_LINE_SIZE   128       /* Same as UART_RX_BUFFER_SIZE */
+
+typedef size_t (*scan_fn)(const uint8_t *data, size_t length);
+
+/* Minimal line editor mirroring uart_task_handler() */
+typedef struct {
+    char line[BENCH_LINE_SIZE];
+    size_t length;
+    unsigned long lines;
+    unsigned long checksum;
+} bench_editor_t;
+
+static void editor_feed(bench_editor_t *ed, const uint8_t *block, size_t length, scan_fn scan)
+{
+    size_t pos = 0;
+
+    while (pos < length) {
+        size_t run = scan(&block[pos], length - pos);
+
+        if (run > 0) {
+            size_t space = BENCH_LINE_SIZE - 1 - ed->length;
+            size_t copy = (run < space) ? run : space;
+            memcpy(&ed->line[ed->length], &block[pos], copy);
+            ed->length += copy;
+            if (copy < run) {
+                ed->length = 0;     /* Overflow: discard the line */
+            }
+            pos += run;
+            continue;
+        }
+
+        uint8_t c = block[pos++];
+        if (c == '\r' || c == '\n') {
+            if (ed->length > 0) {
+                ed->lines++;
+                ed->checksum += ed->length + (uint8_t)ed->line[0];
+                ed->length = 0;
+            }
+        } else if (ed->length > 0) {
+            ed->length--;           /* Backspace / DEL */
+        }
+    }
+}
+
+/* Menu selections: 1-2 character commands */
+static const char *const menu_input[] = {
+    "1\r\n", "2\r\n", "3\r\n", "4\r\n", "0\r\n", "4\b3\r\n",
+};
+
+/* Script lines: parameterised commands and batches */
+static const char *const script_input[] = {
+    "pattern set 2 period 250\r\n",
+    "batch begin; led green on; led orange blink 100; batch end\r\n",
+    "rxstats\r\n",
+    "macro record demo 1 2 3 4 0\r\n",
+    "led on green orange\r\n",
+    "typo\b\b\bext command with a fix\r\n",
+};
+
+/* Pasted text: long lines (log excerpts, notes) up to the buffer size */
+static const char *const paste_input[] = {
+    "# LED pattern notes: pattern 2 alternates green/orange at 250 ms, pattern 3 sweeps all four\r\n",
+    "# captured 2024-05-01 12:00:00 boot ok, watchdog armed, print task idle, uart task blocked ok\r\n",
+    "# macro demo replays the menu selections 1 2 3 4 0 with a 100 ms delay between each entry.\r\n",
+};
+
+static void make_input(uint8_t *buf, size_t size, const char *const *commands, size_t n)
+{
+    size_t pos = 0;
+    unsigned seed = 12345;
+
+    while (pos < size) {
+        seed = seed * 1103515245u + 12345u;
+        const char *cmd = commands[(seed >> 16) % n];
+        size_t len = strlen(cmd);
+        if (len > size - pos) {
+            len = size - pos;
+        }
+        memcpy(&buf[pos], cmd, len);
+        pos += len;
+    }
+}
+
+static double run(const char *name, const uint8_t *input, size_t size, scan_fn scan)
+{
+    bench_editor_t ed;
+    memset(&ed, 0, sizeof(ed));
+
+    clock_t start = clock();
+    for (size_t off = 0; off < size; off += BENCH_BLOCK_SIZE) {
+        size_t len = (size - off < BENCH_BLOCK_SIZE) ? size - off : BENCH_BLOCK_SIZE;
+        editor_feed(&ed, &input[off], len, scan);
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    double mbps = (seconds > 0) ? (size / 1e6) / seconds : 0;
+
+    printf("%-10s %8.1f MB/s  (%lu lines, checksum %lu)\n", name, mbps, ed.lines, ed.checksum);
+    return mbps;
+}
+
+int main(int argc, char **argv)
+{
+    size_t megabytes = (argc > 1) ? (size_t)atoi(argv[1]) : 64;
+    size_t size = megabytes * 1000 * 1000;
+    uint8_t *input = malloc(size);
+
+    if (input == NULL || size == 0) {
+        fprintf(stderr, "cannot allocate %zu MB\n", megabytes);
+        return 1;
+    }
+
+    printf("Line scanner benchmark, %zu MB of synthetic terminal input per run\n", megabytes);
+
+    static const struct {
+        const char *name;
+        const char *const *commands;
+        size_t count;
+    } workloads[] = {
+        { "menu",   menu_input,   sizeof(menu_input) / sizeof(menu_input[0]) },
+        { "script", script_input, sizeof(script_input) / sizeof(script_input[0]) },
+        { "paste",  paste_input,  sizeof(paste_input) / sizeof(paste_input[0]) },
+    };
+
+    for (size_t w = 0; w < sizeof(workloads) / sizeof(workloads[0]); w++) {
+        make_input(input, size, workloads[w].commands, workloads[w].count);
+        printf("\n[%s]\n", workloads[w].name);
+
+        double bytewise = run("bytewise", input, size, line_scan_special_bytewise);
+        double swar = run("swar", input, size, line_scan_special);
+        if (bytewise > 0) {
+            printf("speedup    %8.2fx\n", swar / bytewise);
+        }
+    }
+
+    free(input);
+    return 0;
+}
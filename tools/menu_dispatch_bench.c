@@ -0,0 +1,166 @@
+/**
+ ******************************************************************************
+ * @file           : menu_dispatch_bench.c
+ * @brief          : Host benchmark for menu command dispatch
+ ******************************************************************************
+ * @description
+ * Expands the firmware's own menu table (menu_table.h) twice and times
+ * both ways of finding the handler for a typed command:
+ *
+ * - strcmp chain: what command_handler.c did before the table - the
+ *   global commands first, then one strcmp per option of the current
+ *   menu, in menu order
+ * - table index: what it does now - a single digit indexes the current
+ *   menu's option slots; only other words go through the global commands
+ *
+ * The input is the LED menu traffic of a scripted client (options 0-4
+ * cycled, one invalid digit and one "rxstats" per 16 commands). Handlers
+ * only count, so the time is dispatch alone.
+ *
+ * Build and run (from the repository root):
+ *   cc -O2 -Iincludes tools/menu_dispatch_bench.c -o menu_dispatch_bench
+ *   ./menu_dispatch_bench [million_commands]
+ ******************************************************************************
+ */
+
+#include "menu_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Menus as generated for the firmware (MenuState_t) */
+#define BENCH_STATE_ENUM(state, title, options) state,
+enum { MENU_TREE(BENCH_STATE_ENUM) MENU_STATE_COUNT };
+
+#define BENCH_INVALID  0xFF     /* No option: error path */
+#define BENCH_GLOBAL   0xFE     /* Global command */
+
+/* Global commands, in global_commands[] order (command_handler.c) */
+static const char *const global_commands[] = {
+    "rxstats", "baud", "ok", "machine", "interactive", "status", "pattern", "blink", "duty",
+    "delay", "macro",
+};
+
+/* Looked up by the first word (the inputs here have no arguments) */
+static int global_lookup(const char *command)
+{
+    for (size_t i = 0; i < sizeof(global_commands) / sizeof(global_commands[0]); i++) {
+        if (strcmp(command, global_commands[i]) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* --- strcmp chain: one { "<key>", slot } per option, in menu order --- */
+
+typedef struct {
+    const char *key;
+    unsigned char slot;
+} bench_chain_entry_t;
+
+#define CHAIN_OPTION(key, label, handler)                    { #key, key },
+#define CHAIN_PATTERN(key, label, pattern, message, status)  { #key, key },
+#define CHAIN_MENU(state, title, options) \
+    static const bench_chain_entry_t state##_chain[] = { options(CHAIN_OPTION, CHAIN_PATTERN) };
+MENU_TREE(CHAIN_MENU)
+
+#define CHAIN_ENTRY(state, title, options) \
+    [state] = { state##_chain, sizeof(state##_chain) / sizeof(state##_chain[0]) },
+static const struct {
+    const bench_chain_entry_t *entries;
+    size_t count;
+} chains[MENU_STATE_COUNT] = { MENU_TREE(CHAIN_ENTRY) };
+
+static unsigned dispatch_chain(unsigned state, const char *command)
+{
+    if (global_lookup(command)) {
+        return BENCH_GLOBAL;
+    }
+    for (size_t i = 0; i < chains[state].count; i++) {
+        if (strcmp(command, chains[state].entries[i].key) == 0) {
+            return chains[state].entries[i].slot;
+        }
+    }
+    return BENCH_INVALID;
+}
+
+/* --- table index: slots indexed by the digit, as in command_handler.c --- */
+
+#define SLOT_OPTION(key, label, handler)                    [key] = key + 1,
+#define SLOT_PATTERN(key, label, pattern, message, status)  [key] = key + 1,
+#define SLOT_MENU(state, title, options) \
+    static const unsigned char state##_slots[MENU_MAX_OPTIONS] = { options(SLOT_OPTION, SLOT_PATTERN) };
+MENU_TREE(SLOT_MENU)
+
+#define SLOT_ENTRY(state, title, options) [state] = state##_slots,
+static const unsigned char *const slots[MENU_STATE_COUNT] = { MENU_TREE(SLOT_ENTRY) };
+
+static unsigned dispatch_table(unsigned state, const char *command)
+{
+    if (command[0] >= '0' && command[0] <= '9' && command[1] == '\0') {
+        unsigned char slot = slots[state][command[0] - '0'];
+        return slot ? slot - 1u : BENCH_INVALID;    /* 0 = empty slot */
+    }
+    return global_lookup(command) ? BENCH_GLOBAL : BENCH_INVALID;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static const char *const input[16] = {
+    "1", "2", "3", "4", "0", "1", "2", "3",
+    "4", "9", "1", "2", "rxstats", "3", "4", "0",
+};
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double bench(unsigned (*dispatch)(unsigned, const char *), unsigned long count,
+                    unsigned long *checksum)
+{
+    /* Copies, so the compiler cannot fold the comparisons */
+    static char commands[16][16];
+    for (size_t i = 0; i < 16; i++) {
+        strcpy(commands[i], input[i]);
+    }
+
+    unsigned long sum = 0;
+    double start = now_seconds();
+    for (unsigned long i = 0; i < count; i++) {
+        sum += dispatch(MENU_LED_PATTERNS, commands[i & 15]);
+    }
+    double elapsed = now_seconds() - start;
+
+    *checksum = sum;
+    return elapsed * 1e9 / count;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long count = (unsigned long)((argc > 1) ? atof(argv[1]) : 50.0) * 1000000UL;
+    unsigned long sum_chain, sum_table;
+
+    /* Both must find the same handlers */
+    for (unsigned state = 0; state < MENU_STATE_COUNT; state++) {
+        for (size_t i = 0; i < 16; i++) {
+            if (dispatch_chain(state, input[i]) != dispatch_table(state, input[i])) {
+                fprintf(stderr, "mismatch: menu %u, \"%s\"\n", state, input[i]);
+                return 1;
+            }
+        }
+    }
+
+    double chain_ns = bench(dispatch_chain, count, &sum_chain);
+    double table_ns = bench(dispatch_table, count, &sum_table);
+
+    printf("Menu dispatch, LED menu traffic, %lu commands\n", count);
+    printf("strcmp chain   %6.2f ns/command  (checksum %lu)\n", chain_ns, sum_chain);
+    printf("table index    %6.2f ns/command  (checksum %lu)\n", table_ns, sum_table);
+    printf("speedup        %6.2fx\n", chain_ns / table_ns);
+    return sum_chain != sum_table;
+}
@@ -0,0 +1,405 @@
+/**
+ ******************************************************************************
+ * @file           : print_copy_bench.c
+ * @brief          : Host benchmark: bytes copied per print call, old vs new
+ ******************************************************************************
+ * @description
+ * Sends the same console output through both print pipelines and counts
+ * the bytes each one copies per call:
+ *
+ *   old  the fixed-slot queue (10 x 512-byte xQueue items). print_message()
+ *        staged the text with strncpy() into a 512-byte stack buffer,
+ *        xQueueSend() copied a whole item in and xQueueReceive() a whole
+ *        item out, whatever the text length. print_char() queued a
+ *        2-byte string, still as a whole item.
+ *   new  the message buffer (PRINT_BUFFER_SIZE bytes). Like a FreeRTOS
+ *        message buffer, each message is stored as its length (4 bytes on
+ *        Cortex-M4) followed by the text, wrapping around the end of the
+ *        storage; the print task reads the length, then the text.
+ *
+ * Both pipelines are replayed with real copies into their own storage,
+ * and every byte moved is counted. The print task drains a pipeline when
+ * the next message does not fit, as the blocked producer would wait.
+ *
+ * Workloads (the firmware's own texts):
+ *   echo          print_char() per typed character
+ *   status lines  print_message() of confirmations and errors
+ *   menus         print_message() of the welcome banner and both menus
+ *
+ * Checks (each fails the run):
+ * - A new-pipeline call copies exactly length + 4 bytes in, and the
+ *   print task copies out as many as went in
+ * - Both pipelines deliver the text unchanged, in order
+ *
+ * Build and run (from the repository root):
+ *   cc -O2 tools/print_copy_bench.c -o print_copy_bench
+ *   ./print_copy_bench [repeats]
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Mirrors of the firmware configuration (print_task.h) */
+#define BENCH_MESSAGE_MAX_SIZE  512     /* PRINT_MESSAGE_MAX_SIZE */
+#define BENCH_BUFFER_SIZE       1024    /* PRINT_BUFFER_SIZE */
+#define BENCH_HEADER_SIZE       4       /* Message length (size_t on Cortex-M4) */
+
+/* The old pipeline */
+#define OLD_MESSAGE_MAX_SIZE    512
+#define OLD_QUEUE_DEPTH         10
+
+#define BENCH_WIRE_CAPACITY     (8u * 1024u * 1024u)
+
+/*============================================================================
+ * Workloads
+ *===========================================================================*/
+
+typedef enum {
+    BENCH_CALL_CHAR = 0,
+    BENCH_CALL_MESSAGE
+} bench_call_t;
+
+typedef struct {
+    const char *name;
+    bench_call_t call;
+    const char *const *texts;   /* Each is one call (BENCH_CALL_CHAR: one per character) */
+    unsigned count;
+} bench_workload_t;
+
+static const char *const typed[] = {
+    "1\r", "2\r", "0\r", "3\r", "4\r", "0\r", "2\r",
+};
+
+static const char *const status_lines[] = {
+    "\r\nNow playing LED Pattern 1\r\n",
+    "\r\nNow playing LED Pattern 2\r\n",
+    "\r\nNow playing LED Pattern 3\r\n",
+    "\r\nAll LEDs turned OFF\r\n",
+    "\r\nInvalid option. Please try again.\r\n",
+    "\r\nError: Command queue full!\r\n",
+    "\b \b",
+};
+
+static const char *const menus[] = {
+    "\r\n\r\n"
+    "****************************************\r\n"
+    "*                                      *\r\n"
+    "*   LED Pattern Control Application   *\r\n"
+    "*        FreeRTOS UART Interface       *\r\n"
+    "*                                      *\r\n"
+    "****************************************\r\n",
+
+    "\r\n========================================\r\n"
+    "              MAIN MENU\r\n"
+    "========================================\r\n"
+    "  1 - LED Patterns\r\n"
+    "  2 - Exit Application\r\n"
+    "========================================\r\n"
+    "Enter selection: ",
+
+    "\r\n========================================\r\n"
+    "        LED Pattern Selection\r\n"
+    "========================================\r\n"
+    "  0 - Return to main menu\r\n"
+    "  1 - All LEDs ON\r\n"
+    "  2 - Different Frequency Blinking\r\n"
+    "  3 - Same Frequency Blinking\r\n"
+    "  4 - All LEDs OFF\r\n"
+    "========================================\r\n"
+    "Enter selection: ",
+};
+
+#define COUNT(array) (unsigned)(sizeof(array) / sizeof((array)[0]))
+
+static const bench_workload_t workloads[] = {
+    { "echo",         BENCH_CALL_CHAR,    typed,        COUNT(typed) },
+    { "status lines", BENCH_CALL_MESSAGE, status_lines, COUNT(status_lines) },
+    { "menus",        BENCH_CALL_MESSAGE, menus,        COUNT(menus) },
+};
+
+/* What the print task sent, per pipeline */
+typedef struct {
+    char *data;
+    size_t length;
+} bench_wire_t;
+
+static void wire_put(bench_wire_t *wire, const char *data, size_t length)
+{
+    if (wire->length + length <= BENCH_WIRE_CAPACITY) {
+        memcpy(&wire->data[wire->length], data, length);
+    }
+    wire->length += length;
+}
+
+/*============================================================================
+ * Old pipeline: fixed-slot queue
+ *===========================================================================*/
+
+static char old_slots[OLD_QUEUE_DEPTH][OLD_MESSAGE_MAX_SIZE];
+static unsigned old_head, old_tail;
+static unsigned long old_copied;        /* In + out of the queue */
+static unsigned long old_staged;        /* strncpy() into the stack buffer */
+static bench_wire_t old_wire;
+
+/* xQueueSend() / xQueueReceive() copy a whole item */
+static void old_queue_send(const char *item)
+{
+    memcpy(old_slots[old_head % OLD_QUEUE_DEPTH], item, OLD_MESSAGE_MAX_SIZE);
+    old_copied += OLD_MESSAGE_MAX_SIZE;
+    old_head++;
+}
+
+static void old_print_task_drain(void)
+{
+    char message_buffer[OLD_MESSAGE_MAX_SIZE];
+
+    while (old_tail != old_head) {
+        memcpy(message_buffer, old_slots[old_tail % OLD_QUEUE_DEPTH], OLD_MESSAGE_MAX_SIZE);
+        old_copied += OLD_MESSAGE_MAX_SIZE;
+        old_tail++;
+        wire_put(&old_wire, message_buffer, strlen(message_buffer));
+    }
+}
+
+static void old_print_message(const char *message)
+{
+    char buffer[OLD_MESSAGE_MAX_SIZE];
+
+    strncpy(buffer, message, OLD_MESSAGE_MAX_SIZE - 1);
+    buffer[OLD_MESSAGE_MAX_SIZE - 1] = '\0';
+    old_staged += OLD_MESSAGE_MAX_SIZE;
+    if (old_head - old_tail == OLD_QUEUE_DEPTH) {
+        old_print_task_drain();
+    }
+    old_queue_send(buffer);
+}
+
+/* The old print_char() handed a 2-byte buffer to a 512-byte queue item;
+ * padded here so the same 512 bytes are copied without reading past it */
+static void old_print_char(char c)
+{
+    char buffer[OLD_MESSAGE_MAX_SIZE] = { c, '\0' };
+
+    if (old_head - old_tail == OLD_QUEUE_DEPTH) {
+        old_print_task_drain();
+    }
+    old_queue_send(buffer);
+}
+
+/*============================================================================
+ * New pipeline: message buffer
+ *===========================================================================*/
+
+static uint8_t new_storage[BENCH_BUFFER_SIZE];
+static size_t new_head, new_tail, new_used;
+static unsigned long new_copied_in;     /* Length headers included */
+static unsigned long new_copied_out;
+static unsigned long new_wraps;         /* Copies split at the end of the storage */
+static bench_wire_t new_wire;
+
+/* Copy into / out of the circular storage, in at most two pieces */
+static void new_ring_write(const void *data, size_t length)
+{
+    size_t first = BENCH_BUFFER_SIZE - new_head;
+
+    if (first > length) {
+        first = length;
+    }
+    memcpy(&new_storage[new_head], data, first);
+    memcpy(new_storage, (const uint8_t *)data + first, length - first);
+    new_wraps += (first < length);
+    new_head = (new_head + length) % BENCH_BUFFER_SIZE;
+    new_used += length;
+    new_copied_in += length;
+}
+
+static void new_ring_read(void *data, size_t length)
+{
+    size_t first = BENCH_BUFFER_SIZE - new_tail;
+
+    if (first > length) {
+        first = length;
+    }
+    memcpy(data, &new_storage[new_tail], first);
+    memcpy((uint8_t *)data + first, new_storage, length - first);
+    new_tail = (new_tail + length) % BENCH_BUFFER_SIZE;
+    new_used -= length;
+    new_copied_out += length;
+}
+
+/* One xMessageBufferReceive() in the print task */
+static void new_print_task_receive(void)
+{
+    char message_buffer[BENCH_MESSAGE_MAX_SIZE];
+    uint32_t length;
+
+    new_ring_read(&length, BENCH_HEADER_SIZE);
+    new_ring_read(message_buffer, length);
+    wire_put(&new_wire, message_buffer, length);
+}
+
+/* xMessageBufferSend(): length, then the bytes; waits for space */
+static void new_send(const void *data, size_t length)
+{
+    uint32_t header = (uint32_t)length;
+
+    while (BENCH_BUFFER_SIZE - new_used < BENCH_HEADER_SIZE + length) {
+        new_print_task_receive();
+    }
+    new_ring_write(&header, BENCH_HEADER_SIZE);
+    new_ring_write(data, length);
+}
+
+static void new_print_message(const char *message)
+{
+    size_t length = strnlen(message, BENCH_MESSAGE_MAX_SIZE);
+
+    if (length > 0) {
+        new_send(message, length);
+    }
+}
+
+static void new_print_char(char c)
+{
+    new_send(&c, 1);
+}
+
+static void new_print_task_drain(void)
+{
+    while (new_used > 0) {
+        new_print_task_receive();
+    }
+}
+
+/*============================================================================
+ * Benchmark
+ *===========================================================================*/
+
+typedef struct {
+    unsigned long calls;
+    unsigned long text_bytes;   /* Characters printed */
+    unsigned long old_copied;
+    unsigned long old_staged;
+    unsigned long new_copied;
+    unsigned long mismatches;   /* Calls not copying length + 4 in */
+} bench_result_t;
+
+static void bench_run(const bench_workload_t *workload, unsigned repeats, bench_result_t *result)
+{
+    unsigned long old_copied_start = old_copied, old_staged_start = old_staged;
+    unsigned long new_in_start = new_copied_in, new_out_start = new_copied_out;
+
+    memset(result, 0, sizeof(*result));
+
+    for (unsigned repeat = 0; repeat < repeats; repeat++) {
+        for (unsigned i = 0; i < workload->count; i++) {
+            const char *text = workload->texts[i];
+            size_t length = strlen(text);
+
+            result->text_bytes += length;
+            if (workload->call == BENCH_CALL_CHAR) {
+                for (size_t k = 0; k < length; k++) {
+                    unsigned long before = new_copied_in;
+                    old_print_char(text[k]);
+                    new_print_char(text[k]);
+                    if (new_copied_in - before != 1 + BENCH_HEADER_SIZE) {
+                        result->mismatches++;
+                    }
+                    result->calls++;
+                }
+            } else {
+                unsigned long before = new_copied_in;
+                old_print_message(text);
+                new_print_message(text);
+                if (new_copied_in - before != length + BENCH_HEADER_SIZE) {
+                    result->mismatches++;
+                }
+                result->calls++;
+            }
+        }
+    }
+    old_print_task_drain();
+    new_print_task_drain();
+
+    result->old_copied = old_copied - old_copied_start;
+    result->old_staged = old_staged - old_staged_start;
+    result->new_copied = (new_copied_in - new_in_start) + (new_copied_out - new_out_start);
+    if (new_copied_out - new_out_start != new_copied_in - new_in_start) {
+        result->mismatches++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned repeats = (argc > 1) ? (unsigned)atoi(argv[1]) : 100;
+    unsigned long old_total = 0, new_total = 0, calls_total = 0;
+    size_t expected_length = 0;
+    char *expected;
+    int failures = 0;
+
+    if (repeats == 0) {
+        return 1;
+    }
+    expected = malloc(BENCH_WIRE_CAPACITY);
+    old_wire.data = malloc(BENCH_WIRE_CAPACITY);
+    new_wire.data = malloc(BENCH_WIRE_CAPACITY);
+    if (expected == NULL || old_wire.data == NULL || new_wire.data == NULL) {
+        return 1;
+    }
+
+    printf("Bytes copied per print call (in + out), %u repeats of each workload\n\n", repeats);
+    printf("%-14s %7s %8s %10s %10s %10s %8s\n", "workload", "calls", "avg len",
+           "old B/call", "+staging", "new B/call", "old/new");
+
+    for (unsigned w = 0; w < COUNT(workloads); w++) {
+        bench_result_t result;
+
+        bench_run(&workloads[w], repeats, &result);
+        for (unsigned repeat = 0; repeat < repeats; repeat++) {
+            for (unsigned i = 0; i < workloads[w].count; i++) {
+                size_t length = strlen(workloads[w].texts[i]);
+                if (expected_length + length <= BENCH_WIRE_CAPACITY) {
+                    memcpy(&expected[expected_length], workloads[w].texts[i], length);
+                }
+                expected_length += length;
+            }
+        }
+        if (result.mismatches != 0) {
+            fprintf(stderr, "FAIL %s: %lu copies differ from length + %d in, same out\n",
+                    workloads[w].name, result.mismatches, BENCH_HEADER_SIZE);
+            failures++;
+        }
+
+        double calls = (double)result.calls;
+        printf("%-14s %7lu %8.1f %10.1f %10.1f %10.1f %7.0fx\n", workloads[w].name,
+               result.calls, result.text_bytes / calls, result.old_copied / calls,
+               result.old_staged / calls, result.new_copied / calls,
+               (double)result.old_copied / (double)result.new_copied);
+
+        old_total += result.old_copied;
+        new_total += result.new_copied;
+        calls_total += result.calls;
+    }
+
+    printf("%-14s %7lu %8s %10.1f %10s %10.1f %7.0fx\n", "all", calls_total, "",
+           old_total / (double)calls_total, "", new_total / (double)calls_total,
+           (double)old_total / (double)new_total);
+    printf("\n(+staging: old print_message() also strncpy()'d into a 512-byte stack buffer)\n");
+    printf("Storage: old %d bytes (%d x %d), new %d bytes (%lu copies wrapped)\n",
+           OLD_QUEUE_DEPTH * OLD_MESSAGE_MAX_SIZE, OLD_QUEUE_DEPTH, OLD_MESSAGE_MAX_SIZE,
+           BENCH_BUFFER_SIZE, new_wraps);
+
+    if (expected_length > BENCH_WIRE_CAPACITY ||
+        old_wire.length != expected_length || new_wire.length != expected_length ||
+        memcmp(old_wire.data, expected, expected_length) != 0 ||
+        memcmp(new_wire.data, expected, expected_length) != 0) {
+        fprintf(stderr, "FAIL: output differs from the text printed\n");
+        failures++;
+    }
+
+    printf("\n%s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
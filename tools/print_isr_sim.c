@@ -0,0 +1,300 @@
+/**
+ ******************************************************************************
+ * @file           : print_isr_sim.c
+ * @brief          : Host stress test of interrupt output under heavy task output
+ ******************************************************************************
+ * @description
+ * Runs the firmware's own print_task.c and print_port.c on the host
+ * models in tools/host. Two simulated interrupts (UART RX and EXTI, both
+ * at priority 6) print through print_message_from_isr() while three tasks
+ * flood the bulk and urgent lanes: first at random 0.2 ... 8 ms
+ * intervals, then back to back (a storm that keeps both rings full, so
+ * every slot the print task frees is refilled at once). Interrupts really
+ * run concurrently with the print task draining their rings.
+ *
+ * Checks (each fails the run):
+ * - Every task line arrives once, whole and in order (tasks retry on a
+ *   full lane, so none may be lost)
+ * - Every interrupt message that was accepted arrives once, whole and in
+ *   order; the ones that were not are exactly those counted in
+ *   isr_dropped
+ * - An interrupt above configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY (the
+ *   TIM6 timebase at priority 0) trips configASSERT() before touching its
+ *   ring, while priority 5 is still accepted
+ *
+ * Build and run (from the repository root):
+ *   cc -O2 -pthread -Itools/host -Iincludes tools/print_isr_sim.c \
+ *      tools/host/freertos_host.c tools/host/uart_host.c \
+ *      tools/host/watchdog_host.c src/print_task.c src/print_port.c \
+ *      -o print_isr_sim
+ *   ./print_isr_sim [seconds per phase]
+ ******************************************************************************
+ */
+
+#include "host_sim.h"
+#include "print_task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/wait.h>
+
+#define SIM_CHAR_TIME_US    87          /* 115200 baud, 8N1 */
+#define SIM_TASKS           3
+#define SIM_SOURCES         PRINT_ISR_SOURCE_COUNT
+#define SIM_WIRE_CAPACITY   (4u * 1024u * 1024u)
+#define SIM_LINE_MAX        160
+#define SIM_FILL_MAX        100         /* Task filler length is 0..99 */
+#define SIM_ISR_FILL_MAX    40          /* Interrupt filler length is 0..39 */
+#define SIM_ISR_PRIORITY    6           /* USART2 and EXTI3 (main.c, msp) */
+#define SIM_FLUSH_MS        10000
+
+static volatile int running = 1;
+static volatile unsigned tasks_done;
+
+/* Filler of a line: its length and letter follow from the sequence */
+static size_t filler(char kind, unsigned id, unsigned long seq, char *dest)
+{
+    size_t max = (kind == 'I') ? SIM_ISR_FILL_MAX : SIM_FILL_MAX;
+    size_t length = (seq * 37u + id * 11u) % max;
+
+    memset(dest, (kind == 'I' ? 'A' : 'a') + (int)((seq + id) % 26u), length);
+    dest[length] = '\0';
+    return length;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static unsigned long task_sent[SIM_TASKS];
+
+static void producer_task(void *parameters)
+{
+    unsigned id = (unsigned)(uintptr_t)parameters;
+    char fill[SIM_FILL_MAX];
+    char line[SIM_LINE_MAX];
+
+    while (running) {
+        unsigned long seq = task_sent[id];
+
+        filler('T', id, seq, fill);
+        snprintf(line, sizeof(line), "T%u %05lu %s\r\n", id, seq, fill);
+
+        // A full lane is back-pressure: retry the same line
+        BaseType_t queued = (id == SIM_TASKS - 1) ? print_message_urgent(line) : print_message(line);
+        if (queued != pdPASS) {
+            vTaskDelay(1);
+            continue;
+        }
+        task_sent[id]++;
+        if (id == SIM_TASKS - 1) {
+            vTaskDelay(10);     // Alerts are occasional
+        }
+    }
+    __sync_fetch_and_add(&tasks_done, 1);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/* Per source: messages fired, and the sequence numbers of those accepted */
+#define SIM_ACCEPTED_MAX 100000
+
+static volatile int storm = 0;
+static unsigned long isr_fired[SIM_SOURCES];
+static unsigned long isr_accepted[SIM_SOURCES][SIM_ACCEPTED_MAX];
+static unsigned long isr_accepted_count[SIM_SOURCES];
+
+static void *interrupt_thread(void *argument)
+{
+    print_isr_source_t source = (print_isr_source_t)(uintptr_t)argument;
+    unsigned seed = 1234u + (unsigned)source;
+    char fill[SIM_ISR_FILL_MAX];
+    char line[PRINT_ISR_MESSAGE_MAX_SIZE + 1];
+
+    while (running && isr_accepted_count[source] < SIM_ACCEPTED_MAX) {
+        if (!storm) {
+            struct timespec gap = { 0, 200000L + (long)(rand_r(&seed) % 7800) * 1000L };
+            nanosleep(&gap, NULL);
+        }
+
+        unsigned long seq = isr_fired[source];
+        BaseType_t woken = pdFALSE;
+
+        filler('I', source, seq, fill);
+        snprintf(line, sizeof(line), "I%u %lu %s\r\n", (unsigned)source, seq, fill);
+
+        host_interrupt_enter(SIM_ISR_PRIORITY);
+        BaseType_t queued = print_message_from_isr(source, line, &woken);
+        host_interrupt_exit();
+
+        if (queued == pdPASS) {
+            isr_accepted[source][isr_accepted_count[source]++] = seq;
+        }
+        isr_fired[source] = seq + 1;
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+
+typedef struct {
+    unsigned long lines;
+    unsigned long bad;              /* Torn, repeated, reordered or unknown */
+    unsigned long task_missing;
+    unsigned long isr_missing;      /* Accepted but never seen */
+} wire_check_t;
+
+static void check_wire(wire_check_t *result)
+{
+    unsigned long task_next[SIM_TASKS] = { 0 };
+    unsigned long isr_next[SIM_SOURCES] = { 0 };    /* Index into isr_accepted */
+    const uint8_t *wire;
+    size_t length = host_uart_wire(&wire);
+    size_t offset = 0;
+    char fill[SIM_FILL_MAX];
+
+    memset(result, 0, sizeof(*result));
+    while (offset < length) {
+        const char *line = (const char *)&wire[offset];
+        const uint8_t *end = memchr(&wire[offset], '\n', length - offset);
+        size_t line_length = (end != NULL) ? (size_t)(end - &wire[offset]) + 1 : length - offset;
+        char kind = line[0];
+        unsigned id;
+        unsigned long seq;
+        int text = 0;
+
+        offset += line_length;
+        if (sscanf(line, "%*c%u %lu%n", &id, &seq, &text) != 2 || line[text++] != ' ' ||
+            (kind == 'T' && (id >= SIM_TASKS || seq < task_next[id])) ||
+            (kind == 'I' && (id >= SIM_SOURCES || isr_next[id] >= isr_accepted_count[id] ||
+                             seq < isr_accepted[id][isr_next[id]])) ||
+            (kind != 'T' && kind != 'I')) {
+            result->bad++;
+            continue;
+        }
+
+        size_t fill_length = filler(kind, id, seq, fill);
+        if (line_length != (size_t)text + fill_length + 2 ||
+            memcmp(&line[text], fill, fill_length) != 0) {
+            result->bad++;
+            continue;
+        }
+
+        if (kind == 'T') {
+            result->task_missing += seq - task_next[id];
+            task_next[id] = seq + 1;
+        } else {
+            // Accepted messages must come out in order; skip to this one
+            while (isr_next[id] < isr_accepted_count[id] && isr_accepted[id][isr_next[id]] < seq) {
+                isr_next[id]++;
+                result->isr_missing++;
+            }
+            if (isr_next[id] == isr_accepted_count[id] || isr_accepted[id][isr_next[id]] != seq) {
+                result->bad++;      // Sent although it was refused
+                continue;
+            }
+            isr_next[id]++;
+        }
+        result->lines++;
+    }
+
+    for (unsigned id = 0; id < SIM_TASKS; id++) {
+        result->task_missing += task_sent[id] - task_next[id];
+    }
+    for (unsigned id = 0; id < SIM_SOURCES; id++) {
+        result->isr_missing += isr_accepted_count[id] - isr_next[id];
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
+/* Print from a simulated interrupt of the given priority in a child process */
+static int print_at_priority(int priority)
+{
+    pid_t child = fork();
+    int status = 0;
+
+    if (child == 0) {
+        BaseType_t woken = pdFALSE;
+
+        freopen("/dev/null", "w", stderr);
+        host_interrupt_enter(priority);
+        print_message_from_isr(PRINT_ISR_SOURCE_EXTI, "priority\r\n", &woken);
+        host_interrupt_exit();
+        _exit(0);
+    }
+    waitpid(child, &status, 0);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned seconds = (argc > 1) ? (unsigned)atoi(argv[1]) : 2;
+    pthread_t interrupts[SIM_SOURCES];
+    print_stats_t stats;
+    wire_check_t result;
+    unsigned long fired = 0, accepted = 0, storm_fired = 0;
+
+    if (seconds == 0) {
+        return 1;
+    }
+
+    // Priority check first, before any thread exists to fork with
+    CHECK(print_at_priority(0));        // TIM6 timebase (TICK_INT_PRIORITY)
+    CHECK(!print_at_priority(configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY));
+    printf("Priority 0 interrupt: configASSERT %s\n\n", failures ? "NOT hit" : "hit");
+
+    host_uart_init(SIM_CHAR_TIME_US, SIM_WIRE_CAPACITY);
+    print_task_init();
+    vTaskStartScheduler();
+
+    for (unsigned id = 0; id < SIM_TASKS; id++) {
+        xTaskCreate(producer_task, "Producer", 256, (void *)(uintptr_t)id, 2, NULL);
+    }
+    for (unsigned id = 0; id < SIM_SOURCES; id++) {
+        pthread_create(&interrupts[id], NULL, interrupt_thread, (void *)(uintptr_t)id);
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(seconds * 1000u));
+    for (unsigned id = 0; id < SIM_SOURCES; id++) {
+        storm_fired -= isr_fired[id];
+    }
+    storm = 1;
+    vTaskDelay(pdMS_TO_TICKS(seconds * 1000u));
+    running = 0;
+
+    for (unsigned id = 0; id < SIM_SOURCES; id++) {
+        pthread_join(interrupts[id], NULL);
+        fired += isr_fired[id];
+        accepted += isr_accepted_count[id];
+    }
+    storm_fired += fired;
+    while (tasks_done < SIM_TASKS) {
+        vTaskDelay(1);
+    }
+    CHECK(print_flush(pdMS_TO_TICKS(SIM_FLUSH_MS)) == pdPASS);
+
+    check_wire(&result);
+    print_get_stats(&stats);
+
+    printf("2 x %u s of task output at 115200 baud, %d interrupt sources\n", seconds, SIM_SOURCES);
+    printf("  task lines   %10lu (missing %lu)\n", task_sent[0] + task_sent[1] + task_sent[2],
+           result.task_missing);
+    printf("  interrupts   %10lu fired (%lu paced, %lu in the storm)\n", fired,
+           fired - storm_fired, storm_fired);
+    printf("               %10lu accepted, %u dropped (ring full)\n", accepted,
+           (unsigned)stats.isr_dropped);
+    printf("  wire lines   %10lu (bad %lu, accepted but lost %lu)\n\n", result.lines, result.bad,
+           result.isr_missing);
+
+    CHECK(result.bad == 0);
+    CHECK(result.task_missing == 0);
+    CHECK(result.isr_missing == 0);
+    CHECK(stats.isr_messages == accepted);
+    CHECK(stats.isr_dropped == fired - accepted);
+
+    printf("Interrupt output checks: %s\n", failures ? "FAILED" : "ok");
+    return failures != 0;
+}
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""
+Host-side decoder for tokenized print_log() frames.
+
+Reads a raw UART capture (file or stdin), passes plain text straight
+through and expands binary log frames back into text using the event
+table emitted by tools/print_log_table.c (entry order = event ID). The
+table comes from the compiled PRINT_LOG_TABLE, not from parsing C source.
+
+Frame format (see print_log.h):
+    0x1F | ID | LEN | payload (LEN bytes)
+    %s args: 1 length byte + bytes; other conversions and each '*'
+    width/precision: 4 bytes little-endian
+
+Usage (from the repository root):
+    cc -Iincludes tools/print_log_table.c -o print_log_table
+    ./print_log_table > tools/print_log_table.json
+    cat /dev/ttyUSB0 | tools/print_log_decode.py
+    tools/print_log_decode.py capture.bin --stats
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+SYNC = 0x1F
+
+DEFAULT_TABLE = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                             "print_log_table.json")
+
+# Flags, width, precision (either may be '*'), length, conversion
+CONVERSION_RE = re.compile(r'%([-+ #0]*)(\*|[0-9]+)?(?:\.(\*|[0-9]*))?'
+                           r'(?:hh|h|ll|l|L|z|j|t)?([diouxXcsp%])')
+
+
+def load_table(path):
+    """Return [(name, format)] in ID order from print_log_table.c's output."""
+    try:
+        with open(path, encoding="utf-8") as f:
+            events = json.load(f)["events"]
+    except FileNotFoundError:
+        sys.exit("%s not found - generate it with tools/print_log_table.c "
+                 "(see its header or --help)" % path)
+    events.sort(key=lambda event: event["id"])
+    if [event["id"] for event in events] != list(range(len(events))):
+        sys.exit("%s: event IDs are not 0..%d" % (path, len(events) - 1))
+    return [(event["name"], event["format"]) for event in events]
+
+
+def conversions(fmt):
+    """Argument-consuming items of a C format string, in argument order.
+
+    A '*' width or precision takes an argument of its own, before the
+    conversion's one (as vsnprintf() reads them).
+    """
+    items = []
+    for _, width, precision, conv in CONVERSION_RE.findall(fmt):
+        if conv == "%":
+            continue
+        items += ["*"] * ((width == "*") + (precision == "*"))
+        items.append(conv)
+    return items
+
+
+def render(fmt, args):
+    """Apply C-style format to decoded arguments."""
+    values = iter(args)
+
+    def repl(match):
+        flags, width, precision, conv = match.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(next(values, 0))
+        if precision == "*":
+            precision = str(next(values, 0))
+        value = next(values, 0)
+        if conv == "p":
+            return "0x%08x" % value
+        if conv == "u":
+            conv = "d"
+        spec = "%" + flags + (width or "")
+        if precision is not None:
+            spec += "." + precision
+        return (spec + conv) % value
+
+    return CONVERSION_RE.sub(repl, fmt)
+
+
+def decode_payload(fmt, payload):
+    """Split a frame payload into Python values according to fmt."""
+    args = []
+    pos = 0
+    for conv in conversions(fmt):
+        if conv == "s":
+            length = payload[pos]
+            args.append(payload[pos + 1:pos + 1 + length].decode("ascii", "replace"))
+            pos += 1 + length
+        else:
+            (value,) = struct.unpack_from("<I", payload, pos)
+            if conv in "di*" and value & 0x80000000:
+                value -= 1 << 32
+            if conv == "c":
+                value = chr(value & 0xFF)
+            args.append(value)
+            pos += 4
+    return args
+
+
+def decode(data, table, out, stats):
+    """Decode a capture, writing text to out and filling stats per event."""
+    i = 0
+    plain = bytearray()
+    while i < len(data):
+        byte = data[i]
+        if byte != SYNC or i + 3 > len(data):
+            plain.append(byte)
+            i += 1
+            continue
+
+        event_id, length = data[i + 1], data[i + 2]
+        end = i + 3 + length
+        if event_id >= len(table) or end > len(data):
+            plain.append(byte)  # Not a valid frame - treat as text
+            i += 1
+            continue
+
+        out.write(plain.decode("ascii", "replace"))
+        plain.clear()
+
+        name, fmt = table[event_id]
+        text = render(fmt, decode_payload(fmt, data[i + 3:end]))
+        out.write(text)
+
+        entry = stats.setdefault(name, [0, 0, 0])
+        entry[0] += 1
+        entry[1] += end - i
+        entry[2] += len(text.encode("ascii", "replace"))
+        i = end
+
+    out.write(plain.decode("ascii", "replace"))
+
+
+def print_stats(stats, out):
+    out.write("\n%-28s %7s %12s %12s %7s\n" % ("event", "count", "wire B/evt", "text B/evt", "ratio"))
+    total = [0, 0, 0]
+    for name, (count, wire, text) in sorted(stats.items()):
+        out.write("%-28s %7d %12.1f %12.1f %6.1fx\n"
+                  % (name, count, wire / count, text / count, text / wire))
+        total = [total[0] + count, total[1] + wire, total[2] + text]
+    if total[0]:
+        out.write("%-28s %7d %12.1f %12.1f %6.1fx\n"
+                  % ("TOTAL", total[0], total[1] / total[0], total[2] / total[0],
+                     total[2] / total[1]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", nargs="?", default="-",
+                        help="raw UART capture (default: stdin)")
+    parser.add_argument("--table", default=DEFAULT_TABLE,
+                        help="event table from tools/print_log_table.c "
+                             "(default: tools/print_log_table.json)")
+    parser.add_argument("--stats", action="store_true",
+                        help="report wire bytes vs text bytes per event")
+    args = parser.parse_args()
+
+    table = load_table(args.table)
+    if args.capture == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.capture, "rb") as f:
+            data = f.read()
+
+    stats = {}
+    decode(data, table, sys.stdout, stats)
+    if args.stats:
+        print_stats(stats, sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,61 @@
+/**
+ ******************************************************************************
+ * @file           : print_log_table.c
+ * @brief          : Emits the log event table for tools/print_log_decode.py
+ ******************************************************************************
+ * @description
+ * Expands PRINT_LOG_TABLE (includes/print_log_table.h) with the C compiler,
+ * exactly as the firmware does, and writes it as JSON: one entry per event
+ * ID with its name and the format string after literal concatenation and
+ * escape processing. The decoder reads this file instead of parsing the
+ * header, so any table the firmware compiles decodes the same way.
+ *
+ * Regenerate after changing PRINT_LOG_TABLE (from the repository root):
+ *   cc -Iincludes tools/print_log_table.c -o print_log_table
+ *   ./print_log_table > tools/print_log_table.json
+ ******************************************************************************
+ */
+
+#include "print_log_table.h"
+#include <stdio.h>
+
+static const struct {
+    const char *name;
+    const char *format;
+} events[] = {
+#define PRINT_LOG_TABLE_ENTRY(name, format) { #name, format },
+    PRINT_LOG_TABLE(PRINT_LOG_TABLE_ENTRY)
+#undef PRINT_LOG_TABLE_ENTRY
+};
+
+/* JSON string literal (control characters as \uXXXX) */
+static void put_json_string(const char *text)
+{
+    putchar('"');
+    for (const unsigned char *p = (const unsigned char *)text; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') {
+            printf("\\%c", *p);
+        } else if (*p < 0x20 || *p >= 0x7F) {
+            printf("\\u%04x", *p);
+        } else {
+            putchar(*p);
+        }
+    }
+    putchar('"');
+}
+
+int main(void)
+{
+    size_t count = sizeof(events) / sizeof(events[0]);
+
+    printf("{\n  \"events\": [\n");
+    for (size_t id = 0; id < count; id++) {
+        printf("    { \"id\": %zu, \"name\": ", id);
+        put_json_string(events[id].name);
+        printf(", \"format\": ");
+        put_json_string(events[id].format);
+        printf(" }%s\n", (id + 1 < count) ? "," : "");
+    }
+    printf("  ]\n}\n");
+    return 0;
+}
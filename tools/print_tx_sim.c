@@ -0,0 +1,295 @@
+/**
+ ******************************************************************************
+ * @file           : print_tx_sim.c
+ * @brief          : Host simulation of DMA transmit and the TC interrupt
+ ******************************************************************************
+ * @description
+ * Runs the firmware's own print_task.c and print_port.c on the host
+ * kernel and UART models in tools/host. Four producer tasks (printf,
+ * copied text, raw writes and urgent alerts, plus a constant menu) flood
+ * the print path while the simulated DMA drains it at 115200 baud and
+ * the TC interrupt releases each burst.
+ *
+ * Every line carries its producer, a sequence number and a filler whose
+ * length and letter follow from the sequence number, so a torn, doubled,
+ * reordered or missing line is caught. Three phases, each failing the
+ * run if anything is wrong:
+ *
+ * 1. Refused starts: the HAL refuses a DMA start now and then, never more
+ *    than PRINT_TX_START_RETRIES times in a row. Nothing may be lost and
+ *    every refusal must show up in tx_refused.
+ *
+ * 2. Stuck UART: one start is refused PRINT_TX_START_RETRIES + 1 times.
+ *    Exactly one burst is dropped (tx_lost) - whole lines only - and
+ *    output carries on behind it.
+ *
+ * 3. Lost TC interrupt: one transfer completes without its interrupt.
+ *    print_port_wait_idle() times out (tx_timeouts), nothing is lost.
+ *
+ * Each phase also reports how busy the wire was, i.e. how well the
+ * double buffering keeps the next burst ready when the TC interrupt fires.
+ *
+ * Build and run (from the repository root):
+ *   cc -O2 -pthread -Itools/host -Iincludes tools/print_tx_sim.c \
+ *      tools/host/freertos_host.c tools/host/uart_host.c \
+ *      tools/host/watchdog_host.c src/print_task.c src/print_port.c \
+ *      -o print_tx_sim
+ *   ./print_tx_sim [lines per producer]
+ ******************************************************************************
+ */
+
+#include "host_sim.h"
+#include "print_task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_CHAR_TIME_US    87          /* 115200 baud, 8N1 */
+#define SIM_PRODUCERS       4
+#define SIM_WIRE_CAPACITY   (4u * 1024u * 1024u)
+#define SIM_LINE_MAX        160
+#define SIM_FILL_MAX        100         /* Filler length is 0..99 */
+#define SIM_FLUSH_MS        10000
+#define SIM_MIN_LINES       30          /* Enough bursts to inject faults into */
+
+static const char menu_text[] =
+    "M ==== LED Patterns ====\r\n"
+    "M 1. Pattern 1\r\n"
+    "M 2. Pattern 2\r\n"
+    "M 0. Back\r\n";
+#define MENU_LINES 4
+#define MENU_EVERY 10       /* Producer 0 sends the menu every N lines */
+
+static unsigned lines_per_producer;
+static unsigned long next_seq[SIM_PRODUCERS];   /* Next line each producer sends */
+static volatile unsigned producers_done;
+
+/* Filler of a line: its length and letter follow from the sequence */
+static size_t filler(unsigned id, unsigned long seq, char *dest)
+{
+    size_t length = (seq * 37u + id * 11u) % SIM_FILL_MAX;
+
+    memset(dest, 'a' + (int)((seq + id) % 26u), length);
+    dest[length] = '\0';
+    return length;
+}
+
+/* Enqueue until accepted: a full lane is back-pressure, not loss */
+#define UNTIL_QUEUED(call) \
+    while ((call) != pdPASS) { \
+        vTaskDelay(1); \
+    }
+
+static void producer_task(void *parameters)
+{
+    unsigned id = (unsigned)(uintptr_t)parameters;
+    char fill[SIM_FILL_MAX];
+    char line[SIM_LINE_MAX];
+
+    for (unsigned i = 0; i < lines_per_producer; i++) {
+        unsigned long seq = next_seq[id]++;
+        filler(id, seq, fill);
+
+        switch (id) {
+        case 0:
+            // Deferred formatting: %s must point at a literal
+            UNTIL_QUEUED(print_printf("P0 %05lu %s\r\n", seq, "-"));
+            if (seq % MENU_EVERY == 0) {
+                UNTIL_QUEUED(print_const(menu_text));
+            }
+            break;
+        case 1:
+            snprintf(line, sizeof(line), "P1 %05lu %s\r\n", seq, fill);
+            UNTIL_QUEUED(print_message(line));
+            break;
+        case 2: {
+            int length = snprintf(line, sizeof(line), "P2 %05lu %s\r\n", seq, fill);
+            UNTIL_QUEUED(print_write(line, (size_t)length));
+            break;
+        }
+        default:
+            snprintf(line, sizeof(line), "P3 %05lu %s\r\n", seq, fill);
+            UNTIL_QUEUED(print_message_urgent(line));
+            vTaskDelay(5);      // Alerts are occasional
+            break;
+        }
+    }
+
+    __sync_fetch_and_add(&producers_done, 1);
+    // Host threads may simply end
+}
+
+/* ------------------------------------------------------------------------- */
+
+typedef struct {
+    unsigned long lines;
+    unsigned long menu_lines;
+    unsigned long missing;      /* Sequence numbers skipped */
+    unsigned long bad;          /* Torn, reordered or unknown lines */
+} wire_check_t;
+
+/* Check the wire from offset on (producers done); expected[] ends at next_seq[] */
+static void check_wire(size_t offset, unsigned long *expected, wire_check_t *result)
+{
+    const uint8_t *wire;
+    size_t length = host_uart_wire(&wire);
+    char fill[SIM_FILL_MAX];
+
+    memset(result, 0, sizeof(*result));
+    while (offset < length) {
+        const char *line = (const char *)&wire[offset];
+        const uint8_t *end = memchr(&wire[offset], '\n', length - offset);
+        size_t line_length = (end != NULL) ? (size_t)(end - &wire[offset]) + 1 : length - offset;
+        unsigned id;
+        unsigned long seq;
+        int text = 0;
+
+        offset += line_length;
+        if (line[0] == 'M') {
+            result->menu_lines++;
+            continue;
+        }
+        if (sscanf(line, "P%u %5lu%n", &id, &seq, &text) != 2 || id >= SIM_PRODUCERS ||
+            seq < expected[id] || line[text++] != ' ') {
+            result->bad++;
+            continue;
+        }
+
+        size_t fill_length = filler(id, seq, fill);
+        if (id == 0) {
+            strcpy(fill, "-");
+            fill_length = 1;
+        }
+        if (line_length != (size_t)text + fill_length + 2 ||
+            memcmp(&line[text], fill, fill_length) != 0) {
+            result->bad++;
+            continue;
+        }
+
+        result->missing += seq - expected[id];
+        expected[id] = seq + 1;
+        result->lines++;
+    }
+
+    // A dropped burst may have held a producer's last lines
+    for (unsigned id = 0; id < SIM_PRODUCERS; id++) {
+        result->missing += next_seq[id] - expected[id];
+        expected[id] = next_seq[id];
+    }
+}
+
+typedef struct {
+    const char *name;
+    uint32_t refuse_every;      /* Refuse starts every N bursts (0 = never) */
+    uint32_t refuse_count;      /* ... this many times in a row */
+    uint32_t refuse_bursts;     /* How many times to do it */
+    uint32_t lose_tc;           /* TC interrupts to swallow */
+} phase_t;
+
+static unsigned long wire_expected[SIM_PRODUCERS];
+
+static void run_phase(const phase_t *phase, print_stats_t *delta, wire_check_t *result)
+{
+    print_stats_t before, after;
+    host_uart_stats_t hal_before, hal_after;
+    const uint8_t *wire;
+    size_t start = host_uart_wire(&wire);
+    TickType_t t0 = xTaskGetTickCount();
+    uint32_t injected = 0;
+
+    print_get_stats(&before);
+    host_uart_get_stats(&hal_before);
+    producers_done = 0;
+    for (unsigned id = 0; id < SIM_PRODUCERS; id++) {
+        xTaskCreate(producer_task, "Producer", 256, (void *)(uintptr_t)id, 2, NULL);
+    }
+    host_uart_lose_tc(phase->lose_tc);
+
+    // Inject refusals while the producers run, spread over the phase
+    while (producers_done < SIM_PRODUCERS) {
+        vTaskDelay(pdMS_TO_TICKS(5));
+        if (phase->refuse_every != 0 && injected < phase->refuse_bursts) {
+            print_stats_t now;
+            print_get_stats(&now);
+            if (now.bursts - before.bursts >= (injected + 1) * phase->refuse_every) {
+                host_uart_refuse(phase->refuse_count);
+                injected++;
+            }
+        }
+    }
+    CHECK(print_flush(pdMS_TO_TICKS(SIM_FLUSH_MS)) == pdPASS);
+    host_uart_refuse(0);    // Nothing left over for the next phase
+
+    TickType_t elapsed = xTaskGetTickCount() - t0;
+    print_get_stats(&after);
+    delta->bursts = after.bursts - before.bursts;
+    delta->burst_messages = after.burst_messages - before.burst_messages;
+    delta->burst_bytes = after.burst_bytes - before.burst_bytes;
+    delta->tx_refused = after.tx_refused - before.tx_refused;
+    delta->tx_lost = after.tx_lost - before.tx_lost;
+    delta->tx_timeouts = after.tx_timeouts - before.tx_timeouts;
+
+    // Every start the HAL refused must have been counted
+    host_uart_get_stats(&hal_after);
+    CHECK(delta->tx_refused == hal_after.dma_refused - hal_before.dma_refused);
+
+    check_wire(start, wire_expected, result);
+    size_t sent = host_uart_wire(&wire) - start;
+
+    printf("%s\n", phase->name);
+    printf("  lines %lu (+%lu menu), missing %lu, bad %lu\n", result->lines,
+           result->menu_lines, result->missing, result->bad);
+    printf("  bursts %u, %.1f messages / %.0f bytes each\n", (unsigned)delta->bursts,
+           delta->bursts ? (double)delta->burst_messages / delta->bursts : 0.0,
+           delta->bursts ? (double)delta->burst_bytes / delta->bursts : 0.0);
+    printf("  refused %u, lost %u, timeouts %u\n", (unsigned)delta->tx_refused,
+           (unsigned)delta->tx_lost, (unsigned)delta->tx_timeouts);
+    printf("  wire busy %.0f%% of %u ms\n\n",
+           100.0 * sent * SIM_CHAR_TIME_US / (1000.0 * pdTICKS_TO_MS(elapsed ? elapsed : 1)),
+           (unsigned)pdTICKS_TO_MS(elapsed));
+
+    CHECK(result->bad == 0);
+    CHECK(result->menu_lines % MENU_LINES == 0);
+}
+
+int main(int argc, char **argv)
+{
+    static const phase_t refused = { "1. Refused starts (within the retry budget)",
+                                     3, PRINT_TX_START_RETRIES, 4, 0 };
+    static const phase_t stuck = { "2. Stuck UART (one start refused past the budget)",
+                                   2, PRINT_TX_START_RETRIES + 1, 1, 0 };
+    static const phase_t lost_tc = { "3. Lost TC interrupt", 0, 0, 0, 1 };
+    print_stats_t delta;
+    wire_check_t result;
+
+    lines_per_producer = (argc > 1) ? (unsigned)atoi(argv[1]) : 60;
+    if (lines_per_producer < SIM_MIN_LINES) {
+        fprintf(stderr, "Need at least %d lines per producer\n", SIM_MIN_LINES);
+        return 1;
+    }
+
+    host_uart_init(SIM_CHAR_TIME_US, SIM_WIRE_CAPACITY);
+    print_task_init();
+    vTaskStartScheduler();
+
+    run_phase(&refused, &delta, &result);
+    CHECK(result.missing == 0);
+    CHECK(result.lines == SIM_PRODUCERS * lines_per_producer);
+    CHECK(delta.tx_refused > 0);
+    CHECK(delta.tx_lost == 0);
+
+    run_phase(&stuck, &delta, &result);
+    CHECK(delta.tx_refused == stuck.refuse_count);
+    CHECK(delta.tx_lost == 1);
+    CHECK(result.missing > 0);
+    CHECK(result.lines + result.missing == SIM_PRODUCERS * lines_per_producer);
+
+    run_phase(&lost_tc, &delta, &result);
+    CHECK(result.missing == 0);
+    CHECK(result.lines == SIM_PRODUCERS * lines_per_producer);
+    CHECK(delta.tx_timeouts == 1);
+    CHECK(delta.tx_lost == 0);
+
+    printf("TX path checks: %s\n", failures ? "FAILED" : "ok");
+    return failures != 0;
+}
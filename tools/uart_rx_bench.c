@@ -0,0 +1,284 @@
+/**
+ ******************************************************************************
+ * @file           : uart_rx_bench.c
+ * @brief          : Host benchmark of RX throughput: per-byte IT vs circular DMA
+ ******************************************************************************
+ * @description
+ * Pastes a block of commands at 115200, 460800 and 921600 baud into a
+ * cycle-level model of the 168 MHz core and compares the two receive
+ * paths:
+ *
+ *   per-byte IT   (old) HAL_UART_Receive_IT() re-armed for every byte: one
+ *                 RXNE interrupt, one xStreamBufferSendFromISR() and one
+ *                 task wake-up per character. The byte must be read from
+ *                 DR before the next one has arrived, or it is overrun.
+ *   circular DMA  (firmware) the DMA stores bytes on its own; one
+ *                 interrupt per half buffer, full buffer or idle line
+ *                 pushes the whole chunk. Input is lost only if the DMA
+ *                 laps the unread part of its 128-byte ring.
+ *
+ * Interrupts run ahead of the UART task (which reads the stream buffer in
+ * blocks, as uart_task_handler() does) and are held off while interrupts
+ * are masked: once per 1 ms tick for mask_us (critical sections, the tick
+ * itself). Buffer sizes mirror uart_task.h. The task side is the block
+ * read of UART_LINE_DISCIPLINE=0 (a wake-up per chunk); with the line
+ * discipline the task wakes once per command, fewer still.
+ *
+ * The cycle costs below are estimates for this code on a Cortex-M4, not
+ * measurements. With UART_RX_TIMING the firmware measures the wake-up
+ * cost (wake_cycles, "rxstats"); pass it as wake_cycles to use it here.
+ *
+ * Reported per baud rate and path: interrupts and task wake-ups per KB,
+ * CPU time spent receiving, bytes lost and the throughput the task sees.
+ * Exit status is non-zero if the circular DMA path loses input at any of
+ * the three rates.
+ *
+ * Build and run (from the repository root):
+ *   cc -O2 -Iincludes tools/uart_rx_bench.c -o uart_rx_bench
+ *   ./uart_rx_bench [paste_kilobytes] [mask_us] [wake_cycles]
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Target (main.c: HSI / 8 * 168 / 2) */
+#define BENCH_CPU_HZ            168000000UL
+#define BENCH_TICK_CYCLES       (BENCH_CPU_HZ / 1000)   /* configTICK_RATE_HZ */
+
+/* Mirrors of the firmware configuration (uart_task.h) */
+#define BENCH_DMA_SIZE          128     /* UART_RX_DMA_BUFFER_SIZE */
+#define BENCH_STREAM_SIZE       512     /* UART_STREAM_BUFFER_SIZE */
+#define BENCH_BLOCK_SIZE        64      /* UART_RX_BLOCK_SIZE */
+
+/* Estimated costs (CPU cycles) */
+#define BENCH_IT_ISR_CYCLES     600     /* IRQ handler, RxCplt, 1-byte stream send, re-arm */
+#define BENCH_IT_READ_CYCLES    80      /* Interrupt entry until DR is read */
+#define BENCH_DMA_ISR_CYCLES    700     /* IRQ handler, RxEvent, stream send, flow check */
+#define BENCH_DMA_BYTE_CYCLES   10      /* Line discipline per byte in the interrupt */
+#define BENCH_WAKE_CYCLES       1000    /* Two context switches + xStreamBufferReceive() */
+#define BENCH_READ_CYCLES       150     /* Each further non-blocking block read */
+#define BENCH_TASK_BYTE_CYCLES  15      /* Line editing per byte (line_scan + copy) */
+
+#define BENCH_QUANTUM           4       /* Cycles per simulation step */
+#define BENCH_BITS_PER_CHAR     10      /* 8N1 */
+
+typedef enum {
+    BENCH_PATH_IT = 0,
+    BENCH_PATH_DMA
+} bench_path_t;
+
+typedef struct {
+    /* Configuration */
+    bench_path_t path;
+    uint32_t char_cycles;
+    uint32_t mask_cycles;
+    uint32_t wake_cycles;
+
+    /* Sender */
+    size_t total, arrived;
+    uint64_t next_byte_at;
+
+    /* USART / DMA */
+    int rdr_full;               /* IT: byte in DR not read yet */
+    uint64_t rdr_read_at;       /* IT: when the running ISR reads DR */
+    int irq_pending;
+    size_t dma_head, dma_tail;  /* DMA: bytes stored / taken (running counts) */
+    uint64_t idle_at;           /* DMA: idle-line interrupt due (0 = none) */
+
+    /* Interrupt in progress */
+    uint32_t isr_left;
+    size_t isr_bytes;
+
+    /* Stream buffer and UART task */
+    size_t stream_fill;
+    int task_blocked;
+    uint32_t task_left;
+
+    /* Results */
+    unsigned long interrupts;
+    unsigned long wakeups;
+    unsigned long lost;
+    unsigned long delivered;
+    uint64_t busy;
+    uint64_t now;
+} bench_t;
+
+static void bench_byte_arrives(bench_t *b)
+{
+    if (b->path == BENCH_PATH_IT) {
+        if (b->rdr_full) {
+            b->lost++;              // Overrun: DR still holds the previous byte
+        } else {
+            b->rdr_full = 1;
+            b->irq_pending = 1;
+        }
+    } else {
+        if (b->dma_head - b->dma_tail == BENCH_DMA_SIZE) {
+            b->lost++;              // DMA lapped bytes nobody has taken
+            b->dma_tail++;
+        }
+        b->dma_head++;
+        if (b->dma_head % (BENCH_DMA_SIZE / 2) == 0) {
+            b->irq_pending = 1;     // Half / full transfer
+        }
+        b->idle_at = b->now + b->char_cycles;
+    }
+    b->arrived++;
+    b->next_byte_at += b->char_cycles;
+}
+
+static void bench_isr_start(bench_t *b)
+{
+    b->interrupts++;
+    b->irq_pending = 0;
+    if (b->path == BENCH_PATH_IT) {
+        b->isr_bytes = 1;
+        b->rdr_read_at = b->now + BENCH_IT_READ_CYCLES;
+        b->isr_left = BENCH_IT_ISR_CYCLES;
+    } else {
+        b->isr_bytes = b->dma_head - b->dma_tail;
+        b->dma_tail = b->dma_head;
+        b->isr_left = BENCH_DMA_ISR_CYCLES + (uint32_t)b->isr_bytes * BENCH_DMA_BYTE_CYCLES;
+    }
+}
+
+static void bench_isr_end(bench_t *b)
+{
+    size_t space = BENCH_STREAM_SIZE - b->stream_fill;
+
+    if (b->isr_bytes > space) {
+        b->lost += b->isr_bytes - space;    // Stream buffer full
+        b->isr_bytes = space;
+    }
+    b->stream_fill += b->isr_bytes;
+    if (b->task_blocked && b->stream_fill > 0) {
+        b->task_blocked = 0;
+        b->task_left = b->wake_cycles;
+        b->wakeups++;
+    }
+    b->isr_bytes = 0;
+}
+
+/* The task takes a block when it finishes the previous one */
+static void bench_task_step(bench_t *b)
+{
+    if (b->task_left > BENCH_QUANTUM) {
+        b->task_left -= BENCH_QUANTUM;
+        return;
+    }
+    b->task_left = 0;
+    if (b->stream_fill == 0) {
+        b->task_blocked = 1;
+        return;
+    }
+
+    size_t n = (b->stream_fill < BENCH_BLOCK_SIZE) ? b->stream_fill : BENCH_BLOCK_SIZE;
+    b->stream_fill -= n;
+    b->delivered += n;
+    b->task_left = BENCH_READ_CYCLES + (uint32_t)n * BENCH_TASK_BYTE_CYCLES;
+}
+
+static int bench_done(const bench_t *b)
+{
+    return b->arrived == b->total && !b->irq_pending && b->isr_left == 0 &&
+           b->dma_head == b->dma_tail && b->stream_fill == 0 && b->task_left == 0 &&
+           b->task_blocked;
+}
+
+static void bench_run(bench_t *b)
+{
+    b->task_blocked = 1;
+    b->next_byte_at = b->char_cycles;
+
+    while (!bench_done(b)) {
+        b->now += BENCH_QUANTUM;
+
+        if (b->rdr_full && b->rdr_read_at != 0 && b->now >= b->rdr_read_at) {
+            b->rdr_full = 0;
+            b->rdr_read_at = 0;
+        }
+        if (b->arrived < b->total && b->now >= b->next_byte_at) {
+            bench_byte_arrives(b);
+        }
+        if (b->idle_at != 0 && b->now >= b->idle_at) {
+            b->idle_at = 0;
+            if (b->dma_head != b->dma_tail) {
+                b->irq_pending = 1;     // Idle line
+            }
+        }
+
+        int masked = b->mask_cycles != 0 && (b->now % BENCH_TICK_CYCLES) < b->mask_cycles;
+
+        if (b->isr_left > 0) {
+            b->busy += BENCH_QUANTUM;
+            if (b->isr_left > BENCH_QUANTUM) {
+                b->isr_left -= BENCH_QUANTUM;
+            } else {
+                b->isr_left = 0;
+                bench_isr_end(b);
+            }
+        } else if (b->irq_pending && !masked) {
+            b->busy += BENCH_QUANTUM;
+            bench_isr_start(b);
+        } else if (!b->task_blocked) {
+            b->busy += BENCH_QUANTUM;
+            bench_task_step(b);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static const unsigned long bauds[] = { 115200, 460800, 921600 };
+    static const char *const names[] = { "per-byte IT (old)", "circular DMA" };
+    size_t kilobytes = (argc > 1) ? (size_t)atoi(argv[1]) : 16;
+    double mask_us = (argc > 2) ? atof(argv[2]) : 10.0;
+    uint32_t wake_cycles = (argc > 3) ? (uint32_t)atol(argv[3]) : BENCH_WAKE_CYCLES;
+    int failures = 0;
+
+    if (kilobytes == 0 || mask_us < 0.0 || mask_us >= 1000.0) {
+        fprintf(stderr, "usage: %s [paste_kilobytes] [mask_us < 1000] [wake_cycles]\n", argv[0]);
+        return 1;
+    }
+
+    printf("RX throughput: %zu KB paste, %lu MHz core, interrupts masked %.1f us per 1 ms tick,\n"
+           "task wake-up %lu cycles\n\n", kilobytes, BENCH_CPU_HZ / 1000000UL, mask_us,
+           (unsigned long)wake_cycles);
+    printf("%-8s %-18s %8s %8s %6s %7s %11s\n", "baud", "path", "irq/KB", "wake/KB",
+           "CPU %", "lost", "task KB/s");
+
+    for (size_t i = 0; i < sizeof(bauds) / sizeof(bauds[0]); i++) {
+        for (int path = BENCH_PATH_IT; path <= BENCH_PATH_DMA; path++) {
+            bench_t b;
+
+            memset(&b, 0, sizeof(b));
+            b.path = (bench_path_t)path;
+            b.char_cycles = (uint32_t)(BENCH_CPU_HZ * BENCH_BITS_PER_CHAR / bauds[i]);
+            b.mask_cycles = (uint32_t)(mask_us * (BENCH_CPU_HZ / 1000000UL));
+            b.wake_cycles = wake_cycles;
+            b.total = kilobytes * 1024;
+            bench_run(&b);
+
+            double seconds = (double)b.now / BENCH_CPU_HZ;
+            char baud[12] = "";
+            if (path == BENCH_PATH_IT) {
+                snprintf(baud, sizeof(baud), "%lu", bauds[i]);
+            }
+            printf("%-8s %-18s %8.1f %8.1f %6.1f %7lu %11.1f\n",
+                   baud, names[path],
+                   b.interrupts / (double)kilobytes, b.wakeups / (double)kilobytes,
+                   100.0 * (double)b.busy / (double)b.now, b.lost,
+                   b.delivered / 1024.0 / seconds);
+
+            if (path == BENCH_PATH_DMA && b.lost != 0) {
+                failures++;
+            }
+        }
+    }
+
+    printf("\nCircular DMA: %s\n", failures ? "LOSES INPUT" : "lossless at all rates");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,630 @@
+/**
+ ******************************************************************************
+ * @file           : uart_rx_sim.c
+ * @brief          : Host simulation of the UART receive path
+ ******************************************************************************
+ * @description
+ * Replays a multi-kilobyte command paste through a character-time model of
+ * the receive path:
+ *
+ *   sender ─> circular DMA ─> RX event ISR ─> stream buffer ─> UART task
+ *   (honours     (128 B, HT/TC/idle)  (line          (512 B)      │
+ *    RTS/XOFF                          discipline)                 v
+ *    after N bytes)                                   command queue (5
+ *                                                     pool indices)
+ *                                                          │
+ *                                                     command handler
+ *                                                     (fixed cost/command)
+ *
+ * Buffer sizes, watermarks and timeouts mirror uart_task.h. The throttle
+ * decision (uart_flow.h), the command pool bookkeeping (cmd_pool.c) and
+ * the error accounting and re-arm decision (uart_rx_recovery.c) are the
+ * firmware's own code, linked in; the sim supplies the hardware and the
+ * kernel around them. One tick is one
+ * character time on the wire. The handler is deliberately far slower than
+ * the link (a menu redraw per command), which is the case that used to
+ * overflow the stream buffer.
+ *
+ * Flow control: each mode reports commands executed, input lost and
+ * throttle events. RTS/CTS and XON/XOFF must lose nothing and keep the
+ * command order.
+ *
+ * Fault injection: receive errors hit the paste every SIM_FAULT_INTERVAL
+ * bytes (alternating framing errors, which store a garbage byte, and
+ * overruns, which lose one). As on target, each error aborts the RX DMA
+ * and calls the error callback, which salvages the bytes stored so far
+ * and re-arms. Only the lines an error touched may be lost, and input
+ * must keep flowing to the end of the paste - also when the re-arm in the
+ * callback is refused and the task's liveness check has to restart
+ * reception. The old behaviour (no re-arm) is shown for comparison.
+ *
+ * Command pool: lines are assembled in COMMAND_POOL_SIZE buffers and the
+ * queue carries their indices, as on target. The handler holds its buffer
+ * while it works and returns it when done. Every mode checks at the end
+ * that all buffers came back, that cmd_pool_submit() and
+ * cmd_pool_release() never reported a fault (the firmware's configASSERTs)
+ * and that no more than the pool was ever in use - including the lossy
+ * modes, where commands are dropped on a full queue.
+ *
+ * Exit status is non-zero if a firmware configuration fails its check.
+ *
+ * Build and run (from the repository root):
+ *   cc -O2 -Iincludes tools/uart_rx_sim.c src/cmd_pool.c \
+ *      src/uart_rx_recovery.c -o uart_rx_sim
+ *   ./uart_rx_sim [paste_kilobytes] [handler_ticks_per_command]
+ ******************************************************************************
+ */
+
+#include "uart_flow.h"
+#include "cmd_pool.h"
+#include "uart_rx_recovery.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Mirrors of the firmware configuration (uart_task.h) */
+#define SIM_LINE_SIZE        128     /* UART_RX_BUFFER_SIZE */
+#define SIM_STREAM_SIZE      512     /* UART_STREAM_BUFFER_SIZE */
+#define SIM_DMA_SIZE         128     /* UART_RX_DMA_BUFFER_SIZE */
+#define SIM_BLOCK_SIZE       64      /* UART_RX_BLOCK_SIZE */
+#define SIM_REACTION_BYTES   16      /* UART_FLOW_REACTION_BYTES */
+#define SIM_COMMAND_SIZE     64      /* COMMAND_MAX_LENGTH */
+#define SIM_QUEUE_DEPTH      5
+#define SIM_POOL_SIZE        (SIM_QUEUE_DEPTH + 2)   /* COMMAND_POOL_SIZE */
+#define SIM_QUEUE_TIMEOUT    1152    /* 100 ms at 115200 baud, in char times */
+#define SIM_TASK_TIMEOUT     23040   /* 2 s stream buffer receive timeout */
+
+#define SIM_HIGH_WATERMARK \
+    (SIM_STREAM_SIZE - SIM_LINE_SIZE - SIM_DMA_SIZE / 2 - SIM_REACTION_BYTES)
+#define SIM_LOW_WATERMARK    (SIM_HIGH_WATERMARK / 3)
+
+/* Bytes between injected receive errors */
+#define SIM_FAULT_INTERVAL   1500
+
+/* What happens to reception after a receive error */
+typedef enum {
+    SIM_REARM_NONE = 0,     /* Old behaviour: reception stays stopped */
+    SIM_REARM_CALLBACK,     /* Error callback re-arms */
+    SIM_REARM_REFUSED       /* Callback re-arm refused; liveness check restarts */
+} sim_rearm_t;
+
+typedef struct {
+    const char *name;
+    int flow_control;       /* 0 = none */
+    int reaction_bytes;     /* Bytes the sender still sends after STOP */
+    int faults;             /* Inject receive errors */
+    sim_rearm_t rearm;
+    int firmware;           /* Current firmware behaviour: must pass */
+} sim_mode_t;
+
+typedef struct {
+    /* Sender */
+    const uint8_t *input;
+    size_t input_size;
+    size_t sent;
+    int stop_countdown;     /* -1 = running, >0 = stopping, 0 = stopped */
+    int sent_last_tick;
+    unsigned long line;     /* Input line of the next byte */
+
+    /* Circular DMA */
+    uint8_t dma[SIM_DMA_SIZE];
+    size_t dma_head, dma_tail, dma_pending;
+    int rx_armed;
+
+    /* ISR line discipline */
+    uint8_t isr_line[SIM_LINE_SIZE];
+    size_t isr_line_len;
+
+    /* Stream buffer */
+    uint8_t stream[SIM_STREAM_SIZE];
+    size_t stream_head, stream_fill;
+
+    /* UART task */
+    uint8_t block[SIM_BLOCK_SIZE];
+    size_t block_len, block_pos;
+    size_t rx_index;
+    int queue_blocked;
+    unsigned long queue_wait;
+    unsigned long idle_ticks;
+    int check_pending;      /* Woken early for a liveness check */
+
+    /* Command pool, queue of indices and handler */
+    char pool[SIM_POOL_SIZE][SIM_COMMAND_SIZE];
+    cmd_pool_t pool_state;
+    unsigned long pool_errors;      /* Out of order or overcommitted */
+    uint8_t queue[SIM_QUEUE_DEPTH];
+    size_t queue_head, queue_count;
+    uint8_t handler_index;          /* Buffer held while busy */
+    unsigned long handler_busy;
+    char last_command[SIM_COMMAND_SIZE];
+
+    /* Configuration */
+    uart_flow_t flow;
+    int flow_control;
+    int reaction_bytes;
+    int faults;
+    sim_rearm_t rearm;
+    uart_rx_recovery_t recovery;
+    size_t next_fault;      /* Byte offset of the next injected error */
+
+    /* Results */
+    unsigned long executed;
+    unsigned long valid;            /* Executed commands that are script lines */
+    unsigned long hash;
+    unsigned long lost_bytes;
+    unsigned long lost_commands;
+    unsigned long queue_stalls;
+    unsigned long damaged_lines;    /* Input lines hit by an error */
+    unsigned long last_damaged;     /* Line number + 1 */
+    unsigned long errors;
+    unsigned long ticks;
+} sim_t;
+
+/* Script commands (all shorter than COMMAND_MAX_LENGTH) */
+static const char *const script[] = {
+    "1\r\n", "2\r\n", "3\r\n", "4\r\n", "0\r\n",
+    "led green on\r\n", "pattern 2\r\n", "rxstats\r\n",
+};
+
+#define SCRIPT_COUNT (sizeof(script) / sizeof(script[0]))
+
+static unsigned long hash_command(unsigned long hash, const char *command)
+{
+    while (*command != '\0') {
+        hash = (hash ^ (uint8_t)*command++) * 16777619ul;
+    }
+    return (hash ^ '\r') * 16777619ul;
+}
+
+static int is_script_command(const char *command)
+{
+    size_t len = strlen(command);
+
+    for (size_t i = 0; i < SCRIPT_COUNT; i++) {
+        if (strlen(script[i]) == len + 2 && memcmp(script[i], command, len) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void sim_apply_flow(sim_t *sim, uart_flow_action_t action)
+{
+    if (action == UART_FLOW_STOP && sim->stop_countdown < 0) {
+        sim->stop_countdown = sim->reaction_bytes;
+    } else if (action == UART_FLOW_START) {
+        sim->stop_countdown = -1;
+    }
+}
+
+static void sim_throttle(sim_t *sim)
+{
+    if (sim->flow_control) {
+        sim_apply_flow(sim, uart_flow_update(&sim->flow, sim->stream_fill));
+    }
+}
+
+/* uart_rx_line_discipline() for one byte */
+static void sim_isr_byte(sim_t *sim, uint8_t c)
+{
+    if (c == '\r' || c == '\n') {
+        if (sim->isr_line_len == 0) {
+            return;
+        }
+        sim->isr_line[sim->isr_line_len++] = '\r';
+        if (SIM_STREAM_SIZE - sim->stream_fill >= sim->isr_line_len) {
+            for (size_t i = 0; i < sim->isr_line_len; i++) {
+                sim->stream[(sim->stream_head + sim->stream_fill++) % SIM_STREAM_SIZE] = sim->isr_line[i];
+            }
+        } else {
+            sim->lost_bytes += sim->isr_line_len;
+            sim->lost_commands++;
+        }
+        sim->isr_line_len = 0;
+    } else if (sim->isr_line_len < SIM_LINE_SIZE - 1) {
+        sim->isr_line[sim->isr_line_len++] = c;
+    } else {
+        sim->lost_bytes += sim->isr_line_len + 1;
+        sim->lost_commands++;
+        sim->isr_line_len = 0;
+    }
+}
+
+/* uart_rx_consume(): HAL_UARTEx_RxEventCallback() and error salvage */
+static void sim_rx_event(sim_t *sim)
+{
+    while (sim->dma_pending > 0) {
+        sim_isr_byte(sim, sim->dma[sim->dma_tail]);
+        sim->dma_tail = (sim->dma_tail + 1) % SIM_DMA_SIZE;
+        sim->dma_pending--;
+    }
+    sim_throttle(sim);
+}
+
+/* uart_rx_start(): the HAL refuses the re-arm from the error callback in
+ * SIM_REARM_REFUSED mode */
+static int sim_rx_start(sim_t *sim, int from_callback)
+{
+    int started = !(from_callback && sim->rearm == SIM_REARM_REFUSED);
+
+    if (started) {
+        sim->dma_head = sim->dma_tail = sim->dma_pending = 0;
+        sim->rx_armed = 1;
+    }
+    return uart_rx_recovery_rearmed(&sim->recovery, started) == UART_RX_KEEP;
+}
+
+/* HAL_UART_ErrorCallback(): HAL has already aborted the RX DMA */
+static void sim_rx_error(sim_t *sim, uint32_t error)
+{
+    sim->errors++;
+    sim->rx_armed = 0;
+
+    if (sim->rearm == SIM_REARM_NONE) {
+        sim_rx_event(sim);          // Old callback: salvage, nothing more
+        return;
+    }
+    if (uart_rx_recovery_error(&sim->recovery, error, !sim->rx_armed) != UART_RX_RESTART) {
+        return;
+    }
+    sim_rx_event(sim);              // Salvage what the DMA stored
+    if (!sim_rx_start(sim, 1)) {
+        sim->check_pending = 1;     // xStreamBufferSendCompletedFromISR()
+    }
+}
+
+static void sim_dma_store(sim_t *sim, uint8_t c)
+{
+    if (sim->dma_pending == SIM_DMA_SIZE) {
+        sim->lost_bytes++;          // DMA overwrote an unprocessed byte
+        sim->dma_tail = (sim->dma_tail + 1) % SIM_DMA_SIZE;
+        sim->dma_pending--;
+    }
+    sim->dma[sim->dma_head] = c;
+    sim->dma_head = (sim->dma_head + 1) % SIM_DMA_SIZE;
+    sim->dma_pending++;
+
+    // Half-transfer and transfer-complete interrupts
+    if (sim->dma_head == SIM_DMA_SIZE / 2 || sim->dma_head == 0) {
+        sim_rx_event(sim);
+    }
+}
+
+static void sim_damage(sim_t *sim)
+{
+    if (sim->last_damaged != sim->line + 1) {
+        sim->last_damaged = sim->line + 1;
+        sim->damaged_lines++;
+    }
+}
+
+/* Error due on this byte? Never on CR/LF, so damage stays within a line */
+static int sim_fault_due(sim_t *sim, uint8_t c)
+{
+    if (!sim->faults || c == '\r' || c == '\n' || sim->sent < sim->next_fault) {
+        return 0;
+    }
+    sim->next_fault = sim->sent + SIM_FAULT_INTERVAL;
+    return 1;
+}
+
+/* One character time on the wire */
+static void sim_wire(sim_t *sim)
+{
+    int sent = 0;
+
+    if (sim->sent < sim->input_size && sim->stop_countdown != 0) {
+        uint8_t c = sim->input[sim->sent++];
+
+        if (!sim->rx_armed) {
+            sim->lost_bytes++;      // Nobody is listening
+            sim_damage(sim);
+        } else if (sim_fault_due(sim, c)) {
+            sim_damage(sim);
+            if (sim->errors % 2 == 0) {
+                // Framing error: the garbage byte is stored
+                sim->dma[sim->dma_head] = 0xFF;
+                sim->dma_head = (sim->dma_head + 1) % SIM_DMA_SIZE;
+                sim->dma_pending++;
+                sim_rx_error(sim, UART_RX_ERROR_FE);
+            } else {
+                sim->lost_bytes++;  // Overrun: the byte is lost
+                sim_rx_error(sim, UART_RX_ERROR_ORE);
+            }
+        } else {
+            sim_dma_store(sim, c);
+        }
+
+        if (c == '\n') {
+            sim->line++;
+        }
+        if (sim->stop_countdown > 0) {
+            sim->stop_countdown--;
+        }
+        sent = 1;
+    } else if (sim->sent_last_tick && sim->dma_pending > 0 && sim->rx_armed) {
+        sim_rx_event(sim);          // Idle line
+    }
+
+    sim->sent_last_tick = sent;
+}
+
+/* uart_rx_check_alive() (the old firmware had none) */
+static int sim_check_alive(sim_t *sim)
+{
+    if (sim->rearm != SIM_REARM_NONE &&
+        uart_rx_recovery_check(&sim->recovery, sim->rx_armed) == UART_RX_RESTART) {
+        sim_rx_start(sim, 0);
+    }
+    return sim->rx_armed;
+}
+
+/* Buffer the UART task is filling (rx_buffer) */
+static char *sim_rx_buffer(sim_t *sim)
+{
+    return sim->pool[cmd_pool_fill_index(&sim->pool_state)];
+}
+
+/* uart_rx_submit(): queue the index, move on to the next buffer */
+static int sim_queue_send(sim_t *sim)
+{
+    if (sim->queue_count == SIM_QUEUE_DEPTH) {
+        return 0;
+    }
+    sim->queue[(sim->queue_head + sim->queue_count++) % SIM_QUEUE_DEPTH] =
+        cmd_pool_fill_index(&sim->pool_state);
+    if (!cmd_pool_submit(&sim->pool_state)) {
+        sim->pool_errors++;         // configASSERT: next buffer not free
+    }
+    return 1;
+}
+
+/* command_buffer_release() */
+static void sim_release(sim_t *sim, uint8_t index)
+{
+    if (!cmd_pool_release(&sim->pool_state, index)) {
+        sim->pool_errors++;         // configASSERT: not FIFO order
+    }
+}
+
+/* uart_task_handler(): runs instantly compared with a character time */
+static void sim_task(sim_t *sim)
+{
+    for (;;) {
+        if (sim->queue_blocked) {
+            if (sim_queue_send(sim)) {
+                sim_check_alive(sim);   // After waiting on the handler
+                sim->queue_blocked = 0;
+                sim->rx_index = 0;
+            } else if (++sim->queue_wait < SIM_QUEUE_TIMEOUT) {
+                return;
+            } else {
+                sim->queue_stalls++;
+                sim->queue_wait = 0;
+                sim_check_alive(sim);
+                if (!sim->flow_control) {
+                    sim->lost_commands++;     // "Error: Command queue full!"
+                    sim->queue_blocked = 0;
+                    sim->rx_index = 0;      // Buffer is reused
+                }
+                return;
+            }
+        }
+
+        if (sim->block_pos < sim->block_len) {
+            uint8_t c = sim->block[sim->block_pos++];
+            if (c == '\r') {
+                if (sim->rx_index > 0) {
+                    sim_rx_buffer(sim)[sim->rx_index] = '\0';
+                    sim->queue_blocked = 1;
+                    sim->queue_wait = 0;
+                }
+            } else if (sim->rx_index < SIM_COMMAND_SIZE - 1) {
+                sim_rx_buffer(sim)[sim->rx_index++] = (char)c;
+            }
+            continue;
+        }
+
+        if (sim->stream_fill == 0) {
+            // Blocked on the stream buffer until data, an early wake-up
+            // or the 2 s timeout - each runs one loop iteration
+            if (sim->check_pending || ++sim->idle_ticks >= SIM_TASK_TIMEOUT) {
+                sim->check_pending = 0;
+                sim->idle_ticks = 0;
+                sim_throttle(sim);
+                sim_check_alive(sim);
+            }
+            return;
+        }
+
+        size_t n = (sim->stream_fill < SIM_BLOCK_SIZE) ? sim->stream_fill : SIM_BLOCK_SIZE;
+        for (size_t i = 0; i < n; i++) {
+            sim->block[i] = sim->stream[(sim->stream_head + i) % SIM_STREAM_SIZE];
+        }
+        sim->stream_head = (sim->stream_head + n) % SIM_STREAM_SIZE;
+        sim->stream_fill -= n;
+        sim->block_len = n;
+        sim->block_pos = 0;
+        sim->idle_ticks = 0;
+
+        sim_throttle(sim);          // Task-side checks after every receive
+        sim_check_alive(sim);
+    }
+}
+
+/* command_handler_task(): fixed cost per command, buffer held meanwhile */
+static void sim_handler(sim_t *sim, unsigned long ticks_per_command)
+{
+    if (sim->handler_busy > 0) {
+        if (--sim->handler_busy == 0) {
+            sim_release(sim, sim->handler_index);
+        }
+        return;
+    }
+    if (sim->queue_count == 0) {
+        return;
+    }
+
+    sim->handler_index = sim->queue[sim->queue_head];
+    const char *command = sim->pool[sim->handler_index];
+    sim->hash = hash_command(sim->hash, command);
+    sim->executed++;
+    sim->valid += is_script_command(command);
+    memcpy(sim->last_command, command, SIM_COMMAND_SIZE);
+    sim->queue_head = (sim->queue_head + 1) % SIM_QUEUE_DEPTH;
+    sim->queue_count--;
+    sim->handler_busy = ticks_per_command;
+    if (sim->handler_busy == 0) {
+        sim_release(sim, sim->handler_index);
+    }
+}
+
+static size_t make_paste(uint8_t *buf, size_t size, unsigned long *commands,
+                         unsigned long *hash, char *last)
+{
+    size_t pos = 0;
+    unsigned seed = 12345;
+
+    *commands = 0;
+    *hash = 2166136261ul;
+    for (;;) {
+        seed = seed * 1103515245u + 12345u;
+        const char *cmd = script[(seed >> 16) % SCRIPT_COUNT];
+        size_t len = strlen(cmd);
+        if (pos + len > size) {
+            break;
+        }
+        memcpy(&buf[pos], cmd, len);
+        pos += len;
+
+        memcpy(last, cmd, len - 2);
+        last[len - 2] = '\0';
+        *hash = hash_command(*hash, last);
+        (*commands)++;
+    }
+    return pos;
+}
+
+typedef struct {
+    const uint8_t *input;
+    size_t size;
+    unsigned long commands;
+    unsigned long hash;
+    const char *last;
+    unsigned long ticks_per_command;
+} sim_paste_t;
+
+static int run(const sim_mode_t *mode, const sim_paste_t *paste)
+{
+    sim_t *sim = calloc(1, sizeof(*sim));
+    if (sim == NULL) {
+        return 1;
+    }
+
+    sim->input = paste->input;
+    sim->input_size = paste->size;
+    sim->stop_countdown = -1;
+    sim->flow_control = mode->flow_control;
+    sim->reaction_bytes = mode->reaction_bytes;
+    sim->faults = mode->faults;
+    sim->rearm = mode->rearm;
+    sim->flow.high_watermark = SIM_HIGH_WATERMARK;
+    sim->flow.low_watermark = SIM_LOW_WATERMARK;
+    sim->pool_state = (cmd_pool_t)CMD_POOL_INIT(SIM_POOL_SIZE);
+    sim->hash = 2166136261ul;
+    sim->next_fault = SIM_FAULT_INTERVAL;
+    sim_rx_start(sim, 0);
+
+    // Run until the paste is sent and everything has drained
+    while (sim->sent < paste->size || sim->dma_pending > 0 || sim->stream_fill > 0 ||
+           sim->block_pos < sim->block_len || sim->queue_blocked ||
+           sim->queue_count > 0 || sim->handler_busy > 0) {
+        sim_wire(sim);
+        sim_task(sim);
+        sim_handler(sim, paste->ticks_per_command);
+        sim->ticks++;
+    }
+
+    // Every buffer back, in order, never more than the pool in use
+    unsigned long leaked = cmd_pool_in_use(&sim->pool_state);
+    int pool_ok = (leaked == 0 && sim->pool_errors == 0 && sim->pool_state.peak <= SIM_POOL_SIZE);
+
+    int ok;
+    if (!mode->faults) {
+        ok = (sim->executed == paste->commands && sim->hash == paste->hash &&
+              sim->lost_bytes == 0);
+        printf("%-18s executed %5lu/%lu  lost %5lu cmds %6lu bytes  throttles %4lu  "
+               "stalls %5lu  %s\n",
+               mode->name, sim->executed, paste->commands, sim->lost_commands,
+               sim->lost_bytes, (unsigned long)sim->flow.throttle_events,
+               sim->queue_stalls, ok ? "lossless" : "LOSS");
+    } else {
+        // Only damaged lines may go missing, and the paste must get through
+        // to its last command
+        int flowing = sim->rx_armed && strcmp(sim->last_command, paste->last) == 0;
+        ok = flowing && sim->valid + sim->damaged_lines >= paste->commands;
+        printf("%-18s valid %5lu/%lu  errors %3lu  damaged lines %4lu  restarts %3lu  "
+               "liveness re-arms %3lu  %s\n",
+               mode->name, sim->valid, paste->commands, sim->errors, sim->damaged_lines,
+               (unsigned long)sim->recovery.restarts, (unsigned long)sim->recovery.stalls,
+               ok ? "flowing" : (sim->rx_armed ? "LOSS" : "RX STALLED"));
+    }
+
+    printf("%-18s pool peak %lu/%d  leaked %lu  order errors %lu  %s\n", "",
+           (unsigned long)sim->pool_state.peak, SIM_POOL_SIZE, leaked, sim->pool_errors,
+           pool_ok ? "ok" : "POOL LEAK");
+
+    free(sim);
+    return ((mode->firmware && !ok) || !pool_ok) ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    size_t kilobytes = (argc > 1) ? (size_t)atoi(argv[1]) : 16;
+    unsigned long ticks_per_command = (argc > 2) ? (unsigned long)atol(argv[2]) : 350;
+    size_t capacity = kilobytes * 1024;
+    uint8_t *input = malloc(capacity);
+    char last[SIM_COMMAND_SIZE];
+    sim_paste_t paste;
+
+    if (input == NULL || capacity == 0) {
+        fprintf(stderr, "cannot allocate %zu KB\n", kilobytes);
+        return 1;
+    }
+
+    paste.input = input;
+    paste.size = make_paste(input, capacity, &paste.commands, &paste.hash, last);
+    paste.last = last;
+    paste.ticks_per_command = ticks_per_command;
+
+    static const sim_mode_t flow_modes[] = {
+        { "none",              0, 0,                  0, SIM_REARM_CALLBACK, 0 },
+        { "rts/cts",           1, 2,                  0, SIM_REARM_CALLBACK, 1 },
+        { "xon/xoff",          1, SIM_REACTION_BYTES, 0, SIM_REARM_CALLBACK, 1 },
+    };
+    static const sim_mode_t fault_modes[] = {
+        { "no re-arm (old)",   1, 2,                  1, SIM_REARM_NONE,     0 },
+        { "callback re-arm",   1, 2,                  1, SIM_REARM_CALLBACK, 1 },
+        { "re-arm refused",    1, 2,                  1, SIM_REARM_REFUSED,  1 },
+    };
+
+    int failures = 0;
+
+    printf("RX simulation: %zu byte paste, %lu commands, %lu char times per command\n",
+           paste.size, paste.commands, ticks_per_command);
+
+    printf("\n[flow control] watermarks %d/%d of %d\n",
+           SIM_LOW_WATERMARK, SIM_HIGH_WATERMARK, SIM_STREAM_SIZE);
+    for (size_t m = 0; m < sizeof(flow_modes) / sizeof(flow_modes[0]); m++) {
+        failures += run(&flow_modes[m], &paste);
+    }
+
+    printf("\n[fault injection] one receive error every %d bytes, RTS/CTS\n",
+           SIM_FAULT_INTERVAL);
+    for (size_t m = 0; m < sizeof(fault_modes) / sizeof(fault_modes[0]); m++) {
+        failures += run(&fault_modes[m], &paste);
+    }
+
+    free(input);
+    return failures ? 1 : 0;
+}
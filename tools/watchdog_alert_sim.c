@@ -0,0 +1,335 @@
+/**
+ ******************************************************************************
+ * @file           : watchdog_alert_sim.c
+ * @brief          : Host test that watchdog alerts never interleave with menus
+ ******************************************************************************
+ * @description
+ * Runs the firmware's own watchdog.c, print_task.c and print_port.c on
+ * the host models in tools/host, with one tick = 100 us so that the
+ * watchdog's 1 s check period and the print task's 5 s timeout pass in a
+ * fraction of that (the wire is scaled by the same factor). A menu task
+ * floods print_const() menus the whole time.
+ *
+ * 1. Hung application task: a registered task stops feeding, so an alert
+ *    goes out on the urgent lane every check period, while menus fill the
+ *    bulk lane.
+ *
+ * 2. Hung print task: the print task is frozen and the DMA stalled in the
+ *    middle of a menu burst. The watchdog writes its alert with polled TX
+ *    (print_port_emergency_write()), and the stall is lifted as soon as
+ *    the first polled byte is out: a burst that was not aborted first
+ *    would now run on, its bytes mixed into the alert. Then the print task
+ *    is released and output carries on.
+ *
+ * The wire must read as a sequence of whole menus, whole alerts and whole
+ * [WATCHDOG] status lines. The only exception allowed is the one burst
+ * cut by the emergency alert in phase 2: the start of one menu directly
+ * in front of that alert, and its remainder never sent afterwards.
+ *
+ * Build and run (from the repository root):
+ *   cc -O2 -pthread -DHOST_TICK_US=100 -Itools/host -Iincludes \
+ *      tools/watchdog_alert_sim.c tools/host/freertos_host.c \
+ *      tools/host/uart_host.c src/watchdog.c src/print_task.c \
+ *      src/print_port.c -o watchdog_alert_sim
+ *   ./watchdog_alert_sim
+ ******************************************************************************
+ */
+
+#include "host_sim.h"
+#include "print_task.h"
+#include "print_log.h"
+#include "watchdog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if HOST_TICK_US != 100
+#error "Build with -DHOST_TICK_US=100 (see the header)"
+#endif
+
+#define SIM_CHAR_TIME_US    9           /* 115200 baud, scaled like the tick */
+#define SIM_WIRE_CAPACITY   (4u * 1024u * 1024u)
+#define SIM_HUNG_TIMEOUT_MS 300         /* Alerts every check period once hung */
+#define SIM_PHASE_MS        20000       /* Simulated time per phase */
+#define SIM_FLUSH_MS        10000
+
+static const char menu_text[] =
+    "\r\n==== LED Patterns ====\r\n"
+    "1. Pattern 1\r\n"
+    "2. Pattern 2\r\n"
+    "3. Pattern 3\r\n"
+    "0. Back\r\n"
+    "Enter selection: ";
+#define MENU_LENGTH (sizeof(menu_text) - 1)
+
+static volatile int menus_running = 1;
+static volatile int menus_done = 0;
+static unsigned long menus_sent = 0;
+
+static void menu_task(void *parameters)
+{
+    (void)parameters;
+
+    while (menus_running) {
+        // A full lane is back-pressure: retry the same menu
+        if (print_const(menu_text) != pdPASS) {
+            vTaskDelay(1);
+            continue;
+        }
+        menus_sent++;
+    }
+    menus_done = 1;
+}
+
+static volatile int hung = 1;
+
+/* Registers, then stops feeding while hung is set */
+static void hung_task(void *parameters)
+{
+    (void)parameters;
+    watchdog_id_t id = watchdog_register("Hung_Task", SIM_HUNG_TIMEOUT_MS);
+
+    for (;;) {
+        if (!hung) {
+            watchdog_feed(id);
+        }
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
+typedef struct {
+    unsigned long menus;
+    unsigned long alerts;
+    unsigned long print_task_alerts;
+    unsigned long status_lines;
+    unsigned long truncated;        /* Menus cut short right before an alert */
+    unsigned long bad;              /* Anything else: interleaved or torn */
+} wire_check_t;
+
+/* Length of a whole alert at text, 0 if there is none */
+static size_t match_alert(const char *text, char *task, size_t task_size)
+{
+    char name[16];
+    char expected[160];
+    unsigned id;
+    unsigned long elapsed, timeout;
+
+    if (sscanf(text, "\r\n*** WATCHDOG ALERT ***\r\nTask: %15s (ID=%u)\r\nLast feed: %lu "
+               "ms ago\r\nTimeout: %lu ms", name, &id, &elapsed, &timeout) != 4) {
+        return 0;
+    }
+
+    // Rebuild it from the table: every byte must match
+    int length = snprintf(expected, sizeof(expected), print_log_format(LOG_WATCHDOG_ALERT),
+                          name, id, elapsed, timeout);
+    if (length <= 0 || (size_t)length >= sizeof(expected) ||
+        strncmp(text, expected, (size_t)length) != 0) {
+        return 0;
+    }
+    snprintf(task, task_size, "%s", name);
+    return (size_t)length;
+}
+
+/* Length of a whole [WATCHDOG] status line at text, 0 if there is none */
+static size_t match_status(const char *text)
+{
+    static const print_log_id_t fixed[] = { LOG_WATCHDOG_INIT, LOG_WATCHDOG_STARTED };
+    char name[16];
+    char expected[96];
+    unsigned id;
+    unsigned long timeout;
+
+    for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+        const char *line = print_log_format(fixed[i]);
+        if (strncmp(text, line, strlen(line)) == 0) {
+            return strlen(line);
+        }
+    }
+
+    if (sscanf(text, "[WATCHDOG] Registered '%15[^']' (ID=%u, timeout=%lums)",
+               name, &id, &timeout) != 3) {
+        return 0;
+    }
+    int length = snprintf(expected, sizeof(expected), print_log_format(LOG_WATCHDOG_REGISTERED),
+                          name, id, timeout);
+    if (length <= 0 || (size_t)length >= sizeof(expected) ||
+        strncmp(text, expected, (size_t)length) != 0) {
+        return 0;
+    }
+    return (size_t)length;
+}
+
+static void check_wire(size_t from, wire_check_t *result)
+{
+    const uint8_t *wire;
+    size_t length = host_uart_wire(&wire) - from;
+    char *text = malloc(length + 1);
+    size_t offset = 0;
+
+    memset(result, 0, sizeof(*result));
+    if (text == NULL) {
+        result->bad++;
+        return;
+    }
+    memcpy(text, &wire[from], length);
+    text[length] = '\0';
+
+    while (offset < length) {
+        const char *at = &text[offset];
+        char task[16];
+        size_t matched;
+
+        if (strncmp(at, menu_text, MENU_LENGTH) == 0) {
+            result->menus++;
+            offset += MENU_LENGTH;
+            continue;
+        }
+        if ((matched = match_alert(at, task, sizeof(task))) != 0) {
+            result->alerts++;
+            if (strcmp(task, "Print_Task") == 0) {
+                result->print_task_alerts++;
+            }
+            offset += matched;
+            continue;
+        }
+        if ((matched = match_status(at)) != 0) {
+            result->status_lines++;
+            offset += matched;
+            continue;
+        }
+
+        // The start of a menu, cut where an alert begins. The alert opens
+        // with "\r\n", which may also be the menu's next two bytes, so back
+        // off from the longest common prefix until an alert follows
+        size_t prefix = 0;
+        while (offset + prefix < length && prefix < MENU_LENGTH &&
+               at[prefix] == menu_text[prefix]) {
+            prefix++;
+        }
+        while (prefix > 0 && match_alert(at + prefix, task, sizeof(task)) == 0) {
+            prefix--;
+        }
+        if (prefix > 0) {
+            result->truncated++;
+            offset += prefix;
+            continue;
+        }
+
+        // Resynchronise on the next line
+        const char *next = strstr(at + 1, "\r\n");
+        result->bad++;
+        offset = (next != NULL) ? (size_t)(next - text) : length;
+    }
+    free(text);
+}
+
+static void report(const char *name, const wire_check_t *result)
+{
+    printf("%s\n", name);
+    printf("  menus %lu whole, %lu cut by an alert\n", result->menus, result->truncated);
+    printf("  alerts %lu (%lu for the print task), status lines %lu\n", result->alerts,
+           result->print_task_alerts, result->status_lines);
+    printf("  bad %lu\n\n", result->bad);
+}
+
+/* Stop the menus and wait for everything queued to reach the wire */
+static void drain(void)
+{
+    menus_running = 0;
+    while (!menus_done) {
+        vTaskDelay(1);
+    }
+    CHECK(print_flush(pdMS_TO_TICKS(SIM_FLUSH_MS)) == pdPASS);
+}
+
+/* ------------------------------------------------------------------------- */
+
+int main(void)
+{
+    host_uart_stats_t hal_before, hal_after;
+    wire_check_t result;
+    const uint8_t *wire;
+    size_t start;
+
+    host_uart_init(SIM_CHAR_TIME_US, SIM_WIRE_CAPACITY);
+
+    // Same order as main(): nothing runs before the scheduler starts
+    print_task_init();
+    watchdog_init();
+    xTaskCreate(hung_task, "Hung", 256, NULL, 2, NULL);
+    xTaskCreate(menu_task, "Menu", 256, NULL, 2, NULL);
+    vTaskStartScheduler();
+
+    // Phase 1: urgent-lane alerts against a flood of menus
+    vTaskDelay(pdMS_TO_TICKS(SIM_PHASE_MS));
+    hung = 0;
+    vTaskDelay(pdMS_TO_TICKS(2 * WATCHDOG_CHECK_PERIOD_MS));    // Alerts in flight
+    drain();
+
+    check_wire(0, &result);
+    report("1. Hung application task, menus flooding", &result);
+    CHECK(result.bad == 0);
+    CHECK(result.truncated == 0);
+    CHECK(result.menus == menus_sent);
+    CHECK(result.alerts >= SIM_PHASE_MS / WATCHDOG_CHECK_PERIOD_MS - 2);
+    CHECK(result.print_task_alerts == 0);
+
+    // Phase 2: the print task hangs with a menu burst half on the wire
+    start = host_uart_wire(&wire);
+    menus_sent = 0;
+    menus_done = 0;
+    menus_running = 1;
+    xTaskCreate(menu_task, "Menu", 256, NULL, 2, NULL);
+    vTaskDelay(pdMS_TO_TICKS(500));
+    host_uart_get_stats(&hal_before);
+
+    // Stall a burst mid-menu first, then hang the print task waiting for it
+    host_uart_hold(pdTRUE);
+    do {
+        vTaskDelay(1);
+        host_uart_get_stats(&hal_after);
+    } while (hal_after.dma_started ==
+             hal_after.tc_interrupts + hal_after.tc_lost + hal_after.dma_aborted);
+    host_task_freeze(print_task_get_handle(), pdTRUE);
+
+    // The print task times out after 5 s, found at the next check. Let the
+    // stalled burst go the moment the polled alert starts: unless it was
+    // aborted, the two byte streams now mix on the wire
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(5000 + 3 * WATCHDOG_CHECK_PERIOD_MS);
+    do {
+        vTaskDelay(1);
+        host_uart_get_stats(&hal_after);
+    } while (hal_after.polled_bytes == hal_before.polled_bytes && xTaskGetTickCount() < deadline);
+    host_uart_hold(pdFALSE);
+
+    do {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        check_wire(start, &result);
+    } while (result.print_task_alerts == 0 && xTaskGetTickCount() < deadline);
+    host_uart_get_stats(&hal_after);
+
+    host_task_freeze(print_task_get_handle(), pdFALSE);
+    vTaskDelay(pdMS_TO_TICKS(500));
+    drain();
+
+    check_wire(start, &result);
+    report("2. Hung print task, burst stalled mid-menu", &result);
+    printf("  emergency alert aborted %u bursts, %u bytes never sent\n\n",
+           (unsigned)(hal_after.dma_aborted - hal_before.dma_aborted),
+           (unsigned)(hal_after.bytes_aborted - hal_before.bytes_aborted));
+
+    CHECK(result.bad == 0);
+    CHECK(result.print_task_alerts == 1);
+    CHECK(result.alerts == 1);          // Hung_Task is feeding again
+    CHECK(result.truncated <= 1);
+    CHECK(hal_after.dma_aborted - hal_before.dma_aborted == 1);
+    CHECK(hal_after.bytes_aborted > hal_before.bytes_aborted);
+    // Menus of the aborted burst are lost, no more
+    CHECK(result.menus + result.truncated <= menus_sent);
+    CHECK(menus_sent - result.menus <= PRINT_COALESCE_BUDGET / MENU_LENGTH + 1);
+
+    printf("Watchdog alert checks: %s\n", failures ? "FAILED" : "ok");
+    return failures != 0;
+}